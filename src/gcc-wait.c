@@ -27,6 +27,9 @@
  * 03 Jan 21         - Changed debug() macro so that debug code is executed
  *                     when DEBUG is defined (doesn't need to be true) - MT
  * 31 mar 22         - Modified to use usleep() on NetBSD - MT
+ * 17 Oct 26         - Added a millisecond clock - MT
+ *                   - Checks for '__linux__' as 'linux' is not defined  by
+ *                     strict ANSI compilers - MT
  *
  */
 
@@ -34,9 +37,14 @@
 #define BUILD          "0001"
 #define DATE           "16 Aug 20"
 
+#if defined(__linux__) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE /* Declares usleep() and clock_gettime() even in strict ANSI mode */
+#endif
+
 #include <stdio.h>
-#if defined(linux) || defined(__NetBSD__)
+#if defined(__linux__) || defined(__NetBSD__)
 #include <unistd.h>
+#include <time.h>
 #include <sys/types.h>
 #elif defined(WIN32)
 #include <windows.h>
@@ -60,7 +68,7 @@
  *
  */
 int i_wait(long l_delay) { /* wait for milliseconds */
-#if defined(linux) || defined(__NetBSD__) /* Use usleep() function */
+#if defined(__linux__) || defined(__NetBSD__) /* Use usleep() function */
 debug(fprintf(stderr, "Pausing using usleep() for  %ld ms.\n", l_delay));
 return (usleep(l_delay * 1000));
 #elif defined(WIN32) /* Use usleep() function */
@@ -83,3 +91,26 @@ while ((1000 * (o_end.time - o_start.time) + o_end.millitm - o_start.millitm) <
 return(0);
 #endif
 }
+
+/*
+ * time ()
+ *
+ * Returns  the  time in milliseconds (from an arbitrary starting point,  so
+ * only the difference between two values is meaningful)
+ *
+ * 17 Oct 26         - Initial version - MT
+ *
+ */
+long l_time() { /* Current time in milliseconds */
+#if defined(__linux__) || defined(__NetBSD__) /* Use the monotonic clock */
+struct timespec o_now;
+clock_gettime(CLOCK_MONOTONIC, &o_now);
+return (o_now.tv_sec * 1000L + o_now.tv_nsec / 1000000L);
+#elif defined(WIN32) /* Use GetTickCount() */
+return ((long) GetTickCount());
+#else /* Use ftime() */
+struct timeb o_now;
+ftime(&o_now);
+return ((o_now.time % 1000000L) * 1000L + o_now.millitm);
+#endif
+}
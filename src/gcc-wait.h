@@ -19,9 +19,12 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  * 
  * 16 Aug 20         - Initial version - MT
+ * 17 Oct 26         - Added l_time() - MT
  *
  */
  
 int i_wait(long l_delay);
 
+long l_time();
+
 
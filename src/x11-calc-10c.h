@@ -23,6 +23,12 @@
  * 02 Mar 22         - Modified memory size (still too big) - MT
  * 04 Mar 22         - Enabled continuous memory - MT
  * 09 Mar 22         - Fixed width and height (when scaled) - MT
+ * 17 Oct 26         - Defined the address ranges of the memory registers
+ *                     - MT
+ *                   - Maps every address until the ranges  have  been
+ *                     checked against the ROM - MT
+ *                   - Only maps the addresses of the memory registers
+ *                     fitted - MT
  *
  */
 
@@ -58,7 +64,8 @@
 #define DISPLAY_WIDTH      200 * SCALE_WIDTH
 #define DISPLAY_HEIGHT     48 * SCALE_HEIGHT
 
-#define MEMORY_SIZE        256
+#define MEMORY_SIZE        43
+#define MEMORY_MAP         {{0x00, 0x0a}, {0xe0, 0xff}} /* First and last address of each range of memory registers */
 #define ROM_SIZE           010000
 #define CONTINIOUS
 
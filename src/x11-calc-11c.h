@@ -20,6 +20,8 @@
  *
  * 30 Jan 22   0.1   - Initial version (derived from x11-calc-10.c) - MT
  * 09 Mar 22         - Fixed width and height (when scaled) - MT
+ * 17 Oct 26         - Defined the address ranges of the memory registers
+ *                     - MT
  *
  */
 
@@ -56,6 +58,7 @@
 #define DISPLAY_HEIGHT     48 * SCALE_HEIGHT
 
 #define MEMORY_SIZE        256
+#define MEMORY_MAP         {{0x00, 0xff}} /* First and last address of each range of memory registers */
 #define ROM_SIZE           014000
 #define CONTINIOUS
 
@@ -21,6 +21,12 @@
  * 30 Jan 22   0.1   - Initial version (derived from x11-calc-10.c) - MT
  * 02 Mar 22         - Fixed ROM size - MT
  * 09 Mar 22         - Fixed width and height (when scaled) - MT
+ * 17 Oct 26         - Defined the address ranges of the memory registers
+ *                     - MT
+ *                   - Maps every address until the ranges  have  been
+ *                     checked against the ROM - MT
+ *                   - Only maps the addresses of the memory registers
+ *                     fitted - MT
  *
  */
 
@@ -56,7 +62,8 @@
 #define KEY_NUMERIC        41 * SCALE_WIDTH
 #define KEY_GAP            3 * SCALE_WIDTH
 
-#define MEMORY_SIZE        256
+#define MEMORY_SIZE        91
+#define MEMORY_MAP         {{0x00, 0x1a}, {0xc0, 0xff}} /* First and last address of each range of memory registers */
 #define ROM_SIZE           034000
 #define CONTINIOUS
 
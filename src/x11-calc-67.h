@@ -30,6 +30,8 @@
  * 29 Jan 22         - Added an optional bezel to the display - MT
  * 12 Feb 22         - Updated layout and separated the initialisation code
  *                     for buttons and switches into two functions - MT
+ * 17 Oct 26         - Defined the memory registers recorded on each side
+ *                     of a program or data card - MT
  *
  */
 
@@ -76,6 +78,8 @@
 #define MEMORY_SIZE        64
 #define CONTINIOUS
 
+#define CARD_SIDES         {0x0f, 0x3f, 0x2f, 0x1f} /* First register recorded on each side of a data and program card */
+
 extern int i_rom [ROM_SIZE];
 
 void v_init_labels(olabel *h_label[]);
@@ -0,0 +1,192 @@
+/*
+ * x11-calc-arena.c - RPN (Reverse Polish) calculator simulator.
+ *
+ * Copyright(C) 2026   MT
+ *
+ * Arena allocation functions.
+ *
+ * Allocates  the objects that make up a calculator one after the other  in
+ * large  blocks  of memory so that objects that are used together are next
+ * to  each other, and they can all be released at once instead of one at a
+ * time.
+ *
+ * The  objects created after a mark can be released by rewinding the arena
+ * to that mark (used to rebuild the user interface).
+ *
+ * This  program is free software: you can redistribute it and/or modify it
+ * under  the terms of the GNU General Public License as published  by  the
+ * Free  Software Foundation, either version 3 of the License, or (at  your
+ * option) any later version.
+ *
+ * This  program  is distributed in the hope that it will  be  useful,  but
+ * WITHOUT   ANY   WARRANTY;   without even   the   implied   warranty   of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You  should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * 17 Oct 26         - Initial version - MT
+ *
+ */
+
+#define VERSION        "0.1"
+#define BUILD          "0001"
+#define DATE           "17 Oct 26"
+#define AUTHOR         "MT"
+
+#include <stdio.h>     /* fprintf(), etc. */
+#include <stdlib.h>    /* malloc(), etc. */
+
+#include <X11/Xlib.h>  /* XOpenDisplay(), etc. */
+
+#include "x11-calc-font.h"
+#include "x11-calc-label.h"
+#include "x11-calc-switch.h"
+#include "x11-calc-button.h"
+
+#include "x11-calc.h"
+
+#include "x11-calc-arena.h"
+
+#include "gcc-debug.h"
+
+#define ARENA_HEADER   ((sizeof(oblock) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1)) /* Space used by each block header */
+
+static oarena *h_current = NULL; /* Arena used by the create functions */
+
+static oblock *h_block_create(size_t i_size) /* Allocate a new block */
+{
+   oblock *h_block;
+
+   if ((h_block = malloc(ARENA_HEADER + i_size)) == NULL) v_error("Memory allocation failed in %s line : %d\n", __FILE__, __LINE__);
+   h_block->next = NULL;
+   h_block->size = i_size;
+   h_block->used = 0;
+   return(h_block);
+}
+
+/*
+ * arena_create (size)
+ *
+ * Creates an arena with an initial block of the given size.
+ *
+ */
+
+oarena *h_arena_create(size_t i_size)
+{
+   oarena *h_arena;
+
+   if ((h_arena = malloc(sizeof(*h_arena))) == NULL) v_error("Memory allocation failed in %s line : %d\n", __FILE__, __LINE__);
+   h_arena->first = h_arena->last = h_block_create(i_size);
+   return(h_arena);
+}
+
+/*
+ * arena_select (arena)
+ *
+ * Selects the arena used to allocate objects (if no arena is selected then
+ * each object is allocated separately).
+ *
+ */
+
+void v_arena_select(oarena *h_arena)
+{
+   h_current = h_arena;
+}
+
+/*
+ * arena_alloc (size)
+ *
+ * Allocates  memory from the current arena, adding a new block to the  end
+ * if there isn't enough room left in the last one.
+ *
+ */
+
+void *h_arena_alloc(size_t i_size)
+{
+   oblock *h_block;
+   void *h_memory;
+
+   if (h_current == NULL) /* No arena selected */
+   {
+      if ((h_memory = malloc(i_size)) == NULL) v_error("Memory allocation failed in %s line : %d\n", __FILE__, __LINE__);
+      return(h_memory);
+   }
+   i_size = (i_size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+   h_block = h_current->last;
+   if (h_block->size - h_block->used < i_size)
+   {
+      h_block->next = h_block_create(i_size > ARENA_SIZE ? i_size : ARENA_SIZE);
+      h_block = h_current->last = h_block->next;
+   }
+   h_memory = (char *) h_block + ARENA_HEADER + h_block->used;
+   h_block->used += i_size;
+   return(h_memory);
+}
+
+/*
+ * arena_mark ()
+ *
+ * Returns the position of the next object to be allocated from the current
+ * arena.
+ *
+ */
+
+void *h_arena_mark()
+{
+   if (h_current == NULL) return(NULL);
+   return((char *) h_current->last + ARENA_HEADER + h_current->last->used);
+}
+
+/*
+ * arena_rewind (mark)
+ *
+ * Releases everything allocated from the current arena since the mark was
+ * taken.
+ *
+ */
+
+void v_arena_rewind(void *h_mark)
+{
+   oblock *h_block, *h_next;
+   char *h_base;
+
+   if (h_current == NULL) return;
+   for (h_block = h_current->first; h_block != NULL; h_block = h_block->next) /* Find the block containing the mark */
+   {
+      h_base = (char *) h_block + ARENA_HEADER;
+      if (((char *) h_mark >= h_base) && ((char *) h_mark <= h_base + h_block->used)) break;
+   }
+   if (h_block == NULL) v_error("Invalid arena mark in %s line : %d\n", __FILE__, __LINE__);
+   h_block->used = (char *) h_mark - h_base;
+   h_next = h_block->next;
+   h_block->next = NULL;
+   h_current->last = h_block;
+   while (h_next != NULL) /* Release any blocks added after the mark */
+   {
+      h_block = h_next;
+      h_next = h_block->next;
+      free(h_block);
+   }
+}
+
+/*
+ * arena_free (arena)
+ *
+ * Releases an arena and everything allocated from it.
+ *
+ */
+
+void v_arena_free(oarena *h_arena)
+{
+   oblock *h_block, *h_next;
+
+   if (h_current == h_arena) h_current = NULL;
+   for (h_block = h_arena->first; h_block != NULL; h_block = h_next)
+   {
+      h_next = h_block->next;
+      free(h_block);
+   }
+   free(h_arena);
+}
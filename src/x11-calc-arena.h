@@ -0,0 +1,52 @@
+/*
+ * x11-calc-arena.h - RPN (Reverse Polish) calculator simulator.
+ *
+ * Copyright(C) 2026   MT
+ *
+ * Arena allocation functions.
+ *
+ * Contains  the type definitions and functions definitions used to allocate
+ * the objects that make up a calculator from a single block of memory.
+ *
+ * This  program is free software: you can redistribute it and/or modify it
+ * under  the terms of the GNU General Public License as published  by  the
+ * Free  Software Foundation, either version 3 of the License, or (at  your
+ * option) any later version.
+ *
+ * This  program  is distributed in the hope that it will  be  useful,  but
+ * WITHOUT   ANY   WARRANTY;   without even   the   implied   warranty   of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You  should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * 17 Oct 26         - Initial version - MT
+ *
+ */
+
+#define ARENA_SIZE      65536          /* Default size of each block */
+#define ARENA_ALIGN     16             /* Alignment of each object */
+
+typedef struct oblock { /* Block of memory in an arena */
+   struct oblock *next;
+   size_t size;
+   size_t used;
+} oblock;
+
+typedef struct { /* Arena structure */
+   oblock *first;
+   oblock *last;
+} oarena;
+
+oarena *h_arena_create(size_t i_size);
+
+void v_arena_select(oarena *h_arena);
+
+void *h_arena_alloc(size_t i_size);
+
+void *h_arena_mark();
+
+void v_arena_rewind(void *h_mark);
+
+void v_arena_free(oarena *h_arena);
@@ -0,0 +1,439 @@
+/*
+ * x11-calc-bitmap.h - RPN (Reverse Polish) calculator simulator.
+ *
+ * Copyright(C) 2026   MT
+ *
+ * Built in bitmap fonts.
+ *
+ * Contains bitmaps for the printable ASCII characters in each of the fonts
+ * used  by the simulator, so that text can be drawn without an X  server.
+ * Each  glyph  is one byte per row (the most significant bit is  the  left
+ * most  pixel) and the fonts have the same size as the X fonts they stand
+ * in for.
+ *
+ * This  program is free software: you can redistribute it and/or modify it
+ * under  the terms of the GNU General Public License as published  by  the
+ * Free  Software Foundation, either version 3 of the License, or (at  your
+ * option) any later version.
+ *
+ * This  program  is distributed in the hope that it will  be  useful,  but
+ * WITHOUT   ANY   WARRANTY;   without even   the   implied   warranty   of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You  should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * 17 Oct 26         - Initial version - MT
+ *
+ */
+
+#define BITMAP_FIRST   32              /* First character in each font */
+#define BITMAP_LAST    126             /* Last character in each font */
+
+static const unsigned char c_font_large[] = { /* 6x13 */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* ' ' */
+   0x00,0x00,0x00,0x00,0x10,0x10,0x10,0x10,0x10,0x00,0x10,0x00,0x00, /* '!' */
+   0x00,0x00,0x00,0x00,0x28,0x28,0x28,0x00,0x00,0x00,0x00,0x00,0x00, /* '"' */
+   0x00,0x00,0x00,0x00,0x28,0x28,0x7c,0x50,0xf8,0x50,0x50,0x00,0x00, /* '#' */
+   0x00,0x00,0x00,0x00,0x10,0x3c,0x50,0x70,0x1c,0x14,0x78,0x10,0x00, /* '$' */
+   0x00,0x00,0x00,0x00,0xe0,0xa0,0xe8,0x30,0x5c,0x14,0x1c,0x00,0x00, /* '%' */
+   0x00,0x00,0x00,0x00,0x38,0x20,0x30,0x54,0x4c,0x48,0x34,0x00,0x00, /* '&' */
+   0x00,0x00,0x00,0x00,0x10,0x10,0x10,0x00,0x00,0x00,0x00,0x00,0x00, /* ''' */
+   0x00,0x00,0x00,0x10,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x10,0x00, /* '(' */
+   0x00,0x00,0x00,0x20,0x20,0x10,0x10,0x10,0x10,0x10,0x20,0x20,0x00, /* ')' */
+   0x00,0x00,0x00,0x00,0x54,0x38,0x38,0x54,0x00,0x00,0x00,0x00,0x00, /* '*' */
+   0x00,0x00,0x00,0x00,0x00,0x10,0x10,0x7c,0x10,0x10,0x00,0x00,0x00, /* '+' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x20,0x20,0x20, /* ',' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x38,0x00,0x00,0x00,0x00, /* '-' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x20,0x00,0x00, /* '.' */
+   0x00,0x00,0x00,0x00,0x04,0x08,0x08,0x10,0x10,0x20,0x20,0x40,0x00, /* '/' */
+   0x00,0x00,0x00,0x00,0x38,0x44,0x44,0x54,0x44,0x44,0x38,0x00,0x00, /* '0' */
+   0x00,0x00,0x00,0x00,0x70,0x10,0x10,0x10,0x10,0x10,0x7c,0x00,0x00, /* '1' */
+   0x00,0x00,0x00,0x00,0x38,0x44,0x04,0x0c,0x18,0x20,0x7c,0x00,0x00, /* '2' */
+   0x00,0x00,0x00,0x00,0x38,0x44,0x04,0x38,0x04,0x44,0x38,0x00,0x00, /* '3' */
+   0x00,0x00,0x00,0x00,0x08,0x18,0x28,0x68,0x7c,0x08,0x08,0x00,0x00, /* '4' */
+   0x00,0x00,0x00,0x00,0x78,0x40,0x78,0x04,0x04,0x04,0x78,0x00,0x00, /* '5' */
+   0x00,0x00,0x00,0x00,0x3c,0x60,0x40,0x78,0x44,0x44,0x38,0x00,0x00, /* '6' */
+   0x00,0x00,0x00,0x00,0x7c,0x0c,0x08,0x08,0x10,0x10,0x20,0x00,0x00, /* '7' */
+   0x00,0x00,0x00,0x00,0x38,0x44,0x44,0x38,0x44,0x44,0x38,0x00,0x00, /* '8' */
+   0x00,0x00,0x00,0x00,0x38,0x44,0x44,0x3c,0x04,0x0c,0x78,0x00,0x00, /* '9' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x20,0x00,0x00,0x00,0x20,0x00,0x00, /* ':' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x20,0x00,0x00,0x00,0x20,0x20,0x20, /* ';' */
+   0x00,0x00,0x00,0x00,0x00,0x04,0x38,0x40,0x38,0x04,0x00,0x00,0x00, /* '<' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0xf8,0x00,0xf8,0x00,0x00,0x00,0x00, /* '=' */
+   0x00,0x00,0x00,0x00,0x00,0x40,0x38,0x04,0x38,0x40,0x00,0x00,0x00, /* '>' */
+   0x00,0x00,0x00,0x00,0x78,0x08,0x10,0x20,0x20,0x00,0x20,0x00,0x00, /* '?' */
+   0x00,0x00,0x00,0x00,0x38,0x24,0x5c,0x54,0x54,0x54,0x5c,0x20,0x18, /* '@' */
+   0x00,0x00,0x00,0x00,0x10,0x10,0x28,0x28,0x38,0x44,0x44,0x00,0x00, /* 'A' */
+   0x00,0x00,0x00,0x00,0x78,0x44,0x44,0x78,0x44,0x44,0x78,0x00,0x00, /* 'B' */
+   0x00,0x00,0x00,0x00,0x3c,0x64,0x40,0x40,0x40,0x64,0x3c,0x00,0x00, /* 'C' */
+   0x00,0x00,0x00,0x00,0x78,0x4c,0x44,0x44,0x44,0x4c,0x78,0x00,0x00, /* 'D' */
+   0x00,0x00,0x00,0x00,0x7c,0x40,0x40,0x7c,0x40,0x40,0x7c,0x00,0x00, /* 'E' */
+   0x00,0x00,0x00,0x00,0x7c,0x40,0x40,0x7c,0x40,0x40,0x40,0x00,0x00, /* 'F' */
+   0x00,0x00,0x00,0x00,0x38,0x64,0x40,0x4c,0x44,0x64,0x3c,0x00,0x00, /* 'G' */
+   0x00,0x00,0x00,0x00,0x44,0x44,0x44,0x7c,0x44,0x44,0x44,0x00,0x00, /* 'H' */
+   0x00,0x00,0x00,0x00,0x7c,0x10,0x10,0x10,0x10,0x10,0x7c,0x00,0x00, /* 'I' */
+   0x00,0x00,0x00,0x00,0x38,0x08,0x08,0x08,0x08,0x48,0x30,0x00,0x00, /* 'J' */
+   0x00,0x00,0x00,0x00,0x44,0x48,0x50,0x60,0x50,0x48,0x44,0x00,0x00, /* 'K' */
+   0x00,0x00,0x00,0x00,0x40,0x40,0x40,0x40,0x40,0x40,0x7c,0x00,0x00, /* 'L' */
+   0x00,0x00,0x00,0x00,0x44,0x6c,0x6c,0x54,0x44,0x44,0x44,0x00,0x00, /* 'M' */
+   0x00,0x00,0x00,0x00,0x44,0x64,0x64,0x54,0x4c,0x4c,0x44,0x00,0x00, /* 'N' */
+   0x00,0x00,0x00,0x00,0x38,0x44,0x44,0x44,0x44,0x44,0x38,0x00,0x00, /* 'O' */
+   0x00,0x00,0x00,0x00,0x78,0x44,0x44,0x78,0x40,0x40,0x40,0x00,0x00, /* 'P' */
+   0x00,0x00,0x00,0x00,0x38,0x44,0x44,0x44,0x44,0x44,0x38,0x0c,0x00, /* 'Q' */
+   0x00,0x00,0x00,0x00,0xf0,0x88,0x88,0xf0,0x98,0x88,0x84,0x00,0x00, /* 'R' */
+   0x00,0x00,0x00,0x00,0x38,0x44,0x40,0x38,0x04,0x44,0x38,0x00,0x00, /* 'S' */
+   0x00,0x00,0x00,0x00,0x7c,0x10,0x10,0x10,0x10,0x10,0x10,0x00,0x00, /* 'T' */
+   0x00,0x00,0x00,0x00,0x44,0x44,0x44,0x44,0x44,0x44,0x38,0x00,0x00, /* 'U' */
+   0x00,0x00,0x00,0x00,0x44,0x44,0x28,0x28,0x28,0x10,0x10,0x00,0x00, /* 'V' */
+   0x00,0x00,0x00,0x00,0x84,0xb4,0xb4,0x78,0x48,0x48,0x48,0x00,0x00, /* 'W' */
+   0x00,0x00,0x00,0x00,0x44,0x28,0x28,0x10,0x28,0x28,0x44,0x00,0x00, /* 'X' */
+   0x00,0x00,0x00,0x00,0x44,0x28,0x28,0x10,0x10,0x10,0x10,0x00,0x00, /* 'Y' */
+   0x00,0x00,0x00,0x00,0x7c,0x08,0x08,0x10,0x20,0x20,0x7c,0x00,0x00, /* 'Z' */
+   0x00,0x00,0x00,0x30,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x30,0x00, /* '[' */
+   0x00,0x00,0x00,0x00,0x40,0x20,0x20,0x10,0x10,0x08,0x08,0x04,0x00, /* '\' */
+   0x00,0x00,0x00,0x30,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x30,0x00, /* ']' */
+   0x00,0x00,0x00,0x00,0x20,0x50,0x88,0x00,0x00,0x00,0x00,0x00,0x00, /* '^' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xfc, /* '_' */
+   0x00,0x00,0x00,0x40,0x20,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* '`' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x78,0x04,0x3c,0x44,0x7c,0x00,0x00, /* 'a' */
+   0x00,0x00,0x00,0x40,0x40,0x40,0x78,0x44,0x44,0x44,0x78,0x00,0x00, /* 'b' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x38,0x40,0x40,0x40,0x38,0x00,0x00, /* 'c' */
+   0x00,0x00,0x00,0x04,0x04,0x04,0x3c,0x44,0x44,0x44,0x3c,0x00,0x00, /* 'd' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x38,0x44,0x7c,0x40,0x3c,0x00,0x00, /* 'e' */
+   0x00,0x00,0x00,0x18,0x20,0x20,0x78,0x20,0x20,0x20,0x20,0x00,0x00, /* 'f' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x3c,0x44,0x44,0x44,0x3c,0x04,0x38, /* 'g' */
+   0x00,0x00,0x00,0x40,0x40,0x40,0x58,0x64,0x44,0x44,0x44,0x00,0x00, /* 'h' */
+   0x00,0x00,0x00,0x10,0x00,0x00,0x30,0x10,0x10,0x10,0x7c,0x00,0x00, /* 'i' */
+   0x00,0x00,0x00,0x10,0x00,0x00,0x70,0x10,0x10,0x10,0x10,0x10,0x60, /* 'j' */
+   0x00,0x00,0x00,0x40,0x40,0x40,0x48,0x50,0x70,0x48,0x44,0x00,0x00, /* 'k' */
+   0x00,0x00,0x00,0xe0,0x20,0x20,0x20,0x20,0x20,0x20,0x18,0x00,0x00, /* 'l' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x7c,0x54,0x54,0x54,0x54,0x00,0x00, /* 'm' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x58,0x64,0x44,0x44,0x44,0x00,0x00, /* 'n' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x38,0x44,0x44,0x44,0x38,0x00,0x00, /* 'o' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x78,0x44,0x44,0x44,0x78,0x40,0x40, /* 'p' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x3c,0x44,0x44,0x44,0x3c,0x04,0x04, /* 'q' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x3c,0x24,0x20,0x20,0x20,0x00,0x00, /* 'r' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x3c,0x40,0x3c,0x04,0x78,0x00,0x00, /* 's' */
+   0x00,0x00,0x00,0x00,0x20,0x20,0x78,0x20,0x20,0x20,0x38,0x00,0x00, /* 't' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x44,0x44,0x44,0x44,0x3c,0x00,0x00, /* 'u' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x44,0x28,0x28,0x28,0x10,0x00,0x00, /* 'v' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x44,0x54,0x28,0x28,0x28,0x00,0x00, /* 'w' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x6c,0x28,0x10,0x28,0x6c,0x00,0x00, /* 'x' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x44,0x28,0x28,0x10,0x10,0x10,0x60, /* 'y' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x7c,0x08,0x10,0x20,0x7c,0x00,0x00, /* 'z' */
+   0x00,0x00,0x00,0x18,0x10,0x10,0x10,0x60,0x10,0x10,0x10,0x18,0x00, /* '{' */
+   0x00,0x00,0x00,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10, /* '|' */
+   0x00,0x00,0x00,0x30,0x10,0x10,0x10,0x0c,0x10,0x10,0x10,0x30,0x00, /* '}' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x70,0x0c,0x00,0x00,0x00,0x00, /* '~' */
+};
+
+static const unsigned char c_font_normal[] = { /* 6x12 */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* ' ' */
+   0x00,0x00,0x00,0x10,0x10,0x10,0x10,0x10,0x00,0x10,0x00,0x00, /* '!' */
+   0x00,0x00,0x00,0x28,0x28,0x28,0x00,0x00,0x00,0x00,0x00,0x00, /* '"' */
+   0x00,0x00,0x00,0x28,0x28,0x7c,0x50,0xf8,0x50,0x50,0x00,0x00, /* '#' */
+   0x00,0x00,0x00,0x10,0x3c,0x50,0x70,0x1c,0x14,0x78,0x10,0x00, /* '$' */
+   0x00,0x00,0x00,0xe0,0xa0,0xe8,0x30,0x5c,0x14,0x1c,0x00,0x00, /* '%' */
+   0x00,0x00,0x00,0x38,0x20,0x30,0x54,0x4c,0x48,0x34,0x00,0x00, /* '&' */
+   0x00,0x00,0x00,0x10,0x10,0x10,0x00,0x00,0x00,0x00,0x00,0x00, /* ''' */
+   0x00,0x00,0x10,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x10,0x00, /* '(' */
+   0x00,0x00,0x20,0x20,0x10,0x10,0x10,0x10,0x10,0x20,0x20,0x00, /* ')' */
+   0x00,0x00,0x00,0x54,0x38,0x38,0x54,0x00,0x00,0x00,0x00,0x00, /* '*' */
+   0x00,0x00,0x00,0x00,0x10,0x10,0x7c,0x10,0x10,0x00,0x00,0x00, /* '+' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x20,0x20,0x20, /* ',' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x38,0x00,0x00,0x00,0x00, /* '-' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x20,0x00,0x00, /* '.' */
+   0x00,0x00,0x00,0x04,0x08,0x08,0x10,0x10,0x20,0x20,0x40,0x00, /* '/' */
+   0x00,0x00,0x00,0x38,0x44,0x44,0x54,0x44,0x44,0x38,0x00,0x00, /* '0' */
+   0x00,0x00,0x00,0x70,0x10,0x10,0x10,0x10,0x10,0x7c,0x00,0x00, /* '1' */
+   0x00,0x00,0x00,0x38,0x44,0x04,0x0c,0x18,0x20,0x7c,0x00,0x00, /* '2' */
+   0x00,0x00,0x00,0x38,0x44,0x04,0x38,0x04,0x44,0x38,0x00,0x00, /* '3' */
+   0x00,0x00,0x00,0x08,0x18,0x28,0x68,0x7c,0x08,0x08,0x00,0x00, /* '4' */
+   0x00,0x00,0x00,0x78,0x40,0x78,0x04,0x04,0x04,0x78,0x00,0x00, /* '5' */
+   0x00,0x00,0x00,0x3c,0x60,0x40,0x78,0x44,0x44,0x38,0x00,0x00, /* '6' */
+   0x00,0x00,0x00,0x7c,0x0c,0x08,0x08,0x10,0x10,0x20,0x00,0x00, /* '7' */
+   0x00,0x00,0x00,0x38,0x44,0x44,0x38,0x44,0x44,0x38,0x00,0x00, /* '8' */
+   0x00,0x00,0x00,0x38,0x44,0x44,0x3c,0x04,0x0c,0x78,0x00,0x00, /* '9' */
+   0x00,0x00,0x00,0x00,0x00,0x20,0x00,0x00,0x00,0x20,0x00,0x00, /* ':' */
+   0x00,0x00,0x00,0x00,0x00,0x20,0x00,0x00,0x00,0x20,0x20,0x20, /* ';' */
+   0x00,0x00,0x00,0x00,0x04,0x38,0x40,0x38,0x04,0x00,0x00,0x00, /* '<' */
+   0x00,0x00,0x00,0x00,0x00,0xf8,0x00,0xf8,0x00,0x00,0x00,0x00, /* '=' */
+   0x00,0x00,0x00,0x00,0x40,0x38,0x04,0x38,0x40,0x00,0x00,0x00, /* '>' */
+   0x00,0x00,0x00,0x78,0x08,0x10,0x20,0x20,0x00,0x20,0x00,0x00, /* '?' */
+   0x00,0x00,0x00,0x38,0x24,0x5c,0x54,0x54,0x54,0x5c,0x20,0x18, /* '@' */
+   0x00,0x00,0x00,0x10,0x10,0x28,0x28,0x38,0x44,0x44,0x00,0x00, /* 'A' */
+   0x00,0x00,0x00,0x78,0x44,0x44,0x78,0x44,0x44,0x78,0x00,0x00, /* 'B' */
+   0x00,0x00,0x00,0x3c,0x64,0x40,0x40,0x40,0x64,0x3c,0x00,0x00, /* 'C' */
+   0x00,0x00,0x00,0x78,0x4c,0x44,0x44,0x44,0x4c,0x78,0x00,0x00, /* 'D' */
+   0x00,0x00,0x00,0x7c,0x40,0x40,0x7c,0x40,0x40,0x7c,0x00,0x00, /* 'E' */
+   0x00,0x00,0x00,0x7c,0x40,0x40,0x7c,0x40,0x40,0x40,0x00,0x00, /* 'F' */
+   0x00,0x00,0x00,0x38,0x64,0x40,0x4c,0x44,0x64,0x3c,0x00,0x00, /* 'G' */
+   0x00,0x00,0x00,0x44,0x44,0x44,0x7c,0x44,0x44,0x44,0x00,0x00, /* 'H' */
+   0x00,0x00,0x00,0x7c,0x10,0x10,0x10,0x10,0x10,0x7c,0x00,0x00, /* 'I' */
+   0x00,0x00,0x00,0x38,0x08,0x08,0x08,0x08,0x48,0x30,0x00,0x00, /* 'J' */
+   0x00,0x00,0x00,0x44,0x48,0x50,0x60,0x50,0x48,0x44,0x00,0x00, /* 'K' */
+   0x00,0x00,0x00,0x40,0x40,0x40,0x40,0x40,0x40,0x7c,0x00,0x00, /* 'L' */
+   0x00,0x00,0x00,0x44,0x6c,0x6c,0x54,0x44,0x44,0x44,0x00,0x00, /* 'M' */
+   0x00,0x00,0x00,0x44,0x64,0x64,0x54,0x4c,0x4c,0x44,0x00,0x00, /* 'N' */
+   0x00,0x00,0x00,0x38,0x44,0x44,0x44,0x44,0x44,0x38,0x00,0x00, /* 'O' */
+   0x00,0x00,0x00,0x78,0x44,0x44,0x78,0x40,0x40,0x40,0x00,0x00, /* 'P' */
+   0x00,0x00,0x00,0x38,0x44,0x44,0x44,0x44,0x44,0x38,0x0c,0x00, /* 'Q' */
+   0x00,0x00,0x00,0xf0,0x88,0x88,0xf0,0x98,0x88,0x84,0x00,0x00, /* 'R' */
+   0x00,0x00,0x00,0x38,0x44,0x40,0x38,0x04,0x44,0x38,0x00,0x00, /* 'S' */
+   0x00,0x00,0x00,0x7c,0x10,0x10,0x10,0x10,0x10,0x10,0x00,0x00, /* 'T' */
+   0x00,0x00,0x00,0x44,0x44,0x44,0x44,0x44,0x44,0x38,0x00,0x00, /* 'U' */
+   0x00,0x00,0x00,0x44,0x44,0x28,0x28,0x28,0x10,0x10,0x00,0x00, /* 'V' */
+   0x00,0x00,0x00,0x84,0xb4,0xb4,0x78,0x48,0x48,0x48,0x00,0x00, /* 'W' */
+   0x00,0x00,0x00,0x44,0x28,0x28,0x10,0x28,0x28,0x44,0x00,0x00, /* 'X' */
+   0x00,0x00,0x00,0x44,0x28,0x28,0x10,0x10,0x10,0x10,0x00,0x00, /* 'Y' */
+   0x00,0x00,0x00,0x7c,0x08,0x08,0x10,0x20,0x20,0x7c,0x00,0x00, /* 'Z' */
+   0x00,0x00,0x30,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x30,0x00, /* '[' */
+   0x00,0x00,0x00,0x40,0x20,0x20,0x10,0x10,0x08,0x08,0x04,0x00, /* '\' */
+   0x00,0x00,0x30,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x30,0x00, /* ']' */
+   0x00,0x00,0x00,0x20,0x50,0x88,0x00,0x00,0x00,0x00,0x00,0x00, /* '^' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xfc, /* '_' */
+   0x00,0x00,0x40,0x20,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* '`' */
+   0x00,0x00,0x00,0x00,0x00,0x78,0x04,0x3c,0x44,0x7c,0x00,0x00, /* 'a' */
+   0x00,0x00,0x40,0x40,0x40,0x78,0x44,0x44,0x44,0x78,0x00,0x00, /* 'b' */
+   0x00,0x00,0x00,0x00,0x00,0x38,0x40,0x40,0x40,0x38,0x00,0x00, /* 'c' */
+   0x00,0x00,0x04,0x04,0x04,0x3c,0x44,0x44,0x44,0x3c,0x00,0x00, /* 'd' */
+   0x00,0x00,0x00,0x00,0x00,0x38,0x44,0x7c,0x40,0x3c,0x00,0x00, /* 'e' */
+   0x00,0x00,0x18,0x20,0x20,0x78,0x20,0x20,0x20,0x20,0x00,0x00, /* 'f' */
+   0x00,0x00,0x00,0x00,0x00,0x3c,0x44,0x44,0x44,0x3c,0x04,0x38, /* 'g' */
+   0x00,0x00,0x40,0x40,0x40,0x58,0x64,0x44,0x44,0x44,0x00,0x00, /* 'h' */
+   0x00,0x00,0x10,0x00,0x00,0x30,0x10,0x10,0x10,0x7c,0x00,0x00, /* 'i' */
+   0x00,0x00,0x10,0x00,0x00,0x70,0x10,0x10,0x10,0x10,0x10,0x60, /* 'j' */
+   0x00,0x00,0x40,0x40,0x40,0x48,0x50,0x70,0x48,0x44,0x00,0x00, /* 'k' */
+   0x00,0x00,0xe0,0x20,0x20,0x20,0x20,0x20,0x20,0x18,0x00,0x00, /* 'l' */
+   0x00,0x00,0x00,0x00,0x00,0x7c,0x54,0x54,0x54,0x54,0x00,0x00, /* 'm' */
+   0x00,0x00,0x00,0x00,0x00,0x58,0x64,0x44,0x44,0x44,0x00,0x00, /* 'n' */
+   0x00,0x00,0x00,0x00,0x00,0x38,0x44,0x44,0x44,0x38,0x00,0x00, /* 'o' */
+   0x00,0x00,0x00,0x00,0x00,0x78,0x44,0x44,0x44,0x78,0x40,0x40, /* 'p' */
+   0x00,0x00,0x00,0x00,0x00,0x3c,0x44,0x44,0x44,0x3c,0x04,0x04, /* 'q' */
+   0x00,0x00,0x00,0x00,0x00,0x3c,0x24,0x20,0x20,0x20,0x00,0x00, /* 'r' */
+   0x00,0x00,0x00,0x00,0x00,0x3c,0x40,0x3c,0x04,0x78,0x00,0x00, /* 's' */
+   0x00,0x00,0x00,0x20,0x20,0x78,0x20,0x20,0x20,0x38,0x00,0x00, /* 't' */
+   0x00,0x00,0x00,0x00,0x00,0x44,0x44,0x44,0x44,0x3c,0x00,0x00, /* 'u' */
+   0x00,0x00,0x00,0x00,0x00,0x44,0x28,0x28,0x28,0x10,0x00,0x00, /* 'v' */
+   0x00,0x00,0x00,0x00,0x00,0x44,0x54,0x28,0x28,0x28,0x00,0x00, /* 'w' */
+   0x00,0x00,0x00,0x00,0x00,0x6c,0x28,0x10,0x28,0x6c,0x00,0x00, /* 'x' */
+   0x00,0x00,0x00,0x00,0x00,0x44,0x28,0x28,0x10,0x10,0x10,0x60, /* 'y' */
+   0x00,0x00,0x00,0x00,0x00,0x7c,0x08,0x10,0x20,0x7c,0x00,0x00, /* 'z' */
+   0x00,0x00,0x18,0x10,0x10,0x10,0x60,0x10,0x10,0x10,0x18,0x00, /* '{' */
+   0x00,0x00,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10, /* '|' */
+   0x00,0x00,0x30,0x10,0x10,0x10,0x0c,0x10,0x10,0x10,0x30,0x00, /* '}' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x70,0x0c,0x00,0x00,0x00,0x00, /* '~' */
+};
+
+static const unsigned char c_font_small[] = { /* 6x10 */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* ' ' */
+   0x00,0x20,0x20,0x20,0x20,0x20,0x00,0x20,0x00,0x00, /* '!' */
+   0x00,0x50,0x50,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* '"' */
+   0x00,0x30,0x50,0xf8,0x50,0xf8,0x60,0xa0,0x00,0x00, /* '#' */
+   0x00,0x10,0x3c,0x50,0x70,0x1c,0x14,0x78,0x10,0x00, /* '$' */
+   0x00,0xe0,0xa0,0xe8,0x30,0x78,0x28,0x38,0x00,0x00, /* '%' */
+   0x00,0x38,0x20,0x20,0x30,0x58,0x50,0x38,0x00,0x00, /* '&' */
+   0x00,0x20,0x20,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* ''' */
+   0x10,0x20,0x20,0x20,0x20,0x20,0x20,0x10,0x00,0x00, /* '(' */
+   0x20,0x20,0x10,0x10,0x10,0x10,0x20,0x20,0x00,0x00, /* ')' */
+   0x00,0xa8,0x70,0x70,0xa8,0x00,0x00,0x00,0x00,0x00, /* '*' */
+   0x00,0x00,0x00,0x20,0x20,0xf8,0x20,0x20,0x00,0x00, /* '+' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x20,0x20,0x20, /* ',' */
+   0x00,0x00,0x00,0x00,0x00,0x30,0x00,0x00,0x00,0x00, /* '-' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x20,0x00,0x00, /* '.' */
+   0x00,0x10,0x20,0x20,0x60,0x40,0x40,0x80,0x00,0x00, /* '/' */
+   0x00,0x30,0x48,0x48,0x58,0x48,0x48,0x30,0x00,0x00, /* '0' */
+   0x00,0x30,0x10,0x10,0x10,0x10,0x10,0x38,0x00,0x00, /* '1' */
+   0x00,0x30,0x48,0x08,0x18,0x30,0x60,0x78,0x00,0x00, /* '2' */
+   0x00,0x30,0x48,0x08,0x30,0x08,0x08,0x70,0x00,0x00, /* '3' */
+   0x00,0x10,0x10,0x30,0x30,0x50,0x78,0x10,0x00,0x00, /* '4' */
+   0x00,0x78,0x40,0x40,0x70,0x08,0x08,0x70,0x00,0x00, /* '5' */
+   0x00,0x38,0x60,0x40,0x78,0x48,0x48,0x30,0x00,0x00, /* '6' */
+   0x00,0x78,0x08,0x10,0x10,0x10,0x30,0x20,0x00,0x00, /* '7' */
+   0x00,0x30,0x48,0x48,0x30,0x48,0x48,0x30,0x00,0x00, /* '8' */
+   0x00,0x30,0x48,0x48,0x78,0x08,0x18,0x70,0x00,0x00, /* '9' */
+   0x00,0x00,0x00,0x20,0x00,0x00,0x00,0x20,0x00,0x00, /* ':' */
+   0x00,0x00,0x00,0x20,0x00,0x00,0x00,0x20,0x20,0x20, /* ';' */
+   0x00,0x00,0x00,0x04,0x38,0x70,0x0c,0x00,0x00,0x00, /* '<' */
+   0x00,0x00,0x00,0x00,0xf8,0x00,0xf8,0x00,0x00,0x00, /* '=' */
+   0x00,0x00,0x00,0x40,0x38,0x1c,0x60,0x00,0x00,0x00, /* '>' */
+   0x00,0x78,0x08,0x10,0x20,0x20,0x00,0x20,0x00,0x00, /* '?' */
+   0x00,0x00,0x30,0x48,0x58,0x58,0x58,0x60,0x30,0x00, /* '@' */
+   0x00,0x30,0x30,0x30,0x48,0x48,0x78,0x48,0x00,0x00, /* 'A' */
+   0x00,0x70,0x48,0x48,0x70,0x48,0x48,0x78,0x00,0x00, /* 'B' */
+   0x00,0x38,0x40,0x40,0x40,0x40,0x40,0x38,0x00,0x00, /* 'C' */
+   0x00,0x70,0x48,0x48,0x48,0x48,0x48,0x70,0x00,0x00, /* 'D' */
+   0x00,0x78,0x40,0x40,0x78,0x40,0x40,0x78,0x00,0x00, /* 'E' */
+   0x00,0x78,0x40,0x40,0x78,0x40,0x40,0x40,0x00,0x00, /* 'F' */
+   0x00,0x38,0x40,0x40,0x58,0x48,0x48,0x38,0x00,0x00, /* 'G' */
+   0x00,0x48,0x48,0x48,0x78,0x48,0x48,0x48,0x00,0x00, /* 'H' */
+   0x00,0x70,0x20,0x20,0x20,0x20,0x20,0x70,0x00,0x00, /* 'I' */
+   0x00,0x38,0x08,0x08,0x08,0x08,0x08,0x78,0x00,0x00, /* 'J' */
+   0x00,0x48,0x50,0x60,0x60,0x50,0x50,0x48,0x00,0x00, /* 'K' */
+   0x00,0x40,0x40,0x40,0x40,0x40,0x40,0x78,0x00,0x00, /* 'L' */
+   0x00,0x48,0x78,0x78,0x78,0x78,0x48,0x48,0x00,0x00, /* 'M' */
+   0x00,0x48,0x68,0x68,0x58,0x58,0x58,0x48,0x00,0x00, /* 'N' */
+   0x00,0x30,0x48,0x48,0x48,0x48,0x48,0x30,0x00,0x00, /* 'O' */
+   0x00,0x70,0x48,0x48,0x70,0x40,0x40,0x40,0x00,0x00, /* 'P' */
+   0x00,0x30,0x48,0x48,0x48,0x48,0x48,0x30,0x08,0x00, /* 'Q' */
+   0x00,0x70,0x48,0x48,0x70,0x58,0x48,0x44,0x00,0x00, /* 'R' */
+   0x00,0x30,0x48,0x40,0x38,0x08,0x48,0x30,0x00,0x00, /* 'S' */
+   0x00,0xf8,0x20,0x20,0x20,0x20,0x20,0x20,0x00,0x00, /* 'T' */
+   0x00,0x48,0x48,0x48,0x48,0x48,0x48,0x30,0x00,0x00, /* 'U' */
+   0x00,0x48,0x48,0x30,0x30,0x30,0x30,0x30,0x00,0x00, /* 'V' */
+   0x00,0x88,0x88,0xa8,0xd8,0x50,0x50,0x50,0x00,0x00, /* 'W' */
+   0x00,0x48,0x48,0x30,0x30,0x30,0x48,0x48,0x00,0x00, /* 'X' */
+   0x00,0x88,0x50,0x50,0x20,0x20,0x20,0x20,0x00,0x00, /* 'Y' */
+   0x00,0x78,0x08,0x10,0x10,0x20,0x40,0x78,0x00,0x00, /* 'Z' */
+   0x30,0x20,0x20,0x20,0x20,0x20,0x20,0x30,0x00,0x00, /* '[' */
+   0x00,0x80,0x40,0x40,0x60,0x20,0x20,0x10,0x00,0x00, /* '\' */
+   0x30,0x10,0x10,0x10,0x10,0x10,0x10,0x30,0x00,0x00, /* ']' */
+   0x00,0x20,0xd0,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* '^' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xf8, /* '_' */
+   0x40,0x20,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* '`' */
+   0x00,0x00,0x00,0x70,0x08,0x78,0x48,0x78,0x00,0x00, /* 'a' */
+   0x40,0x40,0x40,0x70,0x48,0x48,0x48,0x70,0x00,0x00, /* 'b' */
+   0x00,0x00,0x00,0x38,0x40,0x40,0x40,0x38,0x00,0x00, /* 'c' */
+   0x08,0x08,0x08,0x38,0x48,0x48,0x48,0x38,0x00,0x00, /* 'd' */
+   0x00,0x00,0x00,0x30,0x48,0x78,0x40,0x38,0x00,0x00, /* 'e' */
+   0x18,0x20,0x20,0x78,0x20,0x20,0x20,0x20,0x00,0x00, /* 'f' */
+   0x00,0x00,0x00,0x38,0x48,0x48,0x48,0x38,0x08,0x30, /* 'g' */
+   0x40,0x40,0x40,0x78,0x48,0x48,0x48,0x48,0x00,0x00, /* 'h' */
+   0x20,0x00,0x00,0x60,0x20,0x20,0x20,0xf8,0x00,0x00, /* 'i' */
+   0x10,0x00,0x00,0x30,0x10,0x10,0x10,0x10,0x10,0x70, /* 'j' */
+   0x40,0x40,0x40,0x48,0x50,0x60,0x50,0x48,0x00,0x00, /* 'k' */
+   0xe0,0x20,0x20,0x20,0x20,0x20,0x20,0x18,0x00,0x00, /* 'l' */
+   0x00,0x00,0x00,0x7c,0x54,0x54,0x54,0x54,0x00,0x00, /* 'm' */
+   0x00,0x00,0x00,0x78,0x48,0x48,0x48,0x48,0x00,0x00, /* 'n' */
+   0x00,0x00,0x00,0x30,0x48,0x48,0x48,0x30,0x00,0x00, /* 'o' */
+   0x00,0x00,0x00,0x70,0x48,0x48,0x48,0x70,0x40,0x40, /* 'p' */
+   0x00,0x00,0x00,0x38,0x48,0x48,0x48,0x38,0x08,0x08, /* 'q' */
+   0x00,0x00,0x00,0x38,0x20,0x20,0x20,0x20,0x00,0x00, /* 'r' */
+   0x00,0x00,0x00,0x78,0x40,0x38,0x08,0x78,0x00,0x00, /* 's' */
+   0x00,0x00,0x20,0x78,0x20,0x20,0x20,0x38,0x00,0x00, /* 't' */
+   0x00,0x00,0x00,0x48,0x48,0x48,0x48,0x78,0x00,0x00, /* 'u' */
+   0x00,0x00,0x00,0x48,0x48,0x30,0x30,0x30,0x00,0x00, /* 'v' */
+   0x00,0x00,0x00,0x88,0xa8,0x50,0x50,0x50,0x00,0x00, /* 'w' */
+   0x00,0x00,0x00,0x48,0x30,0x30,0x30,0x48,0x00,0x00, /* 'x' */
+   0x00,0x00,0x00,0x48,0x48,0x30,0x30,0x20,0x20,0x60, /* 'y' */
+   0x00,0x00,0x00,0x78,0x10,0x30,0x20,0x78,0x00,0x00, /* 'z' */
+   0x30,0x20,0x20,0x40,0x20,0x20,0x20,0x30,0x00,0x00, /* '{' */
+   0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x00, /* '|' */
+   0x60,0x20,0x20,0x10,0x20,0x20,0x20,0x60,0x00,0x00, /* '}' */
+   0x00,0x00,0x00,0x00,0x70,0x0c,0x00,0x00,0x00,0x00, /* '~' */
+};
+
+static const unsigned char c_font_alternate[] = { /* 5x8 */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00, /* ' ' */
+   0x00,0x20,0x20,0x20,0x20,0x00,0x20,0x00, /* '!' */
+   0x00,0x50,0x50,0x00,0x00,0x00,0x00,0x00, /* '"' */
+   0x30,0x50,0xf8,0x50,0xf8,0x60,0xa0,0x00, /* '#' */
+   0x00,0x20,0xf8,0xa0,0x70,0x28,0xf8,0x20, /* '$' */
+   0x00,0xe0,0xa0,0xf0,0x78,0x28,0x38,0x00, /* '%' */
+   0x00,0x38,0x20,0x30,0x58,0x50,0x38,0x00, /* '&' */
+   0x00,0x20,0x20,0x00,0x00,0x00,0x00,0x00, /* ''' */
+   0x10,0x20,0x20,0x20,0x20,0x20,0x10,0x00, /* '(' */
+   0x40,0x20,0x20,0x20,0x20,0x20,0x40,0x00, /* ')' */
+   0x00,0xa8,0x70,0x70,0xa8,0x00,0x00,0x00, /* '*' */
+   0x00,0x00,0x20,0x20,0xf8,0x20,0x20,0x00, /* '+' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x20,0x20, /* ',' */
+   0x00,0x00,0x00,0x00,0x60,0x00,0x00,0x00, /* '-' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x20,0x00, /* '.' */
+   0x00,0x10,0x20,0x20,0x60,0x40,0x40,0x80, /* '/' */
+   0x00,0x30,0x48,0x68,0x48,0x48,0x30,0x00, /* '0' */
+   0x00,0x60,0x20,0x20,0x20,0x20,0x70,0x00, /* '1' */
+   0x00,0x70,0x08,0x08,0x10,0x20,0x78,0x00, /* '2' */
+   0x00,0x70,0x08,0x08,0x30,0x08,0x78,0x00, /* '3' */
+   0x00,0x10,0x30,0x30,0x50,0x78,0x10,0x00, /* '4' */
+   0x00,0x78,0x40,0x70,0x08,0x08,0x70,0x00, /* '5' */
+   0x00,0x38,0x60,0x40,0x78,0x48,0x38,0x00, /* '6' */
+   0x00,0x78,0x08,0x10,0x10,0x10,0x20,0x00, /* '7' */
+   0x00,0x30,0x48,0x48,0x30,0x48,0x78,0x00, /* '8' */
+   0x00,0x70,0x48,0x78,0x08,0x18,0x70,0x00, /* '9' */
+   0x00,0x00,0x00,0x20,0x00,0x00,0x20,0x00, /* ':' */
+   0x00,0x00,0x00,0x20,0x00,0x00,0x20,0x20, /* ';' */
+   0x00,0x00,0x00,0x08,0x70,0x60,0x18,0x00, /* '<' */
+   0x00,0x00,0x00,0xf0,0x00,0xf0,0x00,0x00, /* '=' */
+   0x00,0x00,0x00,0x40,0x38,0x18,0x60,0x00, /* '>' */
+   0x00,0x70,0x30,0x20,0x20,0x00,0x20,0x00, /* '?' */
+   0x00,0x00,0x30,0x48,0x58,0x58,0x40,0x30, /* '@' */
+   0x00,0x30,0x30,0x30,0x30,0x78,0x48,0x00, /* 'A' */
+   0x00,0x70,0x48,0x48,0x70,0x48,0x78,0x00, /* 'B' */
+   0x00,0x38,0x40,0x40,0x40,0x40,0x38,0x00, /* 'C' */
+   0x00,0x70,0x48,0x48,0x48,0x48,0x70,0x00, /* 'D' */
+   0x00,0x78,0x40,0x40,0x78,0x40,0x78,0x00, /* 'E' */
+   0x00,0x78,0x40,0x40,0x78,0x40,0x40,0x00, /* 'F' */
+   0x00,0x38,0x40,0x40,0x58,0x48,0x38,0x00, /* 'G' */
+   0x00,0x48,0x48,0x48,0x78,0x48,0x48,0x00, /* 'H' */
+   0x00,0x70,0x20,0x20,0x20,0x20,0x70,0x00, /* 'I' */
+   0x00,0x30,0x10,0x10,0x10,0x10,0x70,0x00, /* 'J' */
+   0x00,0x48,0x50,0x60,0x50,0x50,0x48,0x00, /* 'K' */
+   0x00,0x40,0x40,0x40,0x40,0x40,0x78,0x00, /* 'L' */
+   0x00,0x48,0x78,0x78,0x78,0x48,0x48,0x00, /* 'M' */
+   0x00,0x48,0x68,0x68,0x58,0x58,0x48,0x00, /* 'N' */
+   0x00,0x30,0x48,0x48,0x48,0x48,0x30,0x00, /* 'O' */
+   0x00,0x78,0x48,0x78,0x40,0x40,0x40,0x00, /* 'P' */
+   0x00,0x30,0x48,0x48,0x48,0x48,0x30,0x08, /* 'Q' */
+   0x00,0xf0,0x90,0xe0,0xb0,0x90,0x88,0x00, /* 'R' */
+   0x00,0x38,0x40,0x70,0x18,0x08,0x78,0x00, /* 'S' */
+   0x00,0xf8,0x20,0x20,0x20,0x20,0x20,0x00, /* 'T' */
+   0x00,0x48,0x48,0x48,0x48,0x48,0x30,0x00, /* 'U' */
+   0x00,0x48,0x48,0x30,0x30,0x30,0x30,0x00, /* 'V' */
+   0x00,0x88,0x88,0xa8,0x50,0x50,0x50,0x00, /* 'W' */
+   0x00,0x48,0x30,0x30,0x30,0x30,0x48,0x00, /* 'X' */
+   0x00,0x88,0x50,0x20,0x20,0x20,0x20,0x00, /* 'Y' */
+   0x00,0x78,0x10,0x10,0x20,0x20,0x78,0x00, /* 'Z' */
+   0x30,0x20,0x20,0x20,0x20,0x20,0x30,0x00, /* '[' */
+   0x00,0x80,0x40,0x40,0x60,0x20,0x20,0x10, /* '\' */
+   0x60,0x20,0x20,0x20,0x20,0x20,0x60,0x00, /* ']' */
+   0x00,0x60,0x90,0x00,0x00,0x00,0x00,0x00, /* '^' */
+   0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xf8, /* '_' */
+   0x00,0x40,0x00,0x00,0x00,0x00,0x00,0x00, /* '`' */
+   0x00,0x00,0x00,0x78,0x78,0x48,0x78,0x00, /* 'a' */
+   0x40,0x40,0x40,0x70,0x48,0x48,0x70,0x00, /* 'b' */
+   0x00,0x00,0x00,0x30,0x40,0x40,0x30,0x00, /* 'c' */
+   0x08,0x08,0x08,0x38,0x48,0x48,0x38,0x00, /* 'd' */
+   0x00,0x00,0x00,0x38,0x78,0x40,0x38,0x00, /* 'e' */
+   0x18,0x20,0x20,0x78,0x20,0x20,0x20,0x00, /* 'f' */
+   0x00,0x00,0x38,0x48,0x48,0x38,0x08,0x70, /* 'g' */
+   0x40,0x40,0x40,0x78,0x48,0x48,0x48,0x00, /* 'h' */
+   0x20,0x00,0x00,0x60,0x20,0x20,0x70,0x00, /* 'i' */
+   0x20,0x00,0x00,0x60,0x20,0x20,0x20,0x20, /* 'j' */
+   0x40,0x40,0x40,0x58,0x70,0x70,0x58,0x00, /* 'k' */
+   0x60,0x20,0x20,0x20,0x20,0x20,0x38,0x00, /* 'l' */
+   0x00,0x00,0x00,0xf8,0xa8,0xa8,0xa8,0x00, /* 'm' */
+   0x00,0x00,0x00,0x78,0x48,0x48,0x48,0x00, /* 'n' */
+   0x00,0x00,0x00,0x30,0x48,0x48,0x30,0x00, /* 'o' */
+   0x00,0x00,0x70,0x48,0x48,0x70,0x40,0x40, /* 'p' */
+   0x00,0x00,0x38,0x48,0x48,0x38,0x08,0x08, /* 'q' */
+   0x00,0x00,0x00,0x70,0x40,0x40,0x40,0x00, /* 'r' */
+   0x00,0x00,0x00,0x78,0x70,0x08,0x78,0x00, /* 's' */
+   0x00,0x00,0x20,0x78,0x20,0x20,0x38,0x00, /* 't' */
+   0x00,0x00,0x00,0x48,0x48,0x48,0x78,0x00, /* 'u' */
+   0x00,0x00,0x00,0x48,0x30,0x30,0x30,0x00, /* 'v' */
+   0x00,0x00,0x00,0x88,0xa8,0x70,0x50,0x00, /* 'w' */
+   0x00,0x00,0x00,0x78,0x30,0x30,0x78,0x00, /* 'x' */
+   0x00,0x00,0x48,0x30,0x30,0x20,0x20,0x60, /* 'y' */
+   0x00,0x00,0x00,0x78,0x30,0x20,0x78,0x00, /* 'z' */
+   0x30,0x20,0x20,0x40,0x20,0x20,0x30,0x00, /* '{' */
+   0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20, /* '|' */
+   0x60,0x20,0x20,0x10,0x20,0x20,0x60,0x00, /* '}' */
+   0x00,0x00,0x00,0x00,0x78,0x00,0x00,0x00, /* '~' */
+};
+
+typedef struct { /* Built in font */
+   char *name; /* Name of the X font it replaces */
+   int width;
+   int ascent;
+   int descent;
+   const unsigned char *bitmap;
+} obitmap;
+
+static const obitmap h_bitmap[] = {
+   { "6x13", 6, 11, 2, c_font_large },
+   { "6x12", 6, 10, 2, c_font_normal },
+   { "6x10", 6, 8, 2, c_font_small },
+   { "5x8", 5, 7, 1, c_font_alternate }
+};
@@ -50,6 +50,13 @@
  * 12 Feb 22         - Added a style property, currently used to allow flat
  *                     buttons to be drawn - MT
  * 26 Nov 22         - Added support for the original HP10.
+ * 17 Oct 26         - Keeps  a copy of the button face in each state  in
+ *                     a  pixmap so redrawing a button when it is  pressed
+ *                     or released just copies the pixmap - MT
+ *                   - Uses the common drawing routines - MT
+ *                   - Cached buttons may be held in client side images - MT
+ *                   - Added button_free() - MT
+ *                   - Allocated from the current arena - MT
  *
  * To Do             - Add a new style to handle the type of button used by
  *                     the classic series.
@@ -75,6 +82,8 @@
 #include "x11-calc.h"
 
 #include "x11-calc-colour.h"
+#include "x11-calc-render.h"
+#include "x11-calc-arena.h"
 #include "gcc-debug.h"
 
 /*
@@ -133,7 +142,7 @@ obutton *h_button_create(int i_index, char c_key,
    obutton *h_button; /* Ponter to button. */
 
    /* Attempt to allocate memory for a button. */
-   if ((h_button = malloc (sizeof(*h_button)))==NULL) v_error("Memory allocation failed in %s line : %d\n", __FILE__, __LINE__);
+   h_button = h_arena_alloc(sizeof(*h_button));
 
    h_button->index = i_index;
    h_button->key = c_key;
@@ -156,142 +165,211 @@ obutton *h_button_create(int i_index, char c_key,
    h_button->function_colour = i_function_colour;
    h_button->shifted_colour = i_shifted_colour;
    h_button->label_colour = i_label_colour;
+   h_button->sprite[0] = h_button->sprite[1] = None; /* Created when first needed */
    return(h_button);
 }
 
-/* button_draw (display, window, screen, button) */
+/* button_face (display, drawable, screen, button) - Draws the button itself */
 
-int i_button_draw(Display *h_display, int x_application_window, int i_screen, obutton *h_button) {
+static void v_button_face(Display *h_display, Drawable x_application_window, int i_screen, obutton *h_button) {
 
+   XFontStruct *h_font;
+   unsigned int i_colour;
    int i_indent, i_extent, i_upper, i_lower;
    int i_offset;
 
-   if (h_button != NULL) {
-
-      /* Draw the button background on the window. */
-      XSetForeground(h_display, DefaultGC(h_display, i_screen), DARK_TEXT); /* Set button background colour - as foreground colour! */
-      i_upper = h_button->top;
-      i_lower = h_button->top + h_button->height - 2;
-      i_indent = h_button->left + 1;
-      i_extent = h_button->left + h_button->width - 2;
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent , h_button->top , i_extent, h_button->top); /* Top of background */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent , i_lower, i_extent, i_lower); /* Bottom of background */
-      i_upper++;
-      XFillRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), h_button->left, i_upper , h_button->width, h_button->height - 3); /* Fill in background */
-      i_indent = i_indent + 2;
-      i_extent = i_extent - 2;
+   /* Draw the button background on the window. */
+   i_colour = DARK_TEXT; /* Set button background colour - as foreground colour! */
+   i_upper = h_button->top;
+   i_lower = h_button->top + h_button->height - 2;
+   i_indent = h_button->left + 1;
+   i_extent = h_button->left + h_button->width - 2;
+   v_render_line(h_display, x_application_window, i_colour, i_indent , h_button->top , i_extent, h_button->top); /* Top of background */
+   v_render_line(h_display, x_application_window, i_colour, i_indent , i_lower, i_extent, i_lower); /* Bottom of background */
+   i_upper++;
+   v_render_fill(h_display, x_application_window, i_colour, h_button->left, i_upper , h_button->width, h_button->height - 3); /* Fill in background */
+   i_indent = i_indent + 2;
+   i_extent = i_extent - 2;
+   i_lower++;
+   v_render_line(h_display, x_application_window, i_colour, i_indent , i_lower, i_extent, i_lower); /* Extend bottom of background to make it look more curved */
+
+   /* Draw the button face on the background.  */
+   i_colour = h_button->colour; /* Set the foreground colour. */
+   i_lower = i_lower - 3;
+   v_render_line(h_display, x_application_window, i_colour, i_indent , i_lower, i_extent, i_lower); /* Bottom of button */
+   i_upper = i_upper + 2;
+   v_render_line(h_display, x_application_window, i_colour, i_indent , i_upper, i_extent, i_upper); /* Top edge of button */
+   i_indent--; i_extent++; i_upper++; i_lower--;
+   v_render_fill(h_display, x_application_window, i_colour, i_indent, i_upper, h_button->width - 4, h_button->height - 8 ); /* Fill in button face */
+   i_lower = i_lower + 2;
+   v_render_line(h_display, x_application_window, i_colour, i_indent + 3, i_lower, i_extent -3 , i_lower); /* Extra padding at bottom of button intended to make it look more curved */
+
+   /* Select appropriate colour for high-light (or low-light) depending on button state. */
+   if ((h_button->state)) { /* Set the foreground colour to darker tint of the base colour. */
+      if (((h_button->colour & 0xff) + (h_button->colour >> 8 & 0xff) + (h_button->colour >> 16 & 0xff)) > 384)
+         i_colour = i_shade(h_button->colour);
+   }
+   else  /* Set the foreground colour to lighter tint of the base colour. */
+      i_colour = i_tint(h_button->colour);
+   v_render_line(h_display, x_application_window, i_colour, i_indent , i_lower - 2, i_indent , i_upper); /* Left hand highlight */
+   i_indent++; i_extent--; i_upper--;
+   v_render_line(h_display, x_application_window, i_colour, i_indent , i_upper, i_extent , i_upper); /* Top highlight */
+
+   i_colour = i_tint(h_button->colour); /* Set the foreground colour to lighter tint of the base colour. */
+
+   if (h_button->width < h_button->height)
+      i_offset = h_button->top + KBD_ROW + 2 + (h_button->height - KBD_ROW) / 2; /* Find middle of button. */
+   else
+      i_offset = h_button->top + 2 + h_button->height / 2; /* Find middle of button. */
+
+   if (h_button->style == 0)
+      i_upper = i_upper + (1 + i_offset - i_upper + h_button->text_font->ascent + h_button->text_font->descent) / 2 - h_button->text_font->descent; /* Find vertical position of text */
+   else
+      i_upper = i_offset + (h_button->text_font->ascent + h_button->text_font->descent) / 2 - h_button->text_font->descent - 2; /* Find vertical position of text */
+   i_lower = i_offset + (i_lower - i_offset + h_button->label_font->ascent + h_button->label_font->descent) / 2 - h_button->label_font->descent;
+
+   if ((h_button->state)){ /* Is the button pressed? */
+      i_offset--;
+      i_upper--;
+   }
+   else {
       i_lower++;
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent , i_lower, i_extent, i_lower); /* Extend bottom of background to make it look more curved */
-
-      /* Draw the button face on the background.  */
-      XSetForeground(h_display, DefaultGC(h_display, i_screen), h_button->colour); /* Set the foreground colour. */
-      i_lower = i_lower - 3;
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent , i_lower, i_extent, i_lower); /* Bottom of button */
-      i_upper = i_upper + 2;
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent , i_upper, i_extent, i_upper); /* Top edge of button */
-      i_indent--; i_extent++; i_upper++; i_lower--;
-      XFillRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent, i_upper, h_button->width - 4, h_button->height - 8 ); /* Fill in button face */
-      i_lower = i_lower + 2;
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent + 3, i_lower, i_extent -3 , i_lower); /* Extra padding at bottom of button intended to make it look more curved */
-
-      /* Select appropriate colour for high-light (or low-light) depending on button state. */
-      if ((h_button->state)) { /* Set the foreground colour to darker tint of the base colour. */
-         if (((h_button->colour & 0xff) + (h_button->colour >> 8 & 0xff) + (h_button->colour >> 16 & 0xff)) > 384)
-            XSetForeground(h_display, DefaultGC(h_display, i_screen), i_shade(h_button->colour));
-      }
-      else  /* Set the foreground colour to lighter tint of the base colour. */
-         XSetForeground(h_display, DefaultGC(h_display, i_screen), i_tint(h_button->colour));
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent , i_lower - 2, i_indent , i_upper); /* Left hand highlight */
-      i_indent++; i_extent--; i_upper--;
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent , i_upper, i_extent , i_upper); /* Top highlight */
-
-      XSetForeground(h_display, DefaultGC(h_display, i_screen), i_tint(h_button->colour)); /* Set the foreground colour to lighter tint of the base colour. */
-
-      if (h_button->width < h_button->height)
-         i_offset = h_button->top + KBD_ROW + 2 + (h_button->height - KBD_ROW) / 2; /* Find middle of button. */
-      else
-         i_offset = h_button->top + 2 + h_button->height / 2; /* Find middle of button. */
-
-      if (h_button->style == 0)
-         i_upper = i_upper + (1 + i_offset - i_upper + h_button->text_font->ascent + h_button->text_font->descent) / 2 - h_button->text_font->descent; /* Find vertical position of text */
-      else
-         i_upper = i_offset + (h_button->text_font->ascent + h_button->text_font->descent) / 2 - h_button->text_font->descent - 2; /* Find vertical position of text */
-      i_lower = i_offset + (i_lower - i_offset + h_button->label_font->ascent + h_button->label_font->descent) / 2 - h_button->label_font->descent;
-
-      if ((h_button->state)){ /* Is the button pressed? */
-         i_offset--;
-         i_upper--;
-      }
-      else {
-         i_lower++;
-      }
+   }
 
-      if (h_button->style == 0)
-         XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent , i_offset, i_extent , i_offset); /* Horizontal highlight. */
+   if (h_button->style == 0)
+      v_render_line(h_display, x_application_window, i_colour, i_indent , i_offset, i_extent , i_offset); /* Horizontal highlight. */
 
-      /* Set text foreground colour based on the the brightness of the button colour and font. */
-      if (((h_button->colour & 0xff) + (h_button->colour >> 8 & 0xff) + (h_button->colour >> 16 & 0xff))  > 384)
-         XSetForeground(h_display, DefaultGC(h_display, i_screen), DARK_TEXT);
-      else
-         XSetForeground(h_display, DefaultGC(h_display, i_screen), LIGHT_TEXT);
+   /* Set text foreground colour based on the the brightness of the button colour and font. */
+   if (((h_button->colour & 0xff) + (h_button->colour >> 8 & 0xff) + (h_button->colour >> 16 & 0xff))  > 384)
+      i_colour = DARK_TEXT;
+   else
+      i_colour = LIGHT_TEXT;
 
-      XSetFont(h_display, DefaultGC(h_display, i_screen), h_button->text_font->fid); /* Set the text font. */
-      if (h_button->width < h_button->height)
-      {
-         int i_count;
-         i_indent = 1 + h_button->left + (h_button->width - XTextWidth(h_button->text_font, h_button->text, 1)) / 2; /* Find position of the text. */
-         if (strlen(h_button->text) > 1)
-            i_upper = i_upper - ((h_button->text_font->ascent ) * (strlen(h_button->text) - 1)) / 2;
-
-         for (i_count = 0; i_count < (strlen(h_button->text)); i_count++)
-         {
-            XDrawString(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent, i_upper ,&h_button->text[i_count], 1); /* Draw the main text. */
-            i_upper += h_button->text_font->ascent;
-         }
-      }
-      else
+   h_font = h_button->text_font; /* Set the text font. */
+   if (h_button->width < h_button->height)
+   {
+      int i_count;
+      i_indent = 1 + h_button->left + (h_button->width - XTextWidth(h_button->text_font, h_button->text, 1)) / 2; /* Find position of the text. */
+      if (strlen(h_button->text) > 1)
+         i_upper = i_upper - ((h_button->text_font->ascent ) * (strlen(h_button->text) - 1)) / 2;
+
+      for (i_count = 0; i_count < (strlen(h_button->text)); i_count++)
       {
-         i_indent = 1 + h_button->left + (h_button->width - XTextWidth(h_button->text_font, h_button->text, strlen(h_button->text))) / 2; /* Find position of the text. */
-         XDrawString(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent, i_upper ,h_button->text, strlen(h_button->text)); /* Draw the main text. */
+         v_render_text(h_display, x_application_window, i_colour, h_font, i_indent, i_upper ,&h_button->text[i_count], 1); /* Draw the main text. */
+         i_upper += h_button->text_font->ascent;
       }
+   }
+   else
+   {
+      i_indent = 1 + h_button->left + (h_button->width - XTextWidth(h_button->text_font, h_button->text, strlen(h_button->text))) / 2; /* Find position of the text. */
+      v_render_text(h_display, x_application_window, i_colour, h_font, i_indent, i_upper ,h_button->text, strlen(h_button->text)); /* Draw the main text. */
+   }
+
+   i_colour = h_button->label_colour; /* Draw label text */
+   if (!strlen(h_button->alternate))
+      i_colour = h_button->shifted_colour; /* No alternate function defined so use the alternate function colour for the label */
+   h_font = h_button->label_font; /* Select the label text font */
+   i_indent = 1 + h_button->left + (h_button->width - XTextWidth(h_button->label_font, h_button->label, strlen(h_button->label))) / 2; /* Find position of the label text */
+   v_render_text(h_display, x_application_window, i_colour, h_font, i_indent, i_lower, h_button->label, strlen(h_button->label)); /* Draw the label text */
+}
 
-      XSetForeground(h_display, DefaultGC(h_display, i_screen), h_button->label_colour); /* Draw label text */
-      if (!strlen(h_button->alternate))
-         XSetForeground(h_display, DefaultGC(h_display, i_screen), h_button->shifted_colour); /* No alternate function defined so use the alternate function colour for the label */
-      XSetFont(h_display, DefaultGC(h_display, i_screen), h_button->label_font->fid); /* Select the label text font */
-      i_indent = 1 + h_button->left + (h_button->width - XTextWidth(h_button->label_font, h_button->label, strlen(h_button->label))) / 2; /* Find position of the label text */
-      XDrawString(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent, i_lower, h_button->label, strlen(h_button->label)); /* Draw the label text */
+/* button_function (display, drawable, screen, button) - Draws the function text next to the button */
 
-      /* Draw function */
-      if (strlen(h_button->alternate))
-      {
-         XSetFont(h_display, DefaultGC(h_display, i_screen), h_button->function_font->fid); /* Select the function text font */
-         XSetForeground(h_display, DefaultGC(h_display, i_screen), h_button->shifted_colour); /* Use the function text colour */
-         i_indent = 3 + h_button->left + (h_button->width / 2)
-            + (XTextWidth(h_button->function_font, h_button->function, strlen(h_button->function)) + XTextWidth(h_button->function_font, h_button->alternate, strlen(h_button->alternate))) / 2
-            - XTextWidth(h_button->function_font, h_button->alternate, strlen(h_button->alternate)); /* Find position of the alternate text. */
+static void v_button_function(Display *h_display, Drawable x_application_window, int i_screen, obutton *h_button) {
+
+   XFontStruct *h_font;
+   unsigned int i_colour;
+   int i_indent, i_upper;
+
+   /* Draw function */
+   if (strlen(h_button->alternate))
+   {
+      h_font = h_button->function_font; /* Select the function text font */
+      i_colour = h_button->shifted_colour; /* Use the function text colour */
+      i_indent = 3 + h_button->left + (h_button->width / 2)
+         + (XTextWidth(h_button->function_font, h_button->function, strlen(h_button->function)) + XTextWidth(h_button->function_font, h_button->alternate, strlen(h_button->alternate))) / 2
+         - XTextWidth(h_button->function_font, h_button->alternate, strlen(h_button->alternate)); /* Find position of the alternate text. */
 #ifdef HP67
-         i_upper = h_button->top + h_button->height + h_button->function_font->ascent + 1; /* Draw the function text 1 pixel below button */
+      i_upper = h_button->top + h_button->height + h_button->function_font->ascent + 1; /* Draw the function text 1 pixel below button */
 #else
-         i_upper = h_button->top - (h_button->function_font->descent + 1); /* Draw the function text 1 pixel above button */
+      i_upper = h_button->top - (h_button->function_font->descent + 1); /* Draw the function text 1 pixel above button */
 #endif
-         XDrawString(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent, i_upper ,h_button->alternate, strlen(h_button->alternate)); /* Draw the function text */
-         XSetForeground(h_display, DefaultGC(h_display, i_screen), h_button->function_colour); /* Use the function text colour */
-         i_indent = i_indent - 2 - XTextWidth(h_button->function_font, h_button->function, strlen(h_button->function)); /* Find position of the function text. */
-      }
-      else
-      {
-         XSetForeground(h_display, DefaultGC(h_display, i_screen), h_button->function_colour); /* Use the function text colour */
-         XSetFont(h_display, DefaultGC(h_display, i_screen), h_button->function_font->fid); /* Select the function text font */
-         i_indent = 1 + h_button->left + (h_button->width - XTextWidth(h_button->function_font, h_button->function, strlen(h_button->function))) / 2; /* Find position of the function text. */
+      v_render_text(h_display, x_application_window, i_colour, h_font, i_indent, i_upper ,h_button->alternate, strlen(h_button->alternate)); /* Draw the function text */
+      i_colour = h_button->function_colour; /* Use the function text colour */
+      i_indent = i_indent - 2 - XTextWidth(h_button->function_font, h_button->function, strlen(h_button->function)); /* Find position of the function text. */
+   }
+   else
+   {
+      i_colour = h_button->function_colour; /* Use the function text colour */
+      h_font = h_button->function_font; /* Select the function text font */
+      i_indent = 1 + h_button->left + (h_button->width - XTextWidth(h_button->function_font, h_button->function, strlen(h_button->function))) / 2; /* Find position of the function text. */
 #ifdef HP67
-         i_upper = h_button->top + h_button->height + h_button->function_font->ascent + 1; /* Draw the function text 1 pixel below button */
+      i_upper = h_button->top + h_button->height + h_button->function_font->ascent + 1; /* Draw the function text 1 pixel below button */
 #else
-         i_upper = h_button->top - (h_button->function_font->descent + 1); /* Draw the function text 1 pixel above button */
+      i_upper = h_button->top - (h_button->function_font->descent + 1); /* Draw the function text 1 pixel above button */
 #endif
-      }
-      XDrawString(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent, i_upper ,h_button->function, strlen(h_button->function)); /* Draw the function text */
+   }
+   v_render_text(h_display, x_application_window, i_colour, h_font, i_indent, i_upper ,h_button->function, strlen(h_button->function)); /* Draw the function text */
+}
+
+/* button_draw (display, window, screen, button) */
 
+int i_button_draw(Display *h_display, int x_application_window, int i_screen, obutton *h_button) {
+
+   if (h_button != NULL) {
+      v_button_face(h_display, x_application_window, i_screen, h_button);
+      v_button_function(h_display, x_application_window, i_screen, h_button);
+      v_render_flush(h_display);
+   }
+   return(True);
+}
+
+/*
+ * button_redraw (display, window, screen, button)
+ *
+ * Redraws  the  button  in its current state (but not the  function  text
+ * which  doesn't change) by copying it from a pixmap.  The pixmap for each
+ * state is drawn the first time that it is needed.
+ *
+ */
+
+int i_button_redraw(Display *h_display, int x_application_window, int i_screen, obutton *h_button) {
+
+   obutton h_sprite;
+   int i_state;
+
+   if (h_button != NULL) {
+      i_state = (h_button->state != 0);
+      if (h_button->sprite[i_state] == None)
+      {
+         h_button->sprite[i_state] = x_render_create(h_display, x_application_window, h_button->width, h_button->height);
+         v_render_fill(h_display, h_button->sprite[i_state], BACKGROUND, 0, 0, h_button->width, h_button->height); /* The corners of the button show the background */
+         h_sprite = *h_button;
+         h_sprite.left = 0;
+         h_sprite.top = 0;
+         v_button_face(h_display, h_button->sprite[i_state], i_screen, &h_sprite);
+         v_render_flush(h_display);
+      }
+      v_render_copy(h_display, h_button->sprite[i_state], x_application_window, 0, 0,
+         h_button->width, h_button->height, h_button->left, h_button->top);
    }
    return(True);
 }
+
+/*
+ * button_free (display, button)
+ *
+ * Frees  the  pixmaps holding the copies of the button (the button itself
+ * is released with the arena).
+ *
+ */
+
+void v_button_free(Display *h_display, obutton *h_button) {
+
+   int i_state;
+
+   if (h_button != NULL) {
+      for (i_state = 0; i_state < 2; i_state++)
+         if (h_button->sprite[i_state] != None) v_render_free(h_display, h_button->sprite[i_state]);
+   }
+}
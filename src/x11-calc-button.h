@@ -28,6 +28,9 @@
  *                     function text to be defined - MT
  * 06 Dec 21         - Label text colour now explicitly defined to allow it
  *                     to be different from the main text colour- MT
+ * 17 Oct 26         - Added pixmaps to hold a copy of the button in each
+ *                     state - MT
+ *                   - Added button_free() - MT
  */
 
 typedef struct { /* Calculator button structure. */
@@ -50,6 +53,7 @@ typedef struct { /* Calculator button structure. */
    unsigned int function_colour;  /* Function key colour */
    unsigned int shifted_colour; /* Alternate function key colour */
    unsigned int label_colour; /* Shifted function key colour */
+   Pixmap sprite[2]; /* Copy of the button when released and pressed */
 } obutton;
 
 obutton *h_button_key_pressed(obutton *h_button, char c_key);
@@ -65,3 +69,7 @@ obutton *h_button_create(int i_index, char c_key,
    unsigned int i_shifted_colour, unsigned int i_label_colour);
 
 int i_button_draw(Display *h_display, int x_application_window, int i_screen,obutton *h_button);
+
+int i_button_redraw(Display *h_display, int x_application_window, int i_screen,obutton *h_button);
+
+void v_button_free(Display *h_display, obutton *h_button);
@@ -0,0 +1,700 @@
+/*
+ * x11-calc-classic.c - RPN (Reverse Polish) calculator simulator.
+ *
+ * Copyright(C) 2018   MT
+ *
+ * Classic processor simulator.
+ *
+ * Decodes  and  executes  the instructions  used  by  the  Classic
+ * series (HP35, HP80, HP45, HP70 and HP55).
+ *
+ * This  program is free software: you can redistribute it and/or modify it
+ * under  the terms of the GNU General Public License as published  by  the
+ * Free  Software Foundation, either version 3 of the License, or (at  your
+ * option) any later version.
+ *
+ * This  program  is distributed in the hope that it will  be  useful,  but
+ * WITHOUT   ANY   WARRANTY;   without even   the   implied   warranty   of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You  should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * 17 Oct 26         - Initial version (moved from x11-calc-cpu.c) - MT
+ *
+ */
+
+#define NAME           "x11-calc-classic"
+#define VERSION        "0.1"
+#define BUILD          "0001"
+#define DATE           "17 Oct 26"
+#define AUTHOR         "MT"
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+
+#include "x11-calc-font.h"
+#include "x11-calc-label.h"
+#include "x11-calc-switch.h"
+#include "x11-calc-button.h"
+
+#include "x11-calc-cpu.h"
+#include "x11-calc-arena.h"
+
+#include "x11-calc-messages.h"
+
+#include "gcc-debug.h" /* print() */
+#include "gcc-wait.h"  /* i_wait() */
+
+#if defined(HP35) || defined(HP80) || defined(HP45) || defined(HP70) || defined(HP55)
+
+static void v_op_inc_p(oprocessor *h_processor) /* Increment p register */
+{
+   h_processor->p++;
+   h_processor->p &= 15;
+}
+
+static void v_op_dec_p(oprocessor *h_processor) /* Decrement p register */
+{
+   h_processor->p--;
+   h_processor->p &= 15;
+}
+
+static void v_op_inc_pc(oprocessor *h_processor) /* Increment program counter */
+{
+   h_processor->pc = ((h_processor->pc >> 8) << 8) | ((h_processor->pc + 1) & 0xff); /* Address wraps round at end of ROM */
+   h_processor->flags[PREV_CARRY] = h_processor->flags[CARRY];
+   h_processor->flags[CARRY] = False;
+}
+
+static void v_delayed_rom(oprocessor *h_processor) /* Delayed ROM select */
+{
+   if (h_processor->flags[DELAYED_ROM])
+   {
+      h_processor->pc = (h_processor->rom_number << 8 | (h_processor->pc & 0xf0ff));
+      h_processor->flags[DELAYED_ROM] = False; /* Clear flag */
+   }
+   if (h_processor->pc < 0x1400) h_processor->pc &= 0xfff; /* The first ROM chip is mapped to all ROM banks, access implies a switch to bank 0 */
+}
+
+void op_jsb(oprocessor *h_processor, int i_address) /* Jump to subroutine */
+{
+   h_processor->stack[h_processor->sp] = h_processor->pc; /* Push current address on the stack */
+   h_processor->sp = (h_processor->sp + 1) & (STACK_SIZE - 1); /* Update stack pointer */
+   h_processor->pc = ((h_processor->pc & 0xff00) | i_address); /* Note - Uses an eight bit address */
+   v_delayed_rom(h_processor);
+}
+
+void v_op_goto(oprocessor *h_processor) /* Conditional go to */
+{
+   if (h_processor->trace)
+   {
+      fprintf(stdout, "\n"); fprintf(stdout,h_msg_opcode, (h_processor->pc >> 12), (h_processor->pc & 0x0fff), h_processor->rom[h_processor->pc]);
+      fprintf(stdout,"  then go to ");
+   }
+   h_processor->flags[PREV_CARRY] = h_processor->flags[CARRY];
+   h_processor->flags[CARRY] = False;
+   if (h_processor->trace) fprintf(stdout, h_msg_address, (h_processor->pc & 0xf00) | (h_processor->rom[h_processor->pc]) >> 2); /* Mask off the bank number and least significant 8 bits*/
+   if (h_processor->flags[PREV_CARRY])  /* Do if True */
+      h_processor->pc = (h_processor->pc & 0xff00) | h_processor->rom[h_processor->pc] >> 2; /* Classic CPU uses a _eight_ bit address */
+   else
+      v_op_inc_pc(h_processor);
+}
+
+void v_processor_execute(oprocessor *h_processor) /* Decode and execute a single instruction */
+{
+
+   unsigned int i_last; /* Save the current PC */
+   unsigned int i_opcode;
+   unsigned int i_field; /* Field modifier */
+   const char *s_field; /* Holds pointer to field name */
+
+   /* TIMER : status[11] = 1, status[3] = 0
+    * PRGM  : status[11] = 0, status[3] = 1
+    * RUN   : status[11] = 0, status[3] = 0 */
+   if (h_processor->keypressed) h_processor->status[0] = True; /* Set status bit 0 if key pressed */
+   if (h_processor->mode) h_processor->status[3] = True; /* Set status bits based on switch position */
+   if (h_processor->timer) h_processor->status[11] = True;
+
+   i_opcode = h_processor->rom[h_processor->pc]; /* Get next instruction */
+   i_last = h_processor->pc;
+   if (h_processor->trace)
+      fprintf(stdout, h_msg_opcode, (i_last >> 12), (i_last & 0x0fff), h_processor->rom[i_last]);
+   v_op_inc_pc(h_processor); /* Increment program counter _before_ decoding the opcode */
+   switch (i_opcode & 03)
+   {
+
+   case 00: /* Type 0 - Special operations */
+      switch ((i_opcode >> 2) & 03)
+      {
+      case 00: /* Op-Codes matching x xxx xx 00 00 */
+         switch ((i_opcode >> 4) & 03)
+         {
+         case 00:  /* Op-Codes matching x xxx 000 000 */
+            switch (i_opcode)
+            {
+            case 00000: /* nop */
+               if (h_processor->trace) fprintf(stdout, "nop");
+               break;
+            default:
+               if (h_processor->trace) fprintf(stdout, "\n");
+               v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+            }
+            break;
+         case 01: /* Op-Codes matching x xxx 010 000 */
+            switch ((i_opcode >> 6) & 01)
+            {
+            case 00: /* Op-Codes matching x xx0 010 000 */ /* select rom */
+               if (h_processor->trace) fprintf(stdout, "select rom %02o", i_opcode >> 7); /* Note - Not the same as the Woodstock CPU */
+               h_processor->pc = ((i_opcode >> 7) << 8) + ((h_processor->pc) & 0xff);
+               break;
+            case 01: /* keys -> rom address */
+               if (h_processor->trace) fprintf(stdout, "keys -> rom address");
+               h_processor->pc &= 0xff00;
+               v_delayed_rom(h_processor);
+               h_processor->pc += h_processor->code;
+               break;
+            default:
+               if (h_processor->trace) fprintf(stdout, "\n");
+               v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+            }
+            break;
+         case 02: /* Op-Codes matching x xxx 100 000 */
+            switch (i_opcode)
+            {
+            case 0:
+               break;
+            default:
+               if (h_processor->trace) fprintf(stdout, "\n");
+               v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+            }
+            break;
+         case 03: /* Op-Codes matching x xxx 110 000 */
+            switch (i_opcode)
+            {
+            case 00060: /* return */
+               if (h_processor->trace) fprintf(stdout, "return");
+               h_processor->sp = (h_processor->sp - 1) & (STACK_SIZE - 1); /* Update stack pointer */
+               h_processor->pc = (h_processor->pc & (~0xff)) + (h_processor->stack[h_processor->sp] & 0xff); /* Pop program counter from the stack */
+               break;
+            case 01160: /* c -> data address */
+               {
+                  int i_addr;
+                  if (h_processor->trace) fprintf(stdout, "c -> data address\t");
+                  i_addr = h_processor->reg[C_REG]->nibble[12];
+                  h_processor->addr = i_addr;
+                  if (i_addr < MEMORY_SIZE)
+                     h_processor->addr = i_addr;
+                  else {
+                     h_processor->addr = MEMORY_SIZE - 1;
+                  }
+               }
+               if (h_processor->trace) fprintf(stdout, "addr = %d", h_processor->addr);
+               break;
+            case 01360: /* c -> data */
+               if (h_processor->trace) fprintf(stdout, "c -> data\t\t");
+               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+               if (h_processor->addr < MEMORY_SIZE)
+                  v_reg_copy(h_processor, h_processor->mem[h_processor->addr], h_processor->reg[C_REG]);
+               else
+               {
+                  if (h_processor->trace) fprintf(stdout, "\n");
+                  v_error(h_err_invalid_register, h_processor->addr, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+               }
+               if (h_processor->trace) v_fprint_register(stdout,h_processor->mem[h_processor->addr]);
+               break;
+            default:
+               if (h_processor->trace) fprintf(stdout, "\n");
+               v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+            }
+            break;
+         }
+         break;
+      case 01: /* Op-Codes matching x xxx xx 01 00 */
+         switch ((i_opcode >> 4) & 03)
+         {
+         case 00: /* 1 -> s(n) */
+            if (h_processor->trace) fprintf(stdout, "1 -> s(%d)\t\t", i_opcode >> 6);
+            h_processor->status[i_opcode >> 6] = True;
+            if (h_processor->trace) v_fprint_status(stdout, h_processor);
+            break;
+         case 01: /* if 0 = s(n) */
+            if (h_processor->trace) fprintf(stdout, "if 0 = s(%d) ", i_opcode >> 6);
+            h_processor->flags[CARRY] = !h_processor->status[i_opcode >> 6];
+            v_op_goto(h_processor);
+            break;
+         case 02: /* 0 -> s(n) */
+            if (h_processor->trace) fprintf(stdout, "0 -> s(%d)\t\t", i_opcode >> 6);
+            h_processor->status[i_opcode >> 6] = False;
+            if (h_processor->trace) v_fprint_status(stdout, h_processor);
+            break;
+         case 03: /* delayed select rom n */
+            switch (i_opcode)
+            {
+            case 00064: /* clear status */
+               if (h_processor->trace) fprintf(stdout, "clear status\t");
+               {
+                  int i_count;
+                  for (i_count = 0; i_count < sizeof(h_processor->status) / sizeof(*h_processor->status); i_count++)
+                     h_processor->status[i_count] = False; /* Clear all bits */
+               }
+               if (h_processor->trace) v_fprint_status(stdout, h_processor);
+               break;
+            case 01064: /*delayed select */
+            case 01264: /*delayed select */
+               if (h_processor->trace) fprintf(stdout, "\n");
+               v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+               break;
+            default: /* delayed select rom n */
+               if (h_processor->trace) fprintf(stdout, "delayed select rom %d", i_opcode >> 7); /* Note - Not the same as the Woodstock CPU */
+               h_processor->rom_number = i_opcode >> 7;
+               h_processor->flags[DELAYED_ROM] = True;
+            }
+            break;
+         }
+         break;
+
+      case 02: /* Op-Codes matching x xx xx 10 00 */
+         switch ((i_opcode >> 4) & 03)
+         {
+         case 01: /* Op-Codes matching xx xx 01 10 00 */ /* load constant n */
+            if (h_processor->trace) fprintf(stdout, "load constant %d\t", i_opcode >> 6);
+            h_processor->reg[C_REG]->nibble[h_processor->p] = i_opcode >> 6;
+            v_op_dec_p(h_processor);
+            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+            break;
+         case 02: /* Op-Codes matching x xx 10 10 00 */
+            switch (i_opcode)
+            {
+            case 00050: /* display toggle */
+               if (h_processor->trace) fprintf(stdout, "display toggle");
+               h_processor->flags[DISPLAY_ENABLE] = (!h_processor->flags[DISPLAY_ENABLE]);
+               break;
+            case 00250: /* m exch c */
+               if (h_processor->trace) fprintf(stdout, "m exch c\t\t");
+               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+               v_reg_exch(h_processor, h_processor->reg[M_REG], h_processor->reg[C_REG]);
+               if (h_processor->trace)
+               {
+                  v_fprint_register(stdout,h_processor->reg[C_REG]);
+                  v_fprint_register(stdout,h_processor->reg[M_REG]);
+               }
+               break;
+            case 00450: /* c -> stack */
+               if (h_processor->trace) fprintf(stdout, "c -> stack\t\t");
+                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+                  v_reg_copy(h_processor, h_processor->reg[T_REG], h_processor->reg[Z_REG]); /* T = Z */
+                  v_reg_copy(h_processor, h_processor->reg[Z_REG], h_processor->reg[Y_REG]); /* T = Z */
+                  v_reg_copy(h_processor, h_processor->reg[Y_REG], h_processor->reg[C_REG]); /* T = Z */
+                  if (h_processor->trace)
+                  {
+                     v_fprint_register(stdout,h_processor->reg[Y_REG]);
+                     v_fprint_register(stdout,h_processor->reg[Z_REG]);
+                     v_fprint_register(stdout,h_processor->reg[T_REG]);
+                  }
+               break;
+            case 00650: /* stack -> a */
+               if (h_processor->trace) fprintf(stdout, "stack -> a\t\t");
+                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+                  v_reg_copy(h_processor, h_processor->reg[A_REG], h_processor->reg[Y_REG]); /* T = Z */
+                  v_reg_copy(h_processor, h_processor->reg[Y_REG], h_processor->reg[Z_REG]); /* T = Z */
+                  v_reg_copy(h_processor, h_processor->reg[Z_REG], h_processor->reg[T_REG]); /* T = Z */
+                  if (h_processor->trace)
+                  {
+                     v_fprint_register(stdout,h_processor->reg[A_REG]);
+                     v_fprint_register(stdout,h_processor->reg[Y_REG]);
+                     v_fprint_register(stdout,h_processor->reg[Z_REG]);
+                  }
+               break;
+            case 01050: /* display off */
+               if (h_processor->trace) fprintf(stdout, "display off");
+               h_processor->flags[DISPLAY_ENABLE] = False;
+               break;
+            case 01250: /* m -> c */
+               if (h_processor->trace) fprintf(stdout, "m -> c\t\t");
+               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+               v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->reg[M_REG]);
+               if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+               break;
+            case 01450: /* down rotate */
+               if (h_processor->trace) fprintf(stdout, "down rotate\t\t");
+                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+                  v_reg_exch(h_processor, h_processor->reg[T_REG], h_processor->reg[C_REG]); /* T <> C - C to T */
+                  v_reg_exch(h_processor, h_processor->reg[C_REG], h_processor->reg[Y_REG]); /* C <> Y - Y to C */
+                  v_reg_exch(h_processor, h_processor->reg[Y_REG], h_processor->reg[Z_REG]); /* Y <> Z - Z to Y and T ends up in Z */
+                  if (h_processor->trace)
+                  {
+                     v_fprint_register(stdout,h_processor->reg[C_REG]);
+                     v_fprint_register(stdout,h_processor->reg[Y_REG]);
+                     v_fprint_register(stdout,h_processor->reg[Z_REG]);
+                     v_fprint_register(stdout,h_processor->reg[T_REG]);
+                  }
+               break;
+            case 01650: /* clear registers */
+               if (h_processor->trace) fprintf(stdout, "clear registers");
+               {
+                  int i_count;
+                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+                  for (i_count = 0; i_count < REGISTERS - 2; i_count++) /* Don't clear M or N */
+                     v_reg_copy(h_processor, h_processor->reg[i_count], NULL); /* Copying nothing to a register clears it */
+               }
+               break;
+            default:
+               if (h_processor->trace) fprintf(stdout, "\n");
+               v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+            }
+            break;
+         case 03: /* Op-Codes matching x xx 10 10 00 */
+            switch (i_opcode)
+            {
+            case 01360: /* c -> data */
+               if (h_processor->trace) fprintf(stdout, "c -> data\t\t");
+               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+               if (h_processor->addr < MEMORY_SIZE)
+                  v_reg_copy(h_processor, h_processor->mem[h_processor->addr], h_processor->reg[C_REG]);
+               else
+               {
+                  if (h_processor->trace) fprintf(stdout, "\n");
+                  v_error(h_err_invalid_register, h_processor->addr, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+               }
+               if (h_processor->trace) v_fprint_register(stdout,h_processor->mem[h_processor->addr]);
+               break;
+            case 01370: /* data -> c */
+               if (h_processor->trace) fprintf(stdout, "data -> c\t\t");
+               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+               v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->mem[h_processor->addr]);
+               if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+               break;
+            default:
+               if (h_processor->trace) fprintf(stdout, "\n");
+               v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+            }
+            break;
+         default:
+            if (h_processor->trace) fprintf(stdout, "\n");
+            v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         break;
+
+      case 03: /* Op-Codes matching xx xx xx 11 00 */
+         switch ((i_opcode >> 4) & 03)
+         {
+         case 00: /* Op-Codes matching xx xx 00 11 00 */ /* n -> p */
+            if (h_processor->trace) fprintf(stdout, "%d -> p", i_opcode >> 6);
+            h_processor->p = i_opcode >> 6;
+            break;
+         case 01: /* Op-Codes matching xx xx 01 11 00 */ /* p - 1 -> p */
+            if (h_processor->trace) fprintf(stdout, "p - 1 -> p");
+            v_op_dec_p(h_processor);
+            break;
+         case 02: /* Op-Codes matching xx xx 10 11 00 */ /* if p != n */
+            if (h_processor->trace) fprintf(stdout, "if p != %d", i_opcode >> 6);
+            h_processor->flags[CARRY] = (h_processor->p != i_opcode >> 6);
+            v_op_goto(h_processor);
+            break;
+         case 03: /* Op-Codes matching xx xx 11 11 00 */ /* p + 1 -> p */
+            if (h_processor->trace) fprintf(stdout, "p + 1 -> p");
+            v_op_inc_p(h_processor);
+            break;
+         default:
+            if (h_processor->trace) fprintf(stdout, "\n");
+            v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         break;
+      default:
+         if (h_processor->trace) fprintf(stdout, "\n");
+         v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+      }
+      break;
+
+   case 01: /* Type 1 - Jump subroutine */
+      if (h_processor->trace) {fprintf(stdout, "jsb "); fprintf(stdout, h_msg_address, ((h_processor->pc & 0x0f00) | i_opcode >> 2));}
+      op_jsb(h_processor, (i_opcode >> 2)); /* Note - uses and eight bit address */
+      break;
+
+   case 02: /* Type 2 - Arithmetic operations */
+      i_field = (i_opcode >> 2) & 7;
+      switch (i_field) /* Select field
+         000   P  : determined by P                   [P]
+         001   M  : mantissa                          [3 .. 12]
+         010   X  : exponent                          [0 ..  1]
+         011   W  : word                              [0 .. 13]
+         100  WP  : word up to and including P        [0 ..  P]
+         101  MS  : mantissa and sign                 [3 .. 13]
+         110  XS  : exponent sign                     [2]
+         111   S  : sign                              [13] */
+      {
+      case 00: /* P */
+         s_field = "p";
+         h_processor->first = h_processor->p; h_processor->last = h_processor->p;
+         if (h_processor->p >= REG_SIZE)
+         {
+            if (h_processor->trace) fprintf(stdout, "\n");
+            v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         break;
+      case 01: /* M */
+         s_field = "m";
+         h_processor->first = EXP_SIZE; h_processor->last = REG_SIZE - 2;
+         break;
+      case 02: /* X */
+         s_field = "x";
+         h_processor->first = 0; h_processor->last = EXP_SIZE - 1;
+         break;
+      case 03: /* W */
+         s_field = "w";
+         h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+         break;
+      case 04: /* WP */
+         s_field = "wp";
+         h_processor->first =  0; h_processor->last =  h_processor->p; /* break; bug in orig??? */
+         if (h_processor->p >= REG_SIZE)
+         {
+            if (h_processor->trace) fprintf(stdout, "\n");
+            v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         break;
+      case 05: /* MS */
+         s_field = "ms";
+         h_processor->first = EXP_SIZE; h_processor->last = REG_SIZE - 1;
+         break;
+      case 06: /* XS */
+         s_field = "xs";
+         h_processor->first = EXP_SIZE - 1; h_processor->last = EXP_SIZE - 1;
+         break;
+      case 07: /* S */
+         s_field = "s";
+         h_processor->first = REG_SIZE - 1; h_processor->last = REG_SIZE - 1;
+         break;
+      }
+
+      switch (i_opcode >> 5)
+      {
+      case 000: /* if b[f] = 0 */
+         if (h_processor->trace) fprintf(stdout, "if b[%s] = 0", s_field);
+         v_reg_test_eq(h_processor, h_processor->reg[B_REG], NULL);
+         v_op_goto(h_processor);
+         break;
+      case 001: /* 0 -> b[f] */
+         if (h_processor->trace)fprintf(stdout, "0 -> b[%s]\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[B_REG], NULL);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
+         break;
+      case 002: /* if a >= c[f] */
+         if (h_processor->trace) fprintf(stdout, "if a >= c[%s]", s_field);
+         v_reg_sub(h_processor, NULL, h_processor->reg[A_REG], h_processor->reg[C_REG]); /* Less than */
+         h_processor->flags[CARRY] = !h_processor->flags[CARRY];
+         v_op_goto(h_processor);
+         break;
+      case 003: /* if c[f] != 0 */
+         if (h_processor->trace) fprintf(stdout, "if c[%s] != 0", s_field);
+         v_reg_test_ne(h_processor, h_processor->reg[C_REG], NULL);
+         v_op_goto(h_processor);
+         break;
+      case 004: /* b -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "b -> c[%s]\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->reg[B_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
+         break;
+      case 005: /* 0 - c -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "0 - c -> c[%s]", s_field);
+         v_reg_sub(h_processor, h_processor->reg[C_REG], NULL, h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 006: /* 0 -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "0 -> c[%s]\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[C_REG], NULL);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 007: /* 0 - c - 1 -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "0 - c - 1 -> c[%s]\t\t", s_field);
+         h_processor->flags[CARRY] = True; /* Set carry */
+         v_reg_sub(h_processor, h_processor->reg[C_REG], NULL, h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 010: /* shift left a[f] */
+         if (h_processor->trace) fprintf(stdout, "shift left a[%s]\t\t", s_field);
+         v_reg_shl(h_processor, h_processor->reg[A_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
+         break;
+      case 011: /* a -> b[f] */
+         if (h_processor->trace) fprintf(stdout, "a -> b[%s]\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[B_REG], h_processor->reg[A_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
+         break;
+      case 012: /* a - c -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "a - c -> c[%s]\t\t", s_field);
+         v_reg_sub(h_processor, h_processor->reg[C_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 013: /* c - 1 -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "c - 1 -> c[%s]\t\t", s_field);
+         h_processor->flags[CARRY] = True; /* Set carry */
+         v_reg_sub(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], NULL);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 014: /* c -> a[f] */
+         if (h_processor->trace) fprintf(stdout, "c -> a[%s]\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[A_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 015: /* if c[f] = 0 */
+         if (h_processor->trace) fprintf(stdout, "if c[%s] = 0", s_field);
+         v_reg_test_eq(h_processor, h_processor->reg[C_REG], NULL);
+         v_op_goto(h_processor);
+         break;
+      case 016: /* a + c -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "a + c -> c[%s]\t\t", s_field);
+         v_reg_add(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], h_processor->reg[A_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 017: /* c + 1 -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "c + 1 -> c[%s]\t\t", s_field);
+         v_reg_inc(h_processor, h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 020: /* if a >= b[f] */
+         if (h_processor->trace) fprintf(stdout, "if a >= b[%s]", s_field);
+         v_reg_sub(h_processor, NULL, h_processor->reg[A_REG], h_processor->reg[B_REG]); /* Less than */
+         h_processor->flags[CARRY] = !h_processor->flags[CARRY];
+         v_op_goto(h_processor);
+         break;
+      case 021: /* b exchange c[f] */
+         if (h_processor->trace) fprintf(stdout, "b exch c[%s]\t\t", s_field);
+         v_reg_exch(h_processor, h_processor->reg[B_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace)
+         {
+            v_fprint_register(stdout,h_processor->reg[B_REG]);
+            v_fprint_register(stdout,h_processor->reg[C_REG]);
+         }
+         break;
+      case 022: /* shift right c[f] */
+         if (h_processor->trace) fprintf(stdout, "shift right c[%s]\t", s_field);
+         v_reg_shr(h_processor, h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 023: /* if a[f] != 0 */
+         if (h_processor->trace) fprintf(stdout, "if a[%s] != 0", s_field);
+         v_reg_test_ne(h_processor, h_processor->reg[A_REG], NULL);
+         v_op_goto(h_processor);
+         break;
+      case 024: /* shift right b[f] */
+         v_reg_shr(h_processor, h_processor->reg[B_REG]);
+         if (h_processor->trace) fprintf(stdout, "shift right b[%s]\t", s_field);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
+         break;
+      case 025: /* c + c -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "c + c -> c[%s]\t", s_field);
+         v_reg_add(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 026: /* shift right a[f] */
+         if (h_processor->trace) fprintf(stdout, "shift right a[%s]\t", s_field);
+         v_reg_shr(h_processor, h_processor->reg[A_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 027: /* 0 -> a[f] */
+         if (h_processor->trace) fprintf(stdout, "0 -> a[%s]\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[A_REG], NULL);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 030: /* a - b -> a[f] */
+         if (h_processor->trace) fprintf(stdout, "a - b -> a[%s]\t", s_field);
+         v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[B_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 031: /* a exch b[f] */
+         if (h_processor->trace) fprintf(stdout, "a exch b[%s]\t", s_field);
+         v_reg_exch(h_processor, h_processor->reg[A_REG], h_processor->reg[B_REG]);
+         if (h_processor->trace)
+         {
+            v_fprint_register(stdout,h_processor->reg[A_REG]);
+            v_fprint_register(stdout,h_processor->reg[B_REG]);
+         }
+         break;
+      case 032: /* a - c -> a[f] */
+         if (h_processor->trace) fprintf(stdout, "a - c -> a[%s]\t", s_field);
+         v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 033: /* a - 1 -> a[f] */
+         if (h_processor->trace) fprintf(stdout, "a - 1 -> a[%s]\t", s_field);
+         h_processor->flags[CARRY] = True; /* Set carry */
+         v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], NULL);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 034: /* a + b -> a[f] */
+         if (h_processor->trace) fprintf(stdout, "a + b -> a[%s]\t", s_field);
+         v_reg_add(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[B_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 035: /* a exch c[f] */
+         if (h_processor->trace) fprintf(stdout, "a exch c[%s]\t\t", s_field);
+         v_reg_exch(h_processor, h_processor->reg[A_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace)
+         {
+            v_fprint_register(stdout,h_processor->reg[A_REG]);
+            v_fprint_register(stdout,h_processor->reg[C_REG]);
+         }
+         break;
+      case 036: /* a + c -> a[a + c -> a[f] */
+         if (h_processor->trace) fprintf(stdout, "a + c -> a[%s]", s_field);
+         v_reg_add(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 037: /* a + 1 -> a[f] */
+         if (h_processor->trace) fprintf(stdout, "a + 1 -> a[%s]", s_field);
+         v_reg_inc(h_processor, h_processor->reg[A_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      default:
+         if (h_processor->trace) fprintf(stdout, "\n");
+         v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+      }
+      break;
+
+   case 03:/* Type 3 - Conditional branch */
+      switch (i_opcode & 03)
+      {
+      case 00:
+         if (h_processor->trace) {fprintf(stdout, "call "); fprintf(stdout, h_msg_address, i_opcode >> 2);}
+         if (h_processor->trace) fprintf(stdout, "\n");
+         v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         break;
+      case 01:
+         if (h_processor->trace) {fprintf(stdout, "call "); fprintf(stdout, h_msg_address, i_opcode >> 2);}
+         if (h_processor->trace) fprintf(stdout, "\n");
+         v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         break;
+      case 02:
+         if (h_processor->trace) {fprintf(stdout, "jump "); fprintf(stdout, h_msg_address, i_opcode >> 2);}
+         if (h_processor->trace) fprintf(stdout, "\n");
+         v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         break;
+      case 03: /* if nc go to */
+         if (h_processor->trace) {fprintf(stdout, "if nc go to "); fprintf(stdout, h_msg_address, ((h_processor->pc & 0x0f00) | i_opcode >> 2));} /* Note - uses and eight bit address */
+         if (!h_processor->flags[PREV_CARRY])
+         {
+            h_processor->pc = (h_processor->pc & 0xff00) | i_opcode >> 2;
+            v_delayed_rom(h_processor);
+         }
+         break;
+      default:
+         if (h_processor->trace) fprintf(stdout, "\n");
+         v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+      }
+      break;
+   default:
+      if (h_processor->trace) fprintf(stdout, "\n");
+      v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+   }
+   if (h_processor->trace) fprintf(stdout, "\n");
+   h_processor->opcode = i_opcode; /* Keep track of the previous opcode so you know when to increment 'P' */
+}
+#endif
@@ -356,6 +356,49 @@
  * 01 May 23         - Corrected default mode setting -
  * 12 Jan 23         - Tidied up some of the processor trace output - MT
  * 06 Jun 23         - Removed unused references to HP91c and HP97 - MT
+ * 17 Oct 26         - Key  presses and releases are queued and passed  on
+ *                     to  the  processor when they are due, so  keys  are
+ *                     never  overwritten  or merged before the  ROM  has
+ *                     seen them however quickly they arrive - MT
+ *                   - The  processor  and  registers are  allocated  from
+ *                     the current arena - MT
+ *                   - Moved  the  instruction decoding for  each  family
+ *                     into a separate file - MT
+ *                   - Continuous  memory  is only saved if it has  changed
+ *                     and  is  written in the background to  a  temporary
+ *                     file which then replaces the data file - MT
+ *                   - Memory  registers can be held in a file  which  is
+ *                     mapped into memory, instead of being saved and then
+ *                     restored from the data file - MT
+ *                   - Counts  writes to the registers used by the display
+ *                     (A and B, or memory registers 9 and 10 on  voyager
+ *                     models) - MT
+ *                   - Data files only hold the memory registers that exist
+ *                     on voyager models, but older files that hold all 256
+ *                     registers can still be read - MT
+ *                   - Reads  and writes HP67 program and data cards  held
+ *                     in a folder - MT
+ *                   - The  data file is written to disk before it replaces
+ *                     the old one - MT
+ *                   - Only saves continuous memory in the background  when
+ *                     the memory registers have changed - MT
+ *                   - Still saves the processor state when memory  is
+ *                     mapped, and checks the version of the mapped file
+ *                     - MT
+ *                   - Builds the ROM page table used to increment the
+ *                     program counter and select the ROM bank - MT
+ *                   - HP67 cards are passed through the card reader a word
+ *                     at a time,  unless turbo mode copies them  straight
+ *                     into memory - MT
+ *                   - New cards are created when they are inserted,  so
+ *                     their name can't be taken before they are written -
+ *                     MT
+ *                   - The background thread no longer exits if it runs
+ *                     out of memory, it stops and leaves the main loop to
+ *                     report the error - MT
+ *                   - Builds the voyager address table when the processor
+ *                     is created, and no longer reads data files holding
+ *                     all 256 registers - MT
  *
  * To Do             - Finish adding code to display any modified registers
  *                     to every instruction.
@@ -370,11 +413,25 @@
 #define DATE           "24 May 22"
 #define AUTHOR         "MT"
 
+#if defined(__linux__) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE /* Declares fdopen() even in strict ANSI mode */
+#endif
+
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdarg.h>
 
+#if defined(unix) || defined(__unix__) || defined(__APPLE__)
+#include <errno.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <dirent.h>
+#endif
+
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
 
@@ -384,13 +441,14 @@
 #include "x11-calc-button.h"
 
 #include "x11-calc-cpu.h"
+#include "x11-calc-arena.h"
 
 #include "x11-calc-messages.h"
 
 #include "gcc-debug.h" /* print() */
 #include "gcc-wait.h"  /* i_wait() */
 
-static void v_fprint_register(FILE *h_file, oregister *h_register) /* Print the contents of a register */
+void v_fprint_register(FILE *h_file, oregister *h_register) /* Print the contents of a register */
 {
    const char c_name[8] = {'A', 'B', 'C', 'Y', 'Z', 'T', 'M', 'N'};
    int i_count;
@@ -407,7 +465,7 @@ static void v_fprint_register(FILE *h_file, oregister *h_register) /* Print the
    }
 }
 
-static void v_fprint_status(FILE *h_file, oprocessor *h_processor) /* Display the current processor status word */
+void v_fprint_status(FILE *h_file, oprocessor *h_processor) /* Display the current processor status word */
 {
    int i_count, i_temp = 0;
    for (i_count = STATUS_BITS - 1; i_count >= 0; i_count--)
@@ -427,7 +485,7 @@ static void v_fprint_flags(FILE *h_file, oprocessor *h_processor) /* Display the
 }
 
 #if defined(HP10)
-static void v_fprint_buffer(FILE *h_file, oprocessor *h_processor) /* Display the current processor flags */
+void v_fprint_buffer(FILE *h_file, oprocessor *h_processor) /* Display the current processor flags */
 {
    static const unsigned char c_charmap[0x40] = {
       ' ', 'Y', '=', '0', 'L', 'M', ' ', '1', 'G', ' ', '>', '2', 'O', 'H', ' ', '3',  /* ' ', ' ', '=', '0', 'L', 'M', '≠', '1', 'G', '¿', '>', '2', 'O', 'H', '≤', '3', */
@@ -500,10 +558,7 @@ oregister *h_register_create(int i_id) /* Create a new register , */
 {
    oregister *h_register; /* Pointer to register */
    int i_count, i_temp;
-   if ((h_register = malloc (sizeof(*h_register))) == NULL)
-   {
-      fprintf(stdout, h_err_register_alloc, __FILE__, __LINE__);
-   }
+   h_register = h_arena_alloc(sizeof(*h_register));
    i_temp = sizeof(h_register->nibble) / sizeof(*h_register->nibble);
    h_register->id = i_id;
    for (i_count = 0; i_count < i_temp; i_count++)
@@ -511,7 +566,16 @@ oregister *h_register_create(int i_id) /* Create a new register , */
    return(h_register);
 }
 
-static void v_reg_exch(oprocessor *h_processor, oregister *h_destination, oregister *h_source) /* Exchange the contents of two registers */
+static void v_reg_written(oprocessor *h_processor, oregister *h_register) /* Count writes to the registers used by the display */
+{
+#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
+   if ((h_register == h_processor->mem[9]) || (h_register == h_processor->mem[10])) h_processor->display++;
+#else
+   if ((h_register == h_processor->reg[A_REG]) || (h_register == h_processor->reg[B_REG])) h_processor->display++;
+#endif
+}
+
+void v_reg_exch(oprocessor *h_processor, oregister *h_destination, oregister *h_source) /* Exchange the contents of two registers */
 {
    int i_count, i_temp;
    for (i_count = h_processor->first; i_count <= h_processor->last; i_count++)
@@ -520,9 +584,11 @@ static void v_reg_exch(oprocessor *h_processor, oregister *h_destination, oregis
       h_destination->nibble[i_count] = h_source->nibble[i_count];
       h_source->nibble[i_count] = i_temp;
    }
+   v_reg_written(h_processor, h_destination);
+   v_reg_written(h_processor, h_source);
 }
 
-static void v_reg_copy(oprocessor *h_processor, oregister *h_destination, oregister *h_source) /* Copy the contents of a register */
+void v_reg_copy(oprocessor *h_processor, oregister *h_destination, oregister *h_source) /* Copy the contents of a register */
 {
    int i_count, i_temp;
    for (i_count = h_processor->first; i_count <= h_processor->last; i_count++)
@@ -530,29 +596,32 @@ static void v_reg_copy(oprocessor *h_processor, oregister *h_destination, oregis
       if (h_source != NULL) i_temp = h_source->nibble[i_count]; else i_temp = 0;
       h_destination->nibble[i_count] = i_temp;
    }
+   v_reg_written(h_processor, h_destination);
 }
 
 #if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
-static void v_reg_or(oprocessor *h_processor, oregister *h_destination, oregister *h_source, oregister *h_argument) /* Or the contents of two registers */
+void v_reg_or(oprocessor *h_processor, oregister *h_destination, oregister *h_source, oregister *h_argument) /* Or the contents of two registers */
 {
    int i_count, i_temp;
    for (i_count = h_processor->first; i_count <= h_processor->last; i_count++){
       if (h_argument != NULL) i_temp = h_argument->nibble[i_count]; else i_temp = 0;
       h_destination->nibble[i_count] = h_source->nibble[i_count] | i_temp;
    }
+   v_reg_written(h_processor, h_destination);
 }
 
-static void v_reg_and(oprocessor *h_processor, oregister *h_destination, oregister *h_source, oregister *h_argument) /* And the contents of two registers */
+void v_reg_and(oprocessor *h_processor, oregister *h_destination, oregister *h_source, oregister *h_argument) /* And the contents of two registers */
 {
    int i_count, i_temp;
    for (i_count = h_processor->first; i_count <= h_processor->last; i_count++){
       if (h_argument != NULL) i_temp = h_argument->nibble[i_count]; else i_temp = 0;
       h_destination->nibble[i_count] = h_source->nibble[i_count] & i_temp;
    }
+   v_reg_written(h_processor, h_destination);
 }
 #endif
 
-static void v_reg_add(oprocessor *h_processor, oregister *h_destination, oregister *h_source, oregister *h_argument) /* Add the contents of two registers */
+void v_reg_add(oprocessor *h_processor, oregister *h_destination, oregister *h_source, oregister *h_argument) /* Add the contents of two registers */
 {
    int i_count, i_temp;
    for (i_count = h_processor->first; i_count <= h_processor->last; i_count++){
@@ -570,9 +639,10 @@ static void v_reg_add(oprocessor *h_processor, oregister *h_destination, oregist
       }
       if (h_destination != NULL) h_destination->nibble[i_count] = i_temp & 0x0f; /* Destination can be null */
    }
+   v_reg_written(h_processor, h_destination);
 }
 
-static void v_reg_sub(oprocessor *h_processor, oregister *h_destination, oregister *h_source, oregister *h_argument) /* Subtract the contents of two registers */
+void v_reg_sub(oprocessor *h_processor, oregister *h_destination, oregister *h_source, oregister *h_argument) /* Subtract the contents of two registers */
 {
    int i_count, i_temp;
    for (i_count = h_processor->first; i_count <= h_processor->last; i_count++)
@@ -589,9 +659,10 @@ static void v_reg_sub(oprocessor *h_processor, oregister *h_destination, oregist
          h_processor->flags[CARRY] = False;
       if (h_destination != NULL) h_destination->nibble[i_count] = i_temp & 0x0f; /* Destination can be null */
    }
+   v_reg_written(h_processor, h_destination);
 }
 
-static void v_reg_test_eq(oprocessor *h_processor, oregister *h_destination, oregister *h_source) /* Test if registers are equal */
+void v_reg_test_eq(oprocessor *h_processor, oregister *h_destination, oregister *h_source) /* Test if registers are equal */
 {
    int i_count, i_temp;
    h_processor->flags[CARRY] = True; /* Clear carry - Do If True */
@@ -606,19 +677,19 @@ static void v_reg_test_eq(oprocessor *h_processor, oregister *h_destination, ore
    }
 }
 
-static void v_reg_test_ne(oprocessor *h_processor, oregister *h_destination, oregister *h_source) /* Test if registers are not equal */
+void v_reg_test_ne(oprocessor *h_processor, oregister *h_destination, oregister *h_source) /* Test if registers are not equal */
 {
    v_reg_test_eq(h_processor, h_destination, h_source);
    h_processor->flags[CARRY] = !h_processor->flags[CARRY];
 }
 
-static void v_reg_inc(oprocessor *h_processor, oregister *h_register) /* Increment the contents of a register */
+void v_reg_inc(oprocessor *h_processor, oregister *h_register) /* Increment the contents of a register */
 {
    h_processor->flags[CARRY] = True; /* Set carry */
    v_reg_add (h_processor, h_register, h_register, NULL); /* Add carry to register */
 }
 
-static void v_reg_shr(oprocessor *h_processor, oregister *h_register) /* Logical shift right a register */
+void v_reg_shr(oprocessor *h_processor, oregister *h_register) /* Logical shift right a register */
 {
    int i_count;
    h_processor->flags[CARRY] = False; /* Clear carry */
@@ -629,9 +700,10 @@ static void v_reg_shr(oprocessor *h_processor, oregister *h_register) /* Logical
       else
          h_register->nibble[i_count] = h_register->nibble[i_count + 1];
    }
+   v_reg_written(h_processor, h_register);
 }
 
-static void v_reg_shl(oprocessor *h_processor, oregister *h_register) /* Logical shift left a register */
+void v_reg_shl(oprocessor *h_processor, oregister *h_register) /* Logical shift left a register */
 {
    int i_count;
    for (i_count = h_processor->last; i_count >= h_processor->first; i_count--)
@@ -641,6 +713,7 @@ static void v_reg_shl(oprocessor *h_processor, oregister *h_register) /* Logical
       else
          h_register->nibble[i_count] = h_register->nibble[i_count - 1];
    }
+   v_reg_written(h_processor, h_register);
    h_processor->flags[PREV_CARRY] = h_processor->flags[CARRY] = False;
 }
 
@@ -710,13 +783,23 @@ void v_read_state(oprocessor *h_processor, char *s_pathname) /* Read processor s
          h_processor->g[0] = i_temp;
          fscanf(h_datafile, "%x,", &i_temp);
          h_processor->g[1] = i_temp;
+         if (h_processor->memory == NULL) /* Mapped memory registers are held in their own file */
+            for (i_count = 0; i_count < MEMORY_SIZE; i_count++)
+               for (i_counter = REG_SIZE - 1; i_counter >= 0 ; i_counter--)
+               {
+                  fscanf(h_datafile, "%x,", &i_temp);
+                  h_processor->mem[i_count]->nibble[i_counter] = i_temp;
+               }
+         h_processor->display++; /* Display registers may have changed */
+#else
+         if (h_processor->memory == NULL) /* Mapped memory registers are held in their own file */
+            for (i_count = 0; i_count < MEMORY_SIZE; i_count++)
+               for (i_counter = REG_SIZE - 1; i_counter >= 0 ; i_counter--)
+               {
+                  fscanf(h_datafile, "%x,", &i_temp);
+                  h_processor->mem[i_count]->nibble[i_counter] = i_temp;
+               }
 #endif
-         for (i_count = 0; i_count < MEMORY_SIZE; i_count++)
-            for (i_counter = REG_SIZE - 1; i_counter >= 0 ; i_counter--)
-            {
-               fscanf(h_datafile, "%x,", &i_temp);
-               h_processor->mem[i_count]->nibble[i_counter] = i_temp;
-            }
          fclose(h_datafile);
       }
       else
@@ -725,2643 +808,691 @@ void v_read_state(oprocessor *h_processor, char *s_pathname) /* Read processor s
 #endif
 }
 
-void v_write_state(oprocessor *h_processor, char *s_pathname) /* Write processor state to file */
-{
 #if defined(CONTINIOUS)
-   FILE *h_datafile;
-   int i_count, i_counter;
-
-   if ((h_processor != NULL) && (s_pathname != NULL)) { /* Check processor and path name are defined */
-      h_datafile = fopen(s_pathname, "w");
-      if (h_datafile !=NULL) { /* If file exists and can be opened save state */
-         debug(fprintf(stderr,h_msg_saving, s_pathname));
-#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
-         for (i_count = 0; i_count < FLAGS; i_count++)
-         {
-            fprintf(h_datafile, "%02x,", h_processor->flags[i_count]);
-         }
-         fprintf(h_datafile,"\n");
-         for (i_count = 0; i_count < STATUS_BITS; i_count++)
-         {
-            fprintf(h_datafile, "%02x,", h_processor->status[i_count]);
-         }
-         fprintf(h_datafile,"\n");
-         for (i_count = 0; i_count < REGISTERS; i_count++)
-         {
-            for (i_counter = REG_SIZE - 1; i_counter >= 0 ; i_counter--)
-               fprintf(h_datafile, "%02x,", h_processor->reg[i_count]->nibble[i_counter]);
-            fprintf(h_datafile,"\n");
-         }
-         fprintf(h_datafile, "%02x,", h_processor->p);
-         fprintf(h_datafile, "%02x,", h_processor->q);
-         fprintf(h_datafile, "%02x,", h_processor->f);
-         fprintf(h_datafile, "%02x,", h_processor->g[0]);
-         fprintf(h_datafile, "%02x,", h_processor->g[1]);
-         fprintf(h_datafile,"\n");
-#endif
-         for (i_count = 0; i_count < MEMORY_SIZE; i_count++)
-         {
-            for (i_counter = REG_SIZE - 1; i_counter >= 0 ; i_counter--)
-               fprintf(h_datafile, "%02x,", h_processor->mem[i_count]->nibble[i_counter]);
-            fprintf(h_datafile,"\n");
-         }
-         fclose(h_datafile);
-      }
-      else
-         v_warning(h_err_opening_file, s_pathname); /* Can't open data file */
-   }
-#endif
-}
-
-void v_save_state(oprocessor *h_processor) /* Restore saved processor state */
+static char *s_state_pathname() /* Default data file name */
 {
-#if defined(CONTINIOUS)
    char *s_dir = getenv("HOME");
    char s_filename[] = FILENAME;
    char s_filetype[] = ".dat";
    char *s_pathname;
 
-   if (h_processor != NULL) /* Check processor defined */
-   {
-      if (s_dir == NULL) s_dir = ""; /* Use current folder if HOME not defined */
+   if (s_dir == NULL) s_dir = ""; /* Use current folder if HOME not defined */
+   if ((s_pathname = malloc(strlen(s_dir) + strlen(s_filename) + strlen(s_filetype) + 3)) == NULL) v_error(h_err_register_alloc, __FILE__, __LINE__);
+   strcpy(s_pathname, s_dir);
 #if defined(unix) || defined(__unix__) || defined(__APPLE__)
-      s_pathname = malloc((strlen(s_dir) + strlen(s_filename) + strlen(s_filetype) + 2) * sizeof(char*));
-      strcpy(s_pathname, s_dir);
-      strcat(s_pathname, "/.");
-#else
-      s_pathname = malloc((strlen(s_dir) + strlen(s_filename) + strlen(s_filetype)) * sizeof(char*));
-      strcpy(s_pathname, s_dir);
-#endif
-      strcat(s_pathname, s_filename);
-      strcat(s_pathname, s_filetype);
-      v_write_state(h_processor, s_pathname); /* Load settings */
-   }
+   strcat(s_pathname, "/.");
 #endif
+   strcat(s_pathname, s_filename);
+   strcat(s_pathname, s_filetype);
+   return(s_pathname);
 }
 
-void v_restore_state(oprocessor *h_processor) /* Restore saved processor state */
+static void v_state_copy(oprocessor *h_processor, unsigned char *c_state) /* Copy the contents of continuous memory */
 {
-#if defined(CONTINIOUS)
-   char *s_dir = getenv("HOME");
-   char s_filename[] = FILENAME;
-   char s_filetype[] = ".dat";
-   char *s_pathname;
+   int i_count, i_counter, i_index = 0;
 
-   if (h_processor != NULL) /* Check processor defined */
-   {
-      if (s_dir == NULL) s_dir = ""; /* Use current folder if HOME not defined */
-#if defined(unix) || defined(__unix__) || defined(__APPLE__)
-      s_pathname = malloc((strlen(s_dir) + strlen(s_filename) + strlen(s_filetype) + 2) * sizeof(char*));
-      strcpy(s_pathname, s_dir);
-      strcat(s_pathname, "/.");
-#else
-      s_pathname = malloc((strlen(s_dir) + strlen(s_filename) + strlen(s_filetype)) * sizeof(char*));
-      strcpy(s_pathname, s_dir);
-#endif
-      strcat(s_pathname, s_filename);
-      strcat(s_pathname, s_filetype);
-      v_read_state(h_processor, s_pathname); /* Load settings */
-   }
+#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
+   for (i_count = 0; i_count < FLAGS; i_count++)
+      c_state[i_index++] = h_processor->flags[i_count];
+   for (i_count = 0; i_count < STATUS_BITS; i_count++)
+      c_state[i_index++] = h_processor->status[i_count];
+   for (i_count = 0; i_count < REGISTERS; i_count++)
+      for (i_counter = REG_SIZE - 1; i_counter >= 0 ; i_counter--)
+         c_state[i_index++] = h_processor->reg[i_count]->nibble[i_counter];
+   c_state[i_index++] = h_processor->p;
+   c_state[i_index++] = h_processor->q;
+   c_state[i_index++] = h_processor->f;
+   c_state[i_index++] = h_processor->g[0];
+   c_state[i_index++] = h_processor->g[1];
 #endif
+   for (i_count = 0; i_count < MEMORY_SIZE; i_count++)
+      for (i_counter = REG_SIZE - 1; i_counter >= 0 ; i_counter--)
+         c_state[i_index++] = h_processor->mem[i_count]->nibble[i_counter];
 }
 
-void v_processor_reset(oprocessor *h_processor) /* Reset processor */
+static int i_state_fprint(FILE *h_file, unsigned char *c_state, int i_index, int i_count) /* Print one line of the data file */
 {
-   int i_count;
-   h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-   for (i_count = 0; i_count < REGISTERS - 2; i_count++) /*Clear the CPU registers and stack */
-      v_reg_copy(h_processor, h_processor->reg[i_count], NULL); /* Copying nothing to a register clears it */
-   for (i_count = 0; i_count < STACK_SIZE; i_count++) /* Clear the processor stack */
-      h_processor->stack[i_count] = 0;
-   for (i_count = 0; i_count < MEMORY_SIZE; i_count++) /*Clear memory */
-      v_reg_copy(h_processor, h_processor->mem[i_count], NULL); /* Copying nothing to a register clears it */
-   for (i_count = 0; i_count < STATUS_BITS; i_count++) /* Clear the processor status word */
-      h_processor->status[i_count] = False;
-   for (i_count = 0; i_count < FLAGS; i_count++) /* Clear the processor flags */
-      h_processor->flags[i_count] = False;
-   h_processor->opcode = 0;
-   h_processor->pc = 0;
-   h_processor->sp = 0;
-   h_processor->f = 0;
-   h_processor->p = 0;
-   h_processor->addr = 0;
-   h_processor->base = 10;
-   h_processor->code = 0;
-   h_processor->keypressed = False;
-   h_processor->enabled = True;
-   h_processor->sleep = False;
-#if defined(WOODSTOCK) || defined(SPICE) || defined(HP10) || defined(HP67)
-   h_processor->status[5] = True; /* TO DO - Check which flags should be set by default */
-#endif
-#if defined(HP67)
-   for (i_count = 0; i_count < STATES; i_count++) /* Clear the processor flags */
-      h_processor->crc[i_count] = False;
-   h_processor->crc[READY] = -4;
-#endif
-#if defined(HP10)
-   h_processor->position = BUFSIZE;
-   for (i_count = 0; i_count < BUFSIZE; i_count++) /* Reset the character buffer contents */
-      h_processor->buffer[i_count] = 0x3f;
-#endif
-#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
-   h_processor->q = 0;
-   h_processor->ptr = False;
-   h_processor->flags[CARRY] = True;
-#else
-   h_processor->rom_number = 0;
-#endif
+   while (i_count-- > 0)
+      fprintf(h_file, "%02x,", c_state[i_index++]);
+   fprintf(h_file,"\n");
+   return(i_index);
 }
 
-oprocessor *h_processor_create(int *h_rom) /* Create a new processor 'object' */
+#if defined(unix) || defined(__unix__) || defined(__APPLE__)
+static void v_sync(char *s_pathname) /* Write a file or folder to disk */
 {
-   oprocessor *h_processor;
-   int i_count;
-   if ((h_processor = malloc(sizeof(*h_processor)))==NULL)
-      v_error("Memory allocation failed!"); /* Attempt to allocate memory to hold the processor structure */
-   for (i_count = 0; i_count < REGISTERS; i_count++)
-      h_processor->reg[i_count] = h_register_create((i_count + 1) * -1); /* Allocate storage for the registers */
-   for (i_count = 0; i_count < MEMORY_SIZE; i_count++)
-      h_processor->mem[i_count] = h_register_create(i_count); /* Allocate storage for the RAM */
-   h_processor->rom = h_rom ; /* Address of ROM */
-   h_processor->mode = False;
-   h_processor->timer = False;
-   h_processor->trace = False;
-   h_processor->step = False;
-   v_processor_reset(h_processor);
-#if defined(HP10)
-   h_processor->print = False;
-#endif
-   return(h_processor);
+   int i_file;
+
+   if ((i_file = open(s_pathname, O_RDONLY)) >= 0)
+   {
+      fsync(i_file);
+      close(i_file);
+   }
 }
 
-#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
-static unsigned char *h_active_pointer (oprocessor *h_processor) /* Return address of active pointer */
+static int i_sync_folder(char *s_pathname) /* Write the folder containing a file to disk */
 {
-   if (h_processor->ptr)
-      return &h_processor->q;
+   char *s_folder;
+
+   if ((s_folder = malloc(strlen(s_pathname) + 2)) == NULL) return(False);
+   strcpy(s_folder, s_pathname);
+   if (strrchr(s_folder, '/') != NULL)
+      *(strrchr(s_folder, '/') + 1) = 0;
    else
-      return &h_processor->p;
+      strcpy(s_folder, ".");
+   v_sync(s_folder);
+   free(s_folder);
+   return(True);
 }
+#endif
 
-static void v_op_inc_pt(oprocessor *h_processor) /* Increment active pointer */
+static int i_state_write(unsigned char *c_state, char *s_pathname) /* Write a copy of continuous memory to file (returns False if out of memory) */
 {
-   if (*h_active_pointer(h_processor) == REG_SIZE - 1)
-      *h_active_pointer(h_processor) = 0;
+   FILE *h_datafile;
+   char *s_temp = s_pathname;
+   int i_count, i_index = 0;
+
+#if defined(unix) || defined(__unix__) || defined(__APPLE__)
+   int b_status = True;
+
+   if ((s_temp = malloc(strlen(s_pathname) + 2)) == NULL) return(False); /* Leave it to the caller to report the error (it may not be the main thread) */
+   strcpy(s_temp, s_pathname);
+   strcat(s_temp, "~"); /* Write to a temporary file then rename it, so the data file is never left half written */
+#endif
+   h_datafile = fopen(s_temp, "w");
+   if (h_datafile !=NULL) { /* If file can be opened save state */
+      debug(fprintf(stderr,h_msg_saving, s_pathname));
+#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
+      i_index = i_state_fprint(h_datafile, c_state, i_index, FLAGS);
+      i_index = i_state_fprint(h_datafile, c_state, i_index, STATUS_BITS);
+      for (i_count = 0; i_count < REGISTERS; i_count++)
+         i_index = i_state_fprint(h_datafile, c_state, i_index, REG_SIZE);
+      i_index = i_state_fprint(h_datafile, c_state, i_index, 5); /* P, Q, F and G registers */
+#endif
+      for (i_count = 0; i_count < MEMORY_SIZE; i_count++)
+         i_index = i_state_fprint(h_datafile, c_state, i_index, REG_SIZE);
+      fclose(h_datafile);
+#if defined(unix) || defined(__unix__) || defined(__APPLE__)
+      v_sync(s_temp); /* Make sure the new file is on disk before it replaces the old one */
+      if (rename(s_temp, s_pathname) != 0)
+         v_warning(h_err_opening_file, s_pathname);
+      else
+         b_status = i_sync_folder(s_pathname); /* And that the rename is too */
+#endif
+   }
    else
+      v_warning(h_err_opening_file, s_temp); /* Can't open data file */
+#if defined(unix) || defined(__unix__) || defined(__APPLE__)
+   free(s_temp);
+   return(b_status);
+#else
+   return(True);
+#endif
+}
+
+#if defined(unix) || defined(__unix__) || defined(__APPLE__)
+static pthread_t h_autosave; /* Writes the data file in the background */
+static pthread_mutex_t h_autosave_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t h_autosave_ready = PTHREAD_COND_INITIALIZER;
+static unsigned char c_autosave[STATE_SIZE]; /* Copy of continuous memory waiting to be written */
+static char *s_autosave = NULL; /* Data file name (only defined while the thread is running) */
+static char b_autosave_pending = False;
+static char b_autosave_stop = False;
+static char b_autosave_failed = False; /* Set by the thread as it can't report errors itself */
+
+static void *h_autosave_thread(void *h_argument) /* Write each copy of continuous memory as it arrives */
+{
+   unsigned char c_state[STATE_SIZE];
+
+   pthread_mutex_lock(&h_autosave_lock);
+   for (;;)
    {
-      if (*h_active_pointer(h_processor) > 0)
-         *h_active_pointer(h_processor) = *h_active_pointer(h_processor) + 1;
-      else
+      while (!b_autosave_pending && !b_autosave_stop)
+         pthread_cond_wait(&h_autosave_ready, &h_autosave_lock);
+      if (!b_autosave_pending) break; /* Only stop when there is nothing left to write */
+      memcpy(c_state, c_autosave, STATE_SIZE);
+      b_autosave_pending = False;
+      pthread_mutex_unlock(&h_autosave_lock); /* Don't hold the lock while writing */
+      if (!i_state_write(c_state, s_autosave))
       {
-         if (h_processor->opcode != h_processor->rom[h_processor->pc - 1]) /* Literally the only way to work out if the pointer */
-            *h_active_pointer(h_processor) = *h_active_pointer(h_processor) + 1; /* should be incremented when it is zero is to check the previous opcode ! */
+         pthread_mutex_lock(&h_autosave_lock);
+         b_autosave_failed = True; /* Stop and let the main loop deal with it */
+         break;
       }
+      pthread_mutex_lock(&h_autosave_lock);
    }
+   pthread_mutex_unlock(&h_autosave_lock);
+   return(NULL);
 }
+#endif
+#endif
 
-static void v_op_dec_pt(oprocessor *h_processor) /* Decrement active pointer */
+void v_write_state(oprocessor *h_processor, char *s_pathname) /* Write processor state to file */
 {
-   if (*h_active_pointer(h_processor) == 0) *h_active_pointer(h_processor) = REG_SIZE - 1; else *h_active_pointer(h_processor) = *h_active_pointer(h_processor) - 1;
-}
+#if defined(CONTINIOUS)
+   unsigned char c_state[STATE_SIZE];
 
-int i_translate_addr(int i_addr) /* Translate address to a memory register */
-{
-      /* HP10c ?
-      /*    0x00 to 0x0A - Registers */
-      /*    0xE0 to 0xFF - RAM (31 registers)*/
-      /* HP15c
-      /*    0x00 to 0x1A - Registers */
-      /*    0xC0 to 0xFF - RAM */
-   return i_addr;
+   if ((h_processor != NULL) && (s_pathname != NULL)) { /* Check processor and path name are defined */
+      v_state_copy(h_processor, c_state);
+      if (!i_state_write(c_state, s_pathname)) v_error(h_err_register_alloc, __FILE__, __LINE__);
+   }
+#endif
 }
 
-#else
-static void v_op_inc_p(oprocessor *h_processor) /* Increment p register */
+#if defined(CONTINIOUS)
+static void v_state_save(oprocessor *h_processor, unsigned char *c_state) /* Save a copy of continuous memory */
 {
-#if defined(HP10) || defined(HP31e) || defined(HP32e) || defined(HP33e) || defined(HP33c) || defined(HP34c) || defined(HP37e) || defined(HP38e) || defined(HP38c) || defined(HP67)
-   if (h_processor->p == REG_SIZE - 1)
-      h_processor->p = 0;
-   else
+   char *s_pathname;
+
+   memcpy(h_processor->saved, c_state, STATE_SIZE);
+#if defined(unix) || defined(__unix__) || defined(__APPLE__)
+   if (s_autosave != NULL) /* Pass it on to the background thread */
    {
-      if (h_processor->p > 0)
-         h_processor->p++;
-      else
+      pthread_mutex_lock(&h_autosave_lock);
+      if (!b_autosave_failed) /* Unless it has stopped */
       {
-         if (h_processor->opcode != h_processor->rom[h_processor->pc - 1]) /* Literally the only way to work out */
-            h_processor->p++; /* if 'P' should be incremented when it is zero is to check the previous opcode !! */
+         memcpy(c_autosave, c_state, STATE_SIZE);
+         b_autosave_pending = True;
+         pthread_cond_signal(&h_autosave_ready);
+         pthread_mutex_unlock(&h_autosave_lock);
+         return;
       }
+      pthread_mutex_unlock(&h_autosave_lock);
    }
-#elif defined(HP35) || defined(HP80) || defined(HP45) || defined(HP70) || defined(HP55)
-   h_processor->p++;
-   h_processor->p &= 15;
-#else
-   if (h_processor->p == REG_SIZE) h_processor->p = 0; else h_processor->p++;
-#endif
-}
-
-static void v_op_dec_p(oprocessor *h_processor) /* Decrement p register */
-{
-#if defined(HP35) || defined(HP80) || defined(HP45) || defined(HP70) || defined(HP55)
-   h_processor->p--;
-   h_processor->p &= 15;
-#else
-   if (h_processor->p == 0) h_processor->p = REG_SIZE - 1; else h_processor->p--;
 #endif
+   s_pathname = s_state_pathname();
+   if (!i_state_write(c_state, s_pathname)) v_error(h_err_register_alloc, __FILE__, __LINE__);
+   free(s_pathname);
 }
 #endif
 
-static void v_op_inc_pc(oprocessor *h_processor) /* Increment program counter */
+void v_save_state(oprocessor *h_processor) /* Save processor state if it has changed */
 {
-#if defined(HP35) || defined(HP80) || defined(HP45) || defined(HP70) || defined(HP55)
-   h_processor->pc = ((h_processor->pc >> 8) << 8) | ((h_processor->pc + 1) & 0xff); /* Address wraps round at end of ROM */
-#else
-   if (h_processor->pc >= (ROM_SIZE - 1))
-      h_processor->pc = 0; /* Address wraps round at end of memory */
-   else
-      h_processor->pc = (h_processor->pc & 0xf000) | ((h_processor->pc + 1) & 0xfff); /* Address wraps round at end of bank */
+#if defined(CONTINIOUS)
+   unsigned char c_state[STATE_SIZE];
+
+   if (h_processor != NULL) /* Check processor defined */
+   {
+      v_state_copy(h_processor, c_state);
+      if (h_processor->memory != NULL) /* Mapped memory is written back by the system */
+      {
+         if (!memcmp(c_state, h_processor->saved, STATE_MEMORY)) return; /* So only the processor state needs to be checked */
+      }
+      else if (!memcmp(c_state, h_processor->saved, STATE_SIZE)) return; /* Nothing has changed since it was last saved */
+      v_state_save(h_processor, c_state);
+   }
 #endif
-   h_processor->flags[PREV_CARRY] = h_processor->flags[CARRY];
-   h_processor->flags[CARRY] = False;
 }
 
-#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
-
-void op_jsb(oprocessor *h_processor, int i_address) /* Call to subroutine */
+void v_autosave(oprocessor *h_processor) /* Save processor state if the memory registers have changed */
 {
-   h_processor->stack[h_processor->sp] = h_processor->pc; /* Push current address on the stack */
-   h_processor->sp = (h_processor->sp + 1) & (STACK_SIZE - 1); /* Update stack pointer */
-   h_processor->pc = i_address; /* Long address */
-}
-
-#else
+#if defined(CONTINIOUS)
+   unsigned char c_state[STATE_SIZE];
 
-static void v_delayed_rom(oprocessor *h_processor) /* Delayed ROM select */
-{
-   if (h_processor->flags[DELAYED_ROM])
+   if (h_processor != NULL) /* Check processor defined */
    {
-      h_processor->pc = (h_processor->rom_number << 8 | (h_processor->pc & 0xf0ff));
-      h_processor->flags[DELAYED_ROM] = False; /* Clear flag */
+      if (h_processor->memory != NULL) return; /* Mapped memory is written back by the system */
+      v_state_copy(h_processor, c_state);
+      if (!memcmp(c_state + STATE_MEMORY, h_processor->saved + STATE_MEMORY, STATE_SIZE - STATE_MEMORY)) return; /* The processor registers change all the time so are ignored */
+      v_state_save(h_processor, c_state);
    }
-   if (h_processor->pc < 0x1400) h_processor->pc &= 0xfff; /* The first ROM chip is mapped to all ROM banks, access implies a switch to bank 0 */
+#endif
 }
 
-void op_jsb(oprocessor *h_processor, int i_address) /* Jump to subroutine */
+void v_restore_state(oprocessor *h_processor) /* Restore saved processor state */
 {
-   h_processor->stack[h_processor->sp] = h_processor->pc; /* Push current address on the stack */
-   h_processor->sp = (h_processor->sp + 1) & (STACK_SIZE - 1); /* Update stack pointer */
-   h_processor->pc = ((h_processor->pc & 0xff00) | i_address); /* Note - Uses an eight bit address */
-   v_delayed_rom(h_processor);
-}
-#endif
+#if defined(CONTINIOUS)
+   char *s_pathname;
 
+   if (h_processor != NULL) /* Check processor defined */
+   {
+      s_pathname = s_state_pathname();
+      v_read_state(h_processor, s_pathname); /* Load settings */
+      v_state_copy(h_processor, h_processor->saved); /* Matches the data file */
+      free(s_pathname);
+   }
+#endif
+}
 
-void v_op_goto(oprocessor *h_processor) /* Conditional go to */
+void v_autosave_start() /* Start writing the data file in the background */
 {
-   if (h_processor->trace)
+#if defined(CONTINIOUS) && (defined(unix) || defined(__unix__) || defined(__APPLE__))
+   if (s_autosave != NULL) return;
+   s_autosave = s_state_pathname();
+   b_autosave_stop = False;
+   if (pthread_create(&h_autosave, NULL, h_autosave_thread, NULL) != 0)
    {
-      fprintf(stdout, "\n"); fprintf(stdout,h_msg_opcode, (h_processor->pc >> 12), (h_processor->pc & 0x0fff), h_processor->rom[h_processor->pc]);
-      fprintf(stdout,"  then go to ");
+      free(s_autosave); /* Fall back to saving the data file in the foreground */
+      s_autosave = NULL;
    }
-   h_processor->flags[PREV_CARRY] = h_processor->flags[CARRY];
-   h_processor->flags[CARRY] = False;
-#if defined(HP35) || defined(HP80) || defined(HP45) || defined(HP70) || defined(HP55)
-   if (h_processor->trace) fprintf(stdout, h_msg_address, (h_processor->pc & 0xf00) | (h_processor->rom[h_processor->pc]) >> 2); /* Mask off the bank number and least significant 8 bits*/
-   if (h_processor->flags[PREV_CARRY])  /* Do if True */
-      h_processor->pc = (h_processor->pc & 0xff00) | h_processor->rom[h_processor->pc] >> 2; /* Classic CPU uses a _eight_ bit address */
-#else
-   if (h_processor->trace) fprintf(stdout, h_msg_address, ((h_processor->pc & 0xc00) | h_processor->rom[h_processor->pc] )); /* Mask off the bank number and least significant 10 bits */
-   if (h_processor->flags[PREV_CARRY])  /* Do if True */
-      h_processor->pc = ((h_processor->pc & 0xfc00) | h_processor->rom[h_processor->pc]); /* Use a _ten_ bit address */
 #endif
-   else
-      v_op_inc_pc(h_processor);
 }
 
-void v_processor_tick(oprocessor *h_processor) /* Decode and execute a single instruction */
+int i_autosave_failed() /* Check if the background thread has stopped because of an error */
 {
-#if defined(HP10) || defined(WOODSTOCK) || defined(SPICE) || defined(HP67)
-   static const int i_set_p[16] = { 14,  4,  7,  8, 11,  2, 10, 12,  1,  3, 13,  6,  0,  9,  5, 14 };
-   static const int i_tst_p[16] = { 4 ,  8, 12,  2,  9,  1,  6,  3,  1, 13,  5,  0, 11, 10,  7,  4 };
+   int b_failed = False;
+#if defined(CONTINIOUS) && (defined(unix) || defined(__unix__) || defined(__APPLE__))
+   pthread_mutex_lock(&h_autosave_lock);
+   b_failed = b_autosave_failed;
+   pthread_mutex_unlock(&h_autosave_lock);
 #endif
+   return(b_failed);
+}
 
-#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
-   static const int n_map_i[16] = {  3,  4,  5, 10,  8,  6, 11, -1,  2,  9,  7, 13,  1, 12,  0, -1 }; /* map nnnn to index */
+void v_autosave_stop() /* Wait for any pending changes to be written and stop */
+{
+#if defined(CONTINIOUS) && (defined(unix) || defined(__unix__) || defined(__APPLE__))
+   if (s_autosave == NULL) return;
+   pthread_mutex_lock(&h_autosave_lock);
+   b_autosave_stop = True;
+   pthread_cond_signal(&h_autosave_ready);
+   pthread_mutex_unlock(&h_autosave_lock);
+   pthread_join(h_autosave, NULL);
+   free(s_autosave);
+   s_autosave = NULL;
 #endif
+}
 
-   unsigned int i_last; /* Save the current PC */
-   unsigned int i_opcode;
-   unsigned int i_field; /* Field modifier */
-   const char *s_field; /* Holds pointer to field name */
-
-   if (h_processor->enabled && !h_processor->sleep)
+void v_map_memory(oprocessor *h_processor, char *s_pathname) /* Keep the memory registers in a mapped file */
+{
+#if defined(CONTINIOUS) && (defined(unix) || defined(__unix__) || defined(__APPLE__))
+   omemory *h_memory;
+   struct stat o_stat;
+   size_t i_size = sizeof(omemory) + MEMORY_SIZE * sizeof(oregister);
+   int i_file, i_count;
+
+   if ((i_file = open(s_pathname, O_RDWR | O_CREAT, 0644)) < 0) v_error(h_err_opening_file, s_pathname);
+   if (fstat(i_file, &o_stat) < 0) v_error(h_err_opening_file, s_pathname);
+   if (o_stat.st_size == 0) /* New file */
    {
-
-#if defined(HP35) || defined(HP80) || defined(HP45) || defined(HP70) || defined(HP55)
-      /* TIMER : status[11] = 1, status[3] = 0
-       * PRGM  : status[11] = 0, status[3] = 1
-       * RUN   : status[11] = 0, status[3] = 0 */
-      if (h_processor->keypressed) h_processor->status[0] = True; /* Set status bit 0 if key pressed */
-      if (h_processor->mode) h_processor->status[3] = True; /* Set status bits based on switch position */
-      if (h_processor->timer) h_processor->status[11] = True;
+      if ((lseek(i_file, i_size - 1, SEEK_SET) < 0) || (write(i_file, "", 1) != 1)) v_error(h_err_opening_file, s_pathname); /* Extend the file */
+   }
+   else if (o_stat.st_size != i_size)
+      v_error(h_err_memory_file, s_pathname);
+   h_memory = mmap(NULL, i_size, PROT_READ | PROT_WRITE, MAP_SHARED, i_file, 0);
+   close(i_file);
+   if (h_memory == MAP_FAILED) v_error(h_err_opening_file, s_pathname);
+   if (o_stat.st_size == 0) /* Start with the current contents of memory */
+   {
+      strncpy(h_memory->name, FILENAME, sizeof(h_memory->name));
+      h_memory->version = MEMORY_VERSION;
+      h_memory->size = MEMORY_SIZE;
+      h_memory->length = sizeof(oregister);
+      for (i_count = 0; i_count < MEMORY_SIZE; i_count++)
+         ((oregister *) (h_memory + 1))[i_count] = *h_processor->mem[i_count];
+   }
+   else if (strncmp(h_memory->name, FILENAME, sizeof(h_memory->name)) || (h_memory->version != MEMORY_VERSION) || (h_memory->size != MEMORY_SIZE) || (h_memory->length != sizeof(oregister)))
+      v_error(h_err_memory_file, s_pathname); /* Wrong model or built differently */
+   for (i_count = 0; i_count < MEMORY_SIZE; i_count++)
+      h_processor->mem[i_count] = (oregister *) (h_memory + 1) + i_count;
+   h_processor->memory = h_memory;
+#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
+   h_processor->display++; /* Display registers may have changed */
 #endif
-
-#if defined(HP21) || defined(HP22) || defined(HP25) || defined(HP25c) || defined(HP27) || defined(HP29c)
-      if (h_processor->keypressed) h_processor->status[15] = True; /* Set status bit if key pressed */
-      if (h_processor->mode) h_processor->status[3] = True; /* Set status bits based on switch position */
-      h_processor->status[5] = True; /* Low Power */
 #endif
+}
 
-#if defined(HP67) /* Seems to use a flag rather then the status word for the switch position */
-      if (h_processor->keypressed) h_processor->status[15] = True; /* Set status bit 15 if key pressed */
-      h_processor->flags[MODE] = h_processor->mode; /* Set the program mode flag based on switch position */
+void v_sync_memory(oprocessor *h_processor) /* Write mapped memory registers back to the file */
+{
+#if defined(CONTINIOUS) && (defined(unix) || defined(__unix__) || defined(__APPLE__))
+   if (h_processor->memory != NULL)
+      msync(h_processor->memory, sizeof(omemory) + MEMORY_SIZE * sizeof(oregister), MS_SYNC);
 #endif
+}
 
-#if defined(HP31e) || defined(HP32e) || defined(HP33e) || defined(HP33c) || defined(HP34c) || defined(HP37e) || defined(HP38e) || defined(HP38c) /* Setting S(5) breaks the self test */
-      if (h_processor->keypressed) h_processor->status[15] = True; /* Set status bit if key pressed */
-      if (h_processor->mode) h_processor->status[3] = True; /* Set status bits based on switch position */
-      h_processor->status[5] = False; /* Self Test */
-#endif
+#if defined(HP67)
+static char s_card[256] = ""; /* Name of the last card inserted */
+static char *s_track = NULL; /* Pathname of the card in the reader */
+static FILE *h_blank = NULL; /* New card, created when it was inserted so its name can't be taken */
 
-#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
-      if (h_processor->keypressed) h_processor->kyf = True; /* Set keyboard flag if key pressed */
-#endif
+void v_card_transfer(oprocessor *h_processor) /* Move the next word between the card and the card reader data register */
+{
+   int i_count;
 
-      i_opcode = h_processor->rom[h_processor->pc]; /* Get next instruction */
-      i_last = h_processor->pc;
-      if (h_processor->trace)
-         fprintf(stdout, h_msg_opcode, (i_last >> 12), (i_last & 0x0fff), h_processor->rom[i_last]);
-      v_op_inc_pc(h_processor); /* Increment program counter _before_ decoding the opcode */
-      switch (i_opcode & 03)
+   if (h_processor->crc[WRITE])
+   {
+      if (h_processor->word == 0) /* Nothing is recorded on the leader */
+      {
+         for (i_count = REG_SIZE - CARD_NIBBLES; i_count < REG_SIZE; i_count++)
+            if (h_processor->card->nibble[i_count]) h_processor->word = 1;
+         if (h_processor->word == 0) return;
+      }
+      if (h_processor->word < CARD_WORDS)
+      {
+         h_processor->track[h_processor->word] = 0;
+         for (i_count = REG_SIZE - 1; i_count >= REG_SIZE - CARD_NIBBLES; i_count--) /* Each word is held in the most significant digits */
+            h_processor->track[h_processor->word] = (h_processor->track[h_processor->word] << 4) | h_processor->card->nibble[i_count];
+         h_processor->words = ++h_processor->word; /* Anything left on the card is overwritten */
+      }
+      if (h_processor->word >= CARD_WORDS) h_processor->crc[CARD] = False; /* The end of the card has passed through the reader */
+   }
+   else
+   {
+      for (i_count = 0; i_count < REG_SIZE; i_count++)
+         h_processor->card->nibble[i_count] = 0;
+      if (h_processor->word < h_processor->words)
       {
+         for (i_count = 0; i_count < CARD_NIBBLES; i_count++) /* Each word read appears in both halves of the register */
+            h_processor->card->nibble[i_count] = h_processor->card->nibble[i_count + REG_SIZE - CARD_NIBBLES] = (h_processor->track[h_processor->word] >> (i_count * 4)) & 0xf;
+         h_processor->word++;
+      }
+      if (h_processor->word >= h_processor->words) h_processor->crc[CARD] = False;
+   }
+}
 
-#if defined(HP35) || defined(HP80) || defined(HP45) || defined(HP70) || defined(HP55)
-      case 00: /* Type 0 - Special operations */
-         switch ((i_opcode >> 2) & 03)
-         {
-         case 00: /* Op-Codes matching x xxx xx 00 00 */
-            switch ((i_opcode >> 4) & 03)
-            {
-            case 00:  /* Op-Codes matching x xxx 000 000 */
-               switch (i_opcode)
-               {
-               case 00000: /* nop */
-                  if (h_processor->trace) fprintf(stdout, "nop");
-                  break;
-               default:
-                  if (h_processor->trace) fprintf(stdout, "\n");
-                  v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-               }
-               break;
-            case 01: /* Op-Codes matching x xxx 010 000 */
-               switch ((i_opcode >> 6) & 01)
-               {
-               case 00: /* Op-Codes matching x xx0 010 000 */ /* select rom */
-                  if (h_processor->trace) fprintf(stdout, "select rom %02o", i_opcode >> 7); /* Note - Not the same as the Woodstock CPU */
-                  h_processor->pc = ((i_opcode >> 7) << 8) + ((h_processor->pc) & 0xff);
-                  break;
-               case 01: /* keys -> rom address */
-                  if (h_processor->trace) fprintf(stdout, "keys -> rom address");
-                  h_processor->pc &= 0xff00;
-                  v_delayed_rom(h_processor);
-                  h_processor->pc += h_processor->code;
-                  break;
-               default:
-                  if (h_processor->trace) fprintf(stdout, "\n");
-                  v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-               }
-               break;
-            case 02: /* Op-Codes matching x xxx 100 000 */
-               switch (i_opcode)
-               {
-               case 0:
-                  break;
-               default:
-                  if (h_processor->trace) fprintf(stdout, "\n");
-                  v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-               }
-               break;
-            case 03: /* Op-Codes matching x xxx 110 000 */
-               switch (i_opcode)
-               {
-               case 00060: /* return */
-                  if (h_processor->trace) fprintf(stdout, "return");
-                  h_processor->sp = (h_processor->sp - 1) & (STACK_SIZE - 1); /* Update stack pointer */
-                  h_processor->pc = (h_processor->pc & (~0xff)) + (h_processor->stack[h_processor->sp] & 0xff); /* Pop program counter from the stack */
-                  break;
-               case 01160: /* c -> data address */
-                  {
-                     int i_addr;
-                     if (h_processor->trace) fprintf(stdout, "c -> data address\t");
-                     i_addr = h_processor->reg[C_REG]->nibble[12];
-                     h_processor->addr = i_addr;
-                     if (i_addr < MEMORY_SIZE)
-                        h_processor->addr = i_addr;
-                     else {
-                        h_processor->addr = MEMORY_SIZE - 1;
-                     }
-                  }
-                  if (h_processor->trace) fprintf(stdout, "addr = %d", h_processor->addr);
-                  break;
-               case 01360: /* c -> data */
-                  if (h_processor->trace) fprintf(stdout, "c -> data\t\t");
-                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                  if (h_processor->addr < MEMORY_SIZE)
-                     v_reg_copy(h_processor, h_processor->mem[h_processor->addr], h_processor->reg[C_REG]);
-                  else
-                  {
-                     if (h_processor->trace) fprintf(stdout, "\n");
-                     v_error(h_err_invalid_register, h_processor->addr, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-                  }
-                  if (h_processor->trace) v_fprint_register(stdout,h_processor->mem[h_processor->addr]);
-                  break;
-               default:
-                  if (h_processor->trace) fprintf(stdout, "\n");
-                  v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-               }
-               break;
-            }
-            break;
-         case 01: /* Op-Codes matching x xxx xx 01 00 */
-            switch ((i_opcode >> 4) & 03)
-            {
-            case 00: /* 1 -> s(n) */
-               if (h_processor->trace) fprintf(stdout, "1 -> s(%d)\t\t", i_opcode >> 6);
-               h_processor->status[i_opcode >> 6] = True;
-               if (h_processor->trace) v_fprint_status(stdout, h_processor);
-               break;
-            case 01: /* if 0 = s(n) */
-               if (h_processor->trace) fprintf(stdout, "if 0 = s(%d) ", i_opcode >> 6);
-               h_processor->flags[CARRY] = !h_processor->status[i_opcode >> 6];
-               v_op_goto(h_processor);
-               break;
-            case 02: /* 0 -> s(n) */
-               if (h_processor->trace) fprintf(stdout, "0 -> s(%d)\t\t", i_opcode >> 6);
-               h_processor->status[i_opcode >> 6] = False;
-               if (h_processor->trace) v_fprint_status(stdout, h_processor);
-               break;
-            case 03: /* delayed select rom n */
-               switch (i_opcode)
-               {
-               case 00064: /* clear status */
-                  if (h_processor->trace) fprintf(stdout, "clear status\t");
-                  {
-                     int i_count;
-                     for (i_count = 0; i_count < sizeof(h_processor->status) / sizeof(*h_processor->status); i_count++)
-                        h_processor->status[i_count] = False; /* Clear all bits */
-                  }
-                  if (h_processor->trace) v_fprint_status(stdout, h_processor);
-                  break;
-               case 01064: /*delayed select */
-               case 01264: /*delayed select */
-                  if (h_processor->trace) fprintf(stdout, "\n");
-                  v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-                  break;
-               default: /* delayed select rom n */
-                  if (h_processor->trace) fprintf(stdout, "delayed select rom %d", i_opcode >> 7); /* Note - Not the same as the Woodstock CPU */
-                  h_processor->rom_number = i_opcode >> 7;
-                  h_processor->flags[DELAYED_ROM] = True;
-               }
-               break;
-            }
-            break;
+void v_card_eject(oprocessor *h_processor) /* Remove the card from the reader, saving anything written to it */
+{
+   FILE *h_file;
+   unsigned int i_count;
+   int i_counter;
 
-         case 02: /* Op-Codes matching x xx xx 10 00 */
-            switch ((i_opcode >> 4) & 03)
-            {
-            case 01: /* Op-Codes matching xx xx 01 10 00 */ /* load constant n */
-               if (h_processor->trace) fprintf(stdout, "load constant %d\t", i_opcode >> 6);
-               h_processor->reg[C_REG]->nibble[h_processor->p] = i_opcode >> 6;
-               v_op_dec_p(h_processor);
-               if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-               break;
-            case 02: /* Op-Codes matching x xx 10 10 00 */
-               switch (i_opcode)
-               {
-               case 00050: /* display toggle */
-                  if (h_processor->trace) fprintf(stdout, "display toggle");
-                  h_processor->flags[DISPLAY_ENABLE] = (!h_processor->flags[DISPLAY_ENABLE]);
-                  break;
-               case 00250: /* m exch c */
-                  if (h_processor->trace) fprintf(stdout, "m exch c\t\t");
-                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                  v_reg_exch(h_processor, h_processor->reg[M_REG], h_processor->reg[C_REG]);
-                  if (h_processor->trace)
-                  {
-                     v_fprint_register(stdout,h_processor->reg[C_REG]);
-                     v_fprint_register(stdout,h_processor->reg[M_REG]);
-                  }
-                  break;
-               case 00450: /* c -> stack */
-                  if (h_processor->trace) fprintf(stdout, "c -> stack\t\t");
-                     h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                     v_reg_copy(h_processor, h_processor->reg[T_REG], h_processor->reg[Z_REG]); /* T = Z */
-                     v_reg_copy(h_processor, h_processor->reg[Z_REG], h_processor->reg[Y_REG]); /* T = Z */
-                     v_reg_copy(h_processor, h_processor->reg[Y_REG], h_processor->reg[C_REG]); /* T = Z */
-                     if (h_processor->trace)
-                     {
-                        v_fprint_register(stdout,h_processor->reg[Y_REG]);
-                        v_fprint_register(stdout,h_processor->reg[Z_REG]);
-                        v_fprint_register(stdout,h_processor->reg[T_REG]);
-                     }
-                  break;
-               case 00650: /* stack -> a */
-                  if (h_processor->trace) fprintf(stdout, "stack -> a\t\t");
-                     h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                     v_reg_copy(h_processor, h_processor->reg[A_REG], h_processor->reg[Y_REG]); /* T = Z */
-                     v_reg_copy(h_processor, h_processor->reg[Y_REG], h_processor->reg[Z_REG]); /* T = Z */
-                     v_reg_copy(h_processor, h_processor->reg[Z_REG], h_processor->reg[T_REG]); /* T = Z */
-                     if (h_processor->trace)
-                     {
-                        v_fprint_register(stdout,h_processor->reg[A_REG]);
-                        v_fprint_register(stdout,h_processor->reg[Y_REG]);
-                        v_fprint_register(stdout,h_processor->reg[Z_REG]);
-                     }
-                  break;
-               case 01050: /* display off */
-                  if (h_processor->trace) fprintf(stdout, "display off");
-                  h_processor->flags[DISPLAY_ENABLE] = False;
-                  break;
-               case 01250: /* m -> c */
-                  if (h_processor->trace) fprintf(stdout, "m -> c\t\t");
-                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                  v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->reg[M_REG]);
-                  if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-                  break;
-               case 01450: /* down rotate */
-                  if (h_processor->trace) fprintf(stdout, "down rotate\t\t");
-                     h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                     v_reg_exch(h_processor, h_processor->reg[T_REG], h_processor->reg[C_REG]); /* T <> C - C to T */
-                     v_reg_exch(h_processor, h_processor->reg[C_REG], h_processor->reg[Y_REG]); /* C <> Y - Y to C */
-                     v_reg_exch(h_processor, h_processor->reg[Y_REG], h_processor->reg[Z_REG]); /* Y <> Z - Z to Y and T ends up in Z */
-                     if (h_processor->trace)
-                     {
-                        v_fprint_register(stdout,h_processor->reg[C_REG]);
-                        v_fprint_register(stdout,h_processor->reg[Y_REG]);
-                        v_fprint_register(stdout,h_processor->reg[Z_REG]);
-                        v_fprint_register(stdout,h_processor->reg[T_REG]);
-                     }
-                  break;
-               case 01650: /* clear registers */
-                  if (h_processor->trace) fprintf(stdout, "clear registers");
-                  {
-                     int i_count;
-                     h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                     for (i_count = 0; i_count < REGISTERS - 2; i_count++) /* Don't clear M or N */
-                        v_reg_copy(h_processor, h_processor->reg[i_count], NULL); /* Copying nothing to a register clears it */
-                  }
-                  break;
-               default:
-                  if (h_processor->trace) fprintf(stdout, "\n");
-                  v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-               }
-               break;
-            case 03: /* Op-Codes matching x xx 10 10 00 */
-               switch (i_opcode)
-               {
-               case 01360: /* c -> data */
-                  if (h_processor->trace) fprintf(stdout, "c -> data\t\t");
-                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                  if (h_processor->addr < MEMORY_SIZE)
-                     v_reg_copy(h_processor, h_processor->mem[h_processor->addr], h_processor->reg[C_REG]);
-                  else
-                  {
-                     if (h_processor->trace) fprintf(stdout, "\n");
-                     v_error(h_err_invalid_register, h_processor->addr, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-                  }
-                  if (h_processor->trace) v_fprint_register(stdout,h_processor->mem[h_processor->addr]);
-                  break;
-               case 01370: /* data -> c */
-                  if (h_processor->trace) fprintf(stdout, "data -> c\t\t");
-                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                  v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->mem[h_processor->addr]);
-                  if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-                  break;
-               default:
-                  if (h_processor->trace) fprintf(stdout, "\n");
-                  v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-               }
-               break;
-            default:
-               if (h_processor->trace) fprintf(stdout, "\n");
-               v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            break;
+   if ((s_track != NULL) && h_processor->crc[WRITE] && (h_processor->words > 1))
+   {
+      h_file = (h_blank != NULL) ? h_blank : fopen(s_track, "w");
+      h_blank = NULL;
+      if (h_file != NULL)
+      {
+         fprintf(stdout, h_msg_saving, s_track);
+         for (i_count = 1; i_count < h_processor->words; i_count++) /* One word on each line, without the leader */
+         {
+            for (i_counter = CARD_NIBBLES - 1; i_counter >= 0; i_counter--)
+               fprintf(h_file, "%02lx,", (h_processor->track[i_count] >> (i_counter * 4)) & 0xf);
+            fprintf(h_file, "\n");
+         }
+         fclose(h_file);
+      }
+      else
+         v_warning(h_err_opening_file, s_track);
+   }
+   if (h_blank != NULL) /* Nothing was written to the new card */
+   {
+      fclose(h_blank);
+      h_blank = NULL;
+      remove(s_track);
+   }
+   h_processor->crc[CARD] = False;
+   h_processor->words = h_processor->word = 0;
+   free(s_track);
+   s_track = NULL;
+}
 
-         case 03: /* Op-Codes matching xx xx xx 11 00 */
-            switch ((i_opcode >> 4) & 03)
-            {
-            case 00: /* Op-Codes matching xx xx 00 11 00 */ /* n -> p */
-               if (h_processor->trace) fprintf(stdout, "%d -> p", i_opcode >> 6);
-               h_processor->p = i_opcode >> 6;
-               break;
-            case 01: /* Op-Codes matching xx xx 01 11 00 */ /* p - 1 -> p */
-               if (h_processor->trace) fprintf(stdout, "p - 1 -> p");
-               v_op_dec_p(h_processor);
-               break;
-            case 02: /* Op-Codes matching xx xx 10 11 00 */ /* if p != n */
-               if (h_processor->trace) fprintf(stdout, "if p != %d", i_opcode >> 6);
-               h_processor->flags[CARRY] = (h_processor->p != i_opcode >> 6);
-               v_op_goto(h_processor);
-               break;
-            case 03: /* Op-Codes matching xx xx 11 11 00 */ /* p + 1 -> p */
-               if (h_processor->trace) fprintf(stdout, "p + 1 -> p");
-               v_op_inc_p(h_processor);
-               break;
-            default:
-               if (h_processor->trace) fprintf(stdout, "\n");
-               v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            break;
-         default:
-            if (h_processor->trace) fprintf(stdout, "\n");
-            v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+static void v_card_insert(oprocessor *h_processor, char *s_pathname, FILE *h_new) /* Put a card in the reader (a new card is already open for writing) */
+{
+   const int i_sides[] = CARD_SIDES;
+   FILE *h_file;
+   unsigned int i_temp, i_side;
+   int i_count, i_nibbles = 0;
+
+   if (h_processor->crc[CARD]) return; /* There is already a card in the reader */
+   for (i_count = 0; i_count < REG_SIZE; i_count++)
+      h_processor->card->nibble[i_count] = 0;
+   h_processor->track[0] = 0; /* Blank leader */
+   h_processor->words = 1;
+   h_processor->word = 0;
+   if ((h_new == NULL) && ((h_file = fopen(s_pathname, "r")) != NULL))
+   {
+      fprintf(stdout, h_msg_loading, s_pathname);
+      while ((h_processor->words < CARD_WORDS) && (fscanf(h_file, "%x,", &i_temp) == 1))
+      {
+         if (i_nibbles == 0) h_processor->track[h_processor->words] = 0;
+         h_processor->track[h_processor->words] = (h_processor->track[h_processor->words] << 4) | (i_temp & 0xf);
+         if (++i_nibbles == CARD_NIBBLES)
+         {
+            h_processor->words++;
+            i_nibbles = 0;
          }
-         break;
+      }
+      fclose(h_file);
+   }
+   if (h_processor->turbo && h_processor->mode && (h_processor->words == CARD_WORDS)) /* Copy a whole card straight into memory */
+      i_side = h_processor->track[1] >> ((CARD_NIBBLES - 1) * 4); /* The first digit of the header gives the side */
+   else
+      i_side = 0;
+   if ((i_side > 0) && (i_side <= sizeof(i_sides) / sizeof(i_sides[0])))
+   {
+      for (i_count = 0; i_count < (CARD_WORDS - 3) * CARD_NIBBLES; i_count++) /* Each register is recorded in two words, most significant digits first */
+         h_processor->mem[i_sides[i_side - 1] - i_count / REG_SIZE]->nibble[REG_SIZE - 1 - i_count % REG_SIZE] =
+            (h_processor->track[2 + i_count / CARD_NIBBLES] >> ((CARD_NIBBLES - 1 - i_count % CARD_NIBBLES) * 4)) & 0xf;
+      if (i_side > 2) h_processor->crc[FUNCTION] = False; /* Like the ROM, stop using the default functions once a program is read */
+      h_processor->words = 0;
+      return;
+   }
+   if ((s_track = malloc(strlen(s_pathname) + 1)) == NULL) v_error(h_err_register_alloc, __FILE__, __LINE__);
+   strcpy(s_track, s_pathname);
+   h_blank = h_new;
+   h_processor->crc[CARD] = True;
+}
 #endif
 
-#if defined(WOODSTOCK) || defined(SPICE) || defined(HP10) || defined(HP67)
-      case 00: /* Type 0 - Special operations */
-         switch ((i_opcode >> 2) & 03)
-         {
-         case 00: /* Op-Codes matching x xxx xx0 000 */
-            switch ((i_opcode >> 4) & 03)
-            {
-            case 00: /* Op-Codes matching x xxx 000 000 */
-               switch (i_opcode)
-               {
-               case 00000: /* nop */
-                  if (h_processor->trace) fprintf(stdout, "nop");
-                  break;
-#if defined(HP67)
-               /*
-                * 00100   Test ready
-                * 00300   Test W/PGM switch
-                * 00400   Set key pressed
-                * 00500   Test if a key was pressed
-                * 01000   Set default function keys
-                * 01100   Test if default function keys set
-                * 01200   Set merge flag
-                * 01300   Test merge flag
-                * 01400   Set waiting for card side 2 flag
-                * 01500   Test waiting for card side 2 flag
-                * 01700   Read/Write data to/from card via RAM $99 and $9B
-                */
-               case 00100: /* test motor on */
-                  if (h_processor->trace) fprintf(stdout, "test motor on");
-                  h_processor->status[3] = True; /* device always ready */
-                  h_processor->crc[CARD] = False;
-                  break;
-               case 00300: /* test mode flag */
-                  if (h_processor->trace) fprintf(stdout, "test mode flag (%d)", !h_processor->flags[MODE] );
-                  h_processor->status[3] = !h_processor->flags[MODE]; /* Test the PRGM/RUN switch */
-                  break;
-               case 00400: /* set key pressed flag */
-                  if (h_processor->trace) fprintf(stdout, "set key pressed flag");
-                  h_processor->crc[ANYKEY] = True; /* Sets the any key pressed flag */
-                  break;
-               case 00500: /* test key pressed flag */ /* f -x- */
-                  if (h_processor->trace) fprintf(stdout, "test key pressed flag");
-                  h_processor->status[3] = h_processor->crc[ANYKEY];
-                  if (h_processor->crc[ANYKEY]) h_processor->crc[ANYKEY] = False;
-                  break;
-               case 01000: /* set default function flag */
-                  if (h_processor->trace) fprintf(stdout, "set flag 4");
-                  h_processor->crc[FUNCTION] = True;
-                  break;
-               case 01100: /* test default function key flag */
-                  if (h_processor->trace) fprintf(stdout, "test flag 4");
-                  h_processor->status[3] = h_processor->crc[FUNCTION];
-                  if (h_processor->crc[FUNCTION]) h_processor->crc[FUNCTION] = False;
-                  break;
-               case 01200: /* set merge flag */
-                  if (h_processor->trace) fprintf(stdout, "set merge flag");
-                  h_processor->crc[MERGE] = True;
-                  break;
-               case 01300: /* test merge flag */
-                  if (h_processor->trace) fprintf(stdout, "clear flag 0");
-                  h_processor->status[3] = h_processor->crc[MERGE];
-                  if (h_processor->crc[MERGE]) h_processor->crc[MERGE] = False;
-                  break;
-               case 01400: /* set waiting flag */
-                  if (h_processor->trace) fprintf(stdout, "clear waiting flag");
-                  h_processor->crc[PAUSE] = True;
-                  break;
-               case 01500: /* test pause flag ? */
-                  if (h_processor->trace) fprintf(stdout, "clear flag 1");
-                  h_processor->status[3] = h_processor->crc[PAUSE];
-                  if (h_processor->crc[PAUSE]) h_processor->crc[PAUSE] = False;
-                  break;
-               case 01700: /* read from or write to card */
-                  if (h_processor->trace) fprintf(stdout, "card read write");
-                  h_processor->status[3] = h_processor->crc[PAUSE];
-                  if (h_processor->crc[PAUSE]) h_processor->crc[PAUSE] = False;
-                  break;
+#if defined(HP67) && (defined(unix) || defined(__unix__) || defined(__APPLE__))
+void v_read_card(oprocessor *h_processor, char *s_folder) /* Insert the next card in the folder */
+{
+   char s_first[sizeof(s_card)] = "", s_next[sizeof(s_card)] = "";
+   char *s_pathname;
+   struct dirent *h_entry;
+   DIR *h_folder;
+   int i_length;
+
+   if ((h_folder = opendir(s_folder)) == NULL)
+   {
+      v_warning(h_err_opening_file, s_folder);
+      return;
+   }
+   while ((h_entry = readdir(h_folder)) != NULL) /* Cards are read in order of their names */
+   {
+      i_length = strlen(h_entry->d_name);
+      if ((i_length < 5) || (i_length >= (int) sizeof(s_card)) || strcmp(h_entry->d_name + i_length - 4, ".crd")) continue;
+      if ((!*s_first) || (strcmp(h_entry->d_name, s_first) < 0))
+         strcpy(s_first, h_entry->d_name);
+      if ((strcmp(h_entry->d_name, s_card) > 0) && ((!*s_next) || (strcmp(h_entry->d_name, s_next) < 0)))
+         strcpy(s_next, h_entry->d_name);
+   }
+   closedir(h_folder);
+   if (!*s_next) strcpy(s_next, s_first); /* Start again with the first card */
+   if (!*s_next)
+   {
+      v_warning(h_err_no_cards, s_folder);
+      return;
+   }
+   strcpy(s_card, s_next);
+
+   if ((s_pathname = malloc(strlen(s_folder) + strlen(s_card) + 2)) == NULL) v_error(h_err_register_alloc, __FILE__, __LINE__);
+   sprintf(s_pathname, "%s/%s", s_folder, s_card);
+   v_card_insert(h_processor, s_pathname, NULL);
+   free(s_pathname);
+}
+
+void v_write_card(oprocessor *h_processor, char *s_folder) /* Insert a new blank card */
+{
+   char *s_pathname;
+   FILE *h_file;
+   int i_count, i_file = -1;
+
+   if (h_processor->crc[CARD]) return; /* There is already a card in the reader */
+   if ((s_pathname = malloc(strlen(s_folder) + 16)) == NULL) v_error(h_err_register_alloc, __FILE__, __LINE__);
+   for (i_count = 1; i_count < 1000; i_count++) /* Create the first unused card, so no one else can take its name */
+   {
+      sprintf(s_pathname, "%s/card-%03d.crd", s_folder, i_count);
+      if ((i_file = open(s_pathname, O_WRONLY | O_CREAT | O_EXCL, 0644)) >= 0) break;
+      if (errno != EEXIST) break;
+   }
+   if (i_file < 0)
+   {
+      if (i_count < 1000)
+         v_warning(h_err_opening_file, s_pathname);
+      else
+         v_warning(h_err_cards_full, s_folder); /* Never overwrite an existing card */
+   }
+   else if ((h_file = fdopen(i_file, "w")) == NULL)
+   {
+      close(i_file);
+      remove(s_pathname);
+      v_warning(h_err_opening_file, s_pathname);
+   }
+   else
+      v_card_insert(h_processor, s_pathname, h_file);
+   free(s_pathname);
+}
 #endif
-               default:
-                  if (h_processor->trace) fprintf(stdout, "\n");
-                  v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-               }
-               break;
-            case 01: /* Op-Codes matching x xxx 010 000 */
-               switch (i_opcode)
-               {
-               case 00020: /* keys -> rom address (0 000 010 000) */
-                  if (h_processor->trace) fprintf(stdout, "keys -> rom address");
-                  h_processor->pc &= 0xff00;
-                  v_delayed_rom(h_processor);
-                  h_processor->pc += h_processor->code;
-                  break;
-               case 00120: /* keys -> a[2:1] (0 001 010 000) */
-                  if (h_processor->trace) fprintf(stdout, "keys -> a\t\t");
-                  /* The HP10 and HP19C use this to get the state of the printer mode switch */
-#if defined(HP10)
-                  if (h_processor->print)
-                     h_processor->reg[A_REG]->nibble[1] = 0x1; /* HP10 - All = 1, Print = 2 (print with display off), Display = 4 */
-                  else
-                     h_processor->reg[A_REG]->nibble[1] = 0x4; /* HP19C/97 - Trace = 1, Normal = 2 (print with display off), Manual = 4 */
-#else
-                  h_processor->reg[A_REG]->nibble[2] = (h_processor->code >> 4); /* Put keycode in A_REG */
-                  h_processor->reg[A_REG]->nibble[1] = (h_processor->code & 0x0f);
+
+void v_processor_reset(oprocessor *h_processor) /* Reset processor */
+{
+   int i_count;
+   h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+   for (i_count = 0; i_count < REGISTERS - 2; i_count++) /*Clear the CPU registers and stack */
+      v_reg_copy(h_processor, h_processor->reg[i_count], NULL); /* Copying nothing to a register clears it */
+   for (i_count = 0; i_count < STACK_SIZE; i_count++) /* Clear the processor stack */
+      h_processor->stack[i_count] = 0;
+#if defined(CONTINIOUS)
+   if (h_processor->memory == NULL) /* Mapped memory is never cleared */
 #endif
-                  if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-                  break;
-               case 00220: /* a -> rom address */
-                  {
-                     int i_addr;
-                     if (h_processor->trace) fprintf(stdout, "a -> rom address");
-                     h_processor->pc &= 0x0ff00;
-                     i_addr = h_processor->pc + (h_processor->reg[A_REG]->nibble[2] << 4) + h_processor->reg[A_REG]->nibble[1];
-                     if (i_addr < ROM_SIZE)
-                         h_processor->pc = i_addr;
-                     else
-                     {
-                        if (h_processor->trace) fprintf(stdout, "\n");
-                        v_error(h_err_invalid_address, i_addr, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-                     }
-                     v_delayed_rom(h_processor);
-                  }
-                  break;
-               case 00320: /* reset twf */
-                  if (h_processor->trace) fprintf(stdout, "reset twf");
-                  break;
-               case 00420: /* binary */
-                  if (h_processor->trace) fprintf(stdout, "binary");
-                  h_processor->base = 16;
-                  break;
-               case 00520: /* rotate left a */
-                  if (h_processor->trace) fprintf(stdout, "rotate left a");
-                  {
-                     int c_temp, i_count;
-                     c_temp = h_processor->reg[A_REG]->nibble[REG_SIZE - 1];
-                     for (i_count = REG_SIZE - 1; i_count > 0; i_count--)
-                        h_processor->reg[A_REG]->nibble[i_count] = h_processor->reg[A_REG]->nibble[i_count - 1];
-                     h_processor->reg[A_REG]->nibble[0] = c_temp;
-                     h_processor->flags[PREV_CARRY] = h_processor->flags[CARRY] = False;
-                  }
-                  break;
-               case 00620: /* p - 1 -> p */
-                  if (h_processor->trace) fprintf(stdout, "p - 1 -> p\t\t\t");
-                  v_op_dec_p(h_processor);
-                  if (h_processor->trace) fprintf(stdout, "p = %d", h_processor->p);
-                  break;
-               case 00720: /* p + 1 -> p */
-                  if (h_processor->trace) fprintf(stdout, "p + 1 -> p\t\t\t");
-                  v_op_inc_p(h_processor);
-                  if (h_processor->trace) fprintf(stdout, "p = %d", h_processor->p);
-                  break;
-               case 01020: /* return */
-                  if (h_processor->trace) fprintf(stdout, "return");
-                  h_processor->sp = (h_processor->sp - 1) & (STACK_SIZE - 1); /* Update stack pointer */
-                  h_processor->pc = h_processor->stack[h_processor->sp]; /* Pop program counter from the stack */
-                  break;
-#if defined(HP10)
-               case 01120: /* pik1120 */
-                  if (h_processor->trace) fprintf(stdout, "pik1120\t\t");
-                  v_fprint_buffer (stdout, h_processor);
-                  h_processor->status[3] = True; /* Set status bit 3 if printer ready (it always will be!) */
-                  if (h_processor->trace) v_fprint_status(stdout, h_processor);
-                  break;
-               case 01220: /* pik1220 */
-                  if (h_processor->trace) fprintf(stdout, "pik1220\t\t");
-                  v_fprint_buffer (stdout, h_processor);
-                  h_processor->status[3] = True; /* Clear status bit 3 if printer is out of paper */
-                  if (h_processor->trace) v_fprint_status(stdout, h_processor);
-                  break;
-               case 01320: /* pik1320 */
-                  if (h_processor->trace) fprintf(stdout, "pik1320\t\t");
-                  v_fprint_buffer (stdout, h_processor);
-                  if (h_processor->keypressed && h_processor->code) h_processor->status[3] = True; /* Set status bit 3 if key is pressed and a key code is pending */
-                  if (h_processor->trace) v_fprint_status(stdout, h_processor);
-                  break;
-               case 01720: /* pik1720 print numeric (4 bit data)*/
-                  if (h_processor->trace) fprintf(stdout, "pik1720\t\t");
-                  if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-                  if (h_processor->buffer[h_processor->position] == 0x3f) h_processor->position++;
-                  {
-                     int i_count;
-                     for (i_count = 0; (i_count < REG_SIZE)  && (h_processor->reg[C_REG]->nibble[i_count] != 0xf); i_count++)
-                     {
-                        h_processor->position--;
-                        h_processor->buffer[h_processor->position] = (h_processor->reg[C_REG]->nibble[i_count] << 2) | 0x3;
-                     }
-                  }
-                  break;
+   for (i_count = 0; i_count < MEMORY_SIZE; i_count++) /*Clear memory */
+      v_reg_copy(h_processor, h_processor->mem[i_count], NULL); /* Copying nothing to a register clears it */
+   for (i_count = 0; i_count < STATUS_BITS; i_count++) /* Clear the processor status word */
+      h_processor->status[i_count] = False;
+   for (i_count = 0; i_count < FLAGS; i_count++) /* Clear the processor flags */
+      h_processor->flags[i_count] = False;
+   h_processor->opcode = 0;
+   h_processor->pc = 0;
+   h_processor->sp = 0;
+   h_processor->f = 0;
+   h_processor->p = 0;
+   h_processor->addr = 0;
+   h_processor->base = 10;
+   h_processor->code = 0;
+   h_processor->keypressed = False;
+   h_processor->head = h_processor->tail = 0; /* Discard any queued key events */
+   h_processor->ticks = h_processor->due = 0;
+   h_processor->enabled = True;
+   h_processor->sleep = False;
+#if defined(WOODSTOCK) || defined(SPICE) || defined(HP10) || defined(HP67)
+   h_processor->status[5] = True; /* TO DO - Check which flags should be set by default */
 #endif
-               default:
-                  if (h_processor->trace) fprintf(stdout, "\n");
-                  v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-               }
-               break;
-            case 02: /* Op-Codes matching x xxx 100 000 */ /* select rom */
-               if (h_processor->trace) fprintf(stdout, "select rom %02o", i_opcode >> 6);
-               h_processor->pc = ((i_opcode >> 6) << 8) + ((h_processor->pc) & 0xff);
-               break;
-            case 03: /* Op-Codes matching x xxx 110 000 */
-               switch (i_opcode)
-               {
 #if defined(HP67)
-               /*
-                * 00060   Set display digits
-                * 00160   Test display digits
-                * 00260   Motor on
-                * 00360   Motor off
-                * 00560   Test if card inserted
-                * 00660   Set card write mode
-                * 00760   Set card read mode
-                */
-               case 00060: /* set display digits */
-                  if (h_processor->trace) fprintf(stdout, "set display digits");
-                  h_processor->crc[DISPLAY] = True;
-                  break;
-               case 00160: /* test display digits */
-                  if (h_processor->trace) fprintf(stdout, "test display digits");
-                  h_processor->status[3] = h_processor->crc[DISPLAY];
-                  if (h_processor->crc[DISPLAY]) h_processor->crc[DISPLAY] = False;
-                  break;
-               case 00260: /* card reader motor on */
-                  if (h_processor->trace) fprintf(stdout, "motor on");
-                  break;
-               case 00360: /* card reader motor off */
-                  if (h_processor->trace) fprintf(stdout, "motor off");
-                  break;
-               case 00560: /* test card inserted */
-                  if (h_processor->trace) fprintf(stdout, "test card inserted");
-                  h_processor->status[3] = h_processor->crc[CARD]; /* Test if card is inserted */
-                  break;
-               case 00660: /* card reader set write mode */
-                  if (h_processor->trace) fprintf(stdout, "set write mode");
-                  break;
-               case 00760: /* card reader set read mode */
-                  if (h_processor->trace) fprintf(stdout, "set read mode");
-                  break;
+   for (i_count = 0; i_count < STATES; i_count++) /* Clear the processor flags */
+      h_processor->crc[i_count] = False;
+   h_processor->crc[READY] = -4;
+   v_card_eject(h_processor); /* Nothing is saved as the write mode has been cleared */
 #endif
-               case 01060: /* bank switch */
-                  if (h_processor->trace) fprintf(stdout, "bank switch");
-                  h_processor->flags[BANK_SWITCH] = (!h_processor->flags[BANK_SWITCH]); /* Toggle bank switch */
-                  h_processor->pc ^=  0x01000; /* Toggle bank */
-                  break;
-               case 01160: /* c -> data address */
-                  {
-                     int i_addr;
-                     if (h_processor->trace) fprintf(stdout, "c -> data address\t");
-                     i_addr = (h_processor->reg[C_REG]->nibble[1] << 4) + h_processor->reg[C_REG]->nibble[0];
 #if defined(HP10)
-                     if ((i_addr < MEMORY_SIZE) || (i_addr == 0xFF)) /* Address 0xFF tells the PIK chip to put the key code on the data bus */
-                        h_processor->addr = i_addr;
-                     else
-                     {
-                        h_processor->addr = MEMORY_SIZE - 1;
-                        if (h_processor->trace) fprintf(stdout, "\n");
-                        v_error(h_err_invalid_register, i_addr, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-                     }
-#else
-                     if (i_addr < MEMORY_SIZE)
-                        h_processor->addr = i_addr;
-                     else
-                     {
-                        h_processor->addr = MEMORY_SIZE - 1;
-                     }
+   h_processor->position = BUFSIZE;
+   for (i_count = 0; i_count < BUFSIZE; i_count++) /* Reset the character buffer contents */
+      h_processor->buffer[i_count] = 0x3f;
 #endif
-                  }
-                  if (h_processor->trace) fprintf(stdout, "\taddr = %d", h_processor->addr);
-                  break;
-               case 01260: /* clear data registers */
-                  {
-#if (defined(HP25) || defined(HP25c)) && defined(CONTINIOUS)
-                     /* Ignore the instruction */
+#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
+   h_processor->q = 0;
+   h_processor->ptr = False;
+   h_processor->flags[CARRY] = True;
 #else
-                     int i_count;
-                     if (h_processor->trace) fprintf(stdout, "clear data registers");
-#if (defined(HP67)) && defined(CONTINIOUS)
-                     if (h_processor->crc[READY])
-                        h_processor->crc[READY]++;
-                     else
-#endif
-                     {
-                        h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                        for (i_count = h_processor->addr & ~0x0f; i_count < (h_processor->addr & ~0x0f) + 16; i_count++)
-                        {
-                           if (i_count < MEMORY_SIZE) /* Check memory size */
-                              v_reg_copy(h_processor, h_processor->mem[i_count], NULL); /* Copying nothing to a register clears it */
-                        }
-                     }
-#endif
-                  }
-                  break;
-               case 01360: /* c -> data */
-                  if (h_processor->trace) fprintf(stdout, "c -> data\t\t");
-                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                  v_reg_copy(h_processor, h_processor->mem[h_processor->addr], h_processor->reg[C_REG]);
-                  if (h_processor->trace)
-                     v_fprint_register(stdout, h_processor->mem[h_processor->addr]);
-                  break;
-#if defined(HP10)
-               case 01660: /* pik1660 print alpha (6 bit data)*/
-                  if (h_processor->trace) fprintf(stdout, "pik1660");
-                  {
-                     int i_counter = 0;
-                     int i_count;
-                     for (i_count = 0; (i_count < REG_SIZE - 1) && (h_processor->position >= 0); i_count++)
-                     {
-                        h_processor->position--;
-                        if((i_counter & 1) == 0) /* Even numbered nibble */
-                        {
-                           h_processor->buffer[h_processor->position] = (h_processor->reg[C_REG]->nibble[i_count]) | ((h_processor->reg[C_REG]->nibble[i_count + 1]) & 0x3) << 4;
-                        }
-                        else
-                        {
-                           h_processor->buffer[h_processor->position] = ((h_processor->reg[C_REG]->nibble[i_count]) >> 2) | (h_processor->reg[C_REG]->nibble[i_count + 1]) << 2;
-                           i_count++;
-                        }
-                        i_counter++;
-                        if (h_processor->buffer[h_processor->position] == 0x3f) i_count = REG_SIZE;
-                     }
-                  }
-                  break;
-#endif
-               case 01460: /* rom checksum */
-                  if (h_processor->trace) fprintf(stdout, "rom checksum");
-                  h_processor->status[5] = False;
-                  h_processor->sp = (h_processor->sp - 1) & (STACK_SIZE - 1); /* Update stack pointer */
-                  h_processor->pc = h_processor->stack[h_processor->sp]; /* Pop program counter on the stack */
-                  break;
-               case 01760: /* hi I'm woodstock */
-                  if (h_processor->trace) fprintf(stdout, "hi I'm woodstock");
-                  break;
-               default:
-                  if (h_processor->trace) fprintf(stdout, "\n");
-                  v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-               }
-            }
-            break;
-         case 01: /* Op-Codes matching x xxx xx0 100 */
-            switch ((i_opcode >> 4) & 03)
-            {
-            case 00: /* 1 -> s(n) */
-               if (h_processor->trace) fprintf(stdout, "1 -> s(%d)\t\t", i_opcode >> 6);
-               h_processor->status[i_opcode >> 6] = True;
-               if (h_processor->trace) v_fprint_status(stdout, h_processor);
-               break;
-            case 01: /* if 1 = s(n) */
-               if (h_processor->trace) fprintf(stdout, "if 1 = s(%d)", i_opcode >> 6);
-               h_processor->flags[CARRY] = h_processor->status[i_opcode >> 6];
-               v_op_goto(h_processor);
-               break;
-            case 02: /* if p = n */
-               if (h_processor->trace) fprintf(stdout, "if p = %d", i_tst_p[i_opcode >> 6]);
-               h_processor->flags[CARRY] = (h_processor->p == i_tst_p[i_opcode >> 6]);
-               v_op_goto(h_processor);
-               break;
-            case 03: /* delayed select rom n */
-               if (h_processor->trace) fprintf(stdout, "delayed select rom %d", i_opcode >> 6);
-               h_processor->rom_number = i_opcode >> 6;
-               h_processor->flags[DELAYED_ROM] = True;
-            }
-            break;
-         case 02: /* Op-Codes matching x xxx xx1 000 */
-            switch ((i_opcode >> 4) & 03)
-            {
-            case 00: /* Op-Codes matching x xxx 001 000 */
-               switch (i_opcode)
-               {
-               case 00010: /* clear registers */
-                  if (h_processor->trace) fprintf(stdout, "clear registers");
-                  {
-                     int i_count;
-                     h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                     for (i_count = 0; i_count < REGISTERS - 2; i_count++) /* Don't clear M or N */
-                        v_reg_copy(h_processor, h_processor->reg[i_count], NULL); /* Copying nothing to a register clears it */
-                  }
-                  break;
-               case 00110: /* clear status */
-                  if (h_processor->trace) fprintf(stdout, "clear status\t");
-                  {
-                     int i_count;
-                     for (i_count = 0; i_count < sizeof(h_processor->status) / sizeof(*h_processor->status); i_count++)
-                        switch (i_count) {
-                           case 1:  /* Scientific notation */
-                           case 2:  /* Auto Enter (if set entering digit will push 'X') */
-#if (!defined(HP10))
-                           case 5:  /* Low power (Woodstock) / Self test (Spice) */
-#endif
-                           case 15: /* Set if any key is pressed */
-                              break;
-                           default:
-                              h_processor->status[i_count] = False; /* Clear all bits except bits 1, 2, 5, 15 */
-                        }
-                  }
-               if (h_processor->trace) v_fprint_status(stdout, h_processor);
-                  break;
-               case 00210: /* display toggle */
-                  if (h_processor->trace) fprintf(stdout, "display toggle");
-                  h_processor->flags[DISPLAY_ENABLE] = (!h_processor->flags[DISPLAY_ENABLE]);
-                  break;
-               case 00310: /* display off */
-                  if (h_processor->trace) fprintf(stdout, "display off");
-                  h_processor->flags[DISPLAY_ENABLE] = False;
-                  break;
-               case 00410: /* m exch c */
-                  if (h_processor->trace) fprintf(stdout, "m exch c\t\t");
-                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                  v_reg_exch(h_processor, h_processor->reg[M_REG], h_processor->reg[C_REG]);
-                  if (h_processor->trace)
-                  {
-                     v_fprint_register(stdout,h_processor->reg[C_REG]);
-                     v_fprint_register(stdout,h_processor->reg[M_REG]);
-                  }
-                  break;
-               case 00510: /* m -> c */
-                  if (h_processor->trace) fprintf(stdout, "m -> c\t\t");
-                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                  v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->reg[M_REG]);
-                  if (h_processor->trace)
-                     v_fprint_register(stdout,h_processor->reg[C_REG]);
-                  break;
-               case 00610: /* n exch c */
-                  if (h_processor->trace) fprintf(stdout, "n exch c\t\t");
-                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                  v_reg_exch(h_processor, h_processor->reg[N_REG], h_processor->reg[C_REG]);
-                  if (h_processor->trace)
-                  {
-                     v_fprint_register(stdout,h_processor->reg[C_REG]);
-                     v_fprint_register(stdout,h_processor->reg[N_REG]);
-                  }
-                  break;
-               case 00710: /* n -> c */
-                  if (h_processor->trace) fprintf(stdout, "n -> c\t\t");
-                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                  v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->reg[N_REG]);
-                  if (h_processor->trace)
-                     v_fprint_register(stdout,h_processor->reg[C_REG]);
-                  break;
-               case 01010: /* stack -> a */
-                  if (h_processor->trace) fprintf(stdout, "stack -> a");
-                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                  v_reg_copy(h_processor, h_processor->reg[A_REG], h_processor->reg[Y_REG]); /* A = Y */
-                  v_reg_copy(h_processor, h_processor->reg[Y_REG], h_processor->reg[Z_REG]); /* Y = Z */
-                  v_reg_copy(h_processor, h_processor->reg[Z_REG], h_processor->reg[T_REG]); /* Z = T */
-                  if (h_processor->trace)
-                  {
-                     v_fprint_register(stdout,h_processor->reg[A_REG]);
-                     v_fprint_register(stdout,h_processor->reg[Y_REG]);
-                     v_fprint_register(stdout,h_processor->reg[Z_REG]);
-                  }
-                  break;
-               case 01110: /* down rotate */
-                  if (h_processor->trace) fprintf(stdout, "down rotate\t");
-                     h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                     v_reg_exch(h_processor, h_processor->reg[T_REG], h_processor->reg[C_REG]); /* T <> C - C to T */
-                     v_reg_exch(h_processor, h_processor->reg[C_REG], h_processor->reg[Y_REG]); /* C <> Y - Y to C */
-                     v_reg_exch(h_processor, h_processor->reg[Y_REG], h_processor->reg[Z_REG]); /* Y <> Z - Z to Y and T ends up in Z */
-                     if (h_processor->trace)
-                     {
-                        v_fprint_register(stdout,h_processor->reg[C_REG]);
-                        v_fprint_register(stdout,h_processor->reg[Y_REG]);
-                        v_fprint_register(stdout,h_processor->reg[Z_REG]);
-                        v_fprint_register(stdout,h_processor->reg[T_REG]);
-                     }
-                  break;
-               case 01210: /* y -> a */
-                  if (h_processor->trace) fprintf(stdout, "y -> a\t\t");
-                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                  v_reg_copy(h_processor, h_processor->reg[A_REG], h_processor->reg[Y_REG]);
-                  if (h_processor->trace)
-                     v_fprint_register(stdout,h_processor->reg[A_REG]);
-                  break;
-               case 01310: /* c _> stack */
-                  if (h_processor->trace) fprintf(stdout, "c -> stack\t\t");
-                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                  v_reg_copy(h_processor, h_processor->reg[T_REG], h_processor->reg[Z_REG]); /* T = Z */
-                  v_reg_copy(h_processor, h_processor->reg[Z_REG], h_processor->reg[Y_REG]); /* T = Z */
-                  v_reg_copy(h_processor, h_processor->reg[Y_REG], h_processor->reg[C_REG]); /* T = Z */
-                  if (h_processor->trace)
-                  {
-                     v_fprint_register(stdout,h_processor->reg[C_REG]);
-                     v_fprint_register(stdout,h_processor->reg[Y_REG]);
-                     v_fprint_register(stdout,h_processor->reg[Z_REG]);
-                     v_fprint_register(stdout,h_processor->reg[T_REG]);
-                  }
-                  break;
-               case 01410: /* decimal */
-                  if (h_processor->trace) fprintf(stdout, "decimal");
-                  h_processor->base = 10;
-                  break;
-               case 01610: /* f -> a */
-                  h_processor->reg[A_REG]->nibble[0] = h_processor->f;
-                  if (h_processor->trace) fprintf(stdout, "f -> a\t\t");
-                  if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-                  break;
-               case 01710: /* f exch a */
-                  if (h_processor->trace) fprintf(stdout, "f exch a\t\t");
-                  {
-                     int i_temp;
-                     i_temp = h_processor->reg[A_REG]->nibble[0];
-                     h_processor->reg[A_REG]->nibble[0] = h_processor->f;
-                     h_processor->f = i_temp;
-                  }
-                  if (h_processor->trace)
-                  {
-                     v_fprint_register(stdout,h_processor->reg[A_REG]);
-                     fprintf(stdout, "\tf = %02x", h_processor->f);
-                  }
-                  break;
-               default:
-                  if (h_processor->trace) fprintf(stdout, "\n");
-                  v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-               }
-               break;
-            case 01: /* load constant n */
-               if (h_processor->trace) fprintf(stdout, "load constant %d\t", i_opcode >> 6);
-               h_processor->reg[C_REG]->nibble[h_processor->p] = i_opcode >> 6;
-               v_op_dec_p(h_processor);
-               if (h_processor->trace)
-               {
-                  v_fprint_register(stdout,h_processor->reg[C_REG]);
-                  fprintf(stdout, "\tp = %d", h_processor->p);
-               }
-               break;
-            case 02: /* c -> data register(n) */
-               h_processor->addr &= 0xfff0;
-               h_processor->addr += (i_opcode >> 6);
-               if (h_processor->trace) fprintf(stdout, "c -> data register(%d)", h_processor->addr);
-               if ((h_processor->addr) < MEMORY_SIZE)
-               {
-                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                  v_reg_copy(h_processor, h_processor->mem[h_processor->addr], h_processor->reg[C_REG]); /* C -> reg(n) */
-               }
-               else
-               {
-                  if (h_processor->trace) fprintf(stdout, "\n");
-                  v_error(h_err_invalid_address, i_opcode >> 6, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-               }
-               break;
-            case 03: /* data -> c or data register(n)-> c */
-               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-               if ((i_opcode >> 6) == 0)
-               {
-                  if (h_processor->trace) fprintf(stdout, "data -> c\t\t");
-                  v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->mem[h_processor->addr]);
-               }
-#if defined(HP10)
-               else if (((i_opcode >> 6) == 0xf) && (h_processor->addr == 0xff))
-               {
-                  if (h_processor->trace) fprintf(stdout, "data -> c\t\t");
-                  h_processor->reg[C_REG]->nibble[2] = (h_processor->code >> 4);
-                  h_processor->reg[C_REG]->nibble[1] = (h_processor->code & 0x0f);
-                  h_processor->reg[C_REG]->nibble[0] = 0;
-                  h_processor->code = 0; /* Clear the key code (so it isn't read twice if the key is held down) */
-               }
+   h_processor->rom_number = 0;
 #endif
-               else
-               {
-                  h_processor->addr &= 0xfff0;
-                  h_processor->addr += (i_opcode >> 6);
-                  if (h_processor->trace) fprintf(stdout, "data register(%d) -> c", h_processor->addr);
-                  if ((h_processor->addr) < MEMORY_SIZE)
-                     v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->mem[h_processor->addr]);
-                  else
-                  {
-                     if (h_processor->trace) fprintf(stdout, "\n");
-                     v_error(h_err_invalid_address, h_processor->addr, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-                  }
-               }
-               if (h_processor->trace)
-                  v_fprint_register(stdout,h_processor->reg[C_REG]);
-               break;
-            default:
-               if (h_processor->trace) fprintf(stdout, "\n");
-               v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            break;
+}
 
-         case 03: /* Op-Codes matching x xxx xx1 100 */
-            switch ((i_opcode >> 4) & 03)
-            {
-            case 00: /* 0 -> s(n) */
-               if (h_processor->trace) fprintf(stdout, "0 -> s(%d)\t\t", i_opcode >> 6);
-               h_processor->status[i_opcode >> 6] = False;
-               if (h_processor->trace) v_fprint_status(stdout, h_processor);
-               break;
-            case 01: /* if 0 = s(n) */
-               if (h_processor->trace) fprintf(stdout, "if 0 = s(%d) ", i_opcode >> 6);
-               h_processor->flags[CARRY] = !h_processor->status[i_opcode >> 6];
-               v_op_goto(h_processor);
-               break;
-            case 02: /* if p != n */
-               /* 01354 if p !=  0  00554 if p !=  1  00354 if p !=  2
-                * 00754 if p !=  3  00054 if p !=  4  01254 if p !=  5
-                * 00654 if p !=  6  01654 if p !=  7  00154 if p !=  8
-                * 00454 if p !=  9  01554 if p != 10  01454 if p != 11
-                * 00254 if p != 12  01154 if p != 13  N/A   if p != 14
-                * N/A   if p != 15
-               */
-               if (h_processor->trace) fprintf(stdout, "if p != %d", i_tst_p[i_opcode >> 6]);
-               h_processor->flags[CARRY] = (h_processor->p != i_tst_p[i_opcode >> 6]);
-               v_op_goto(h_processor);
-               break;
-            case 03: /* n -> p*/
-               /* 01474  0 -> p  01074  1 -> p  00574  2 -> p
-                * 01174  3 -> p  00174  4 -> p  01674  5 -> p
-                * 01374  6 -> p  00274  7 -> p  00374  8 -> p
-                * 01574  9 -> p  00674 10 -> p  00474 11 -> p
-                * 00774 12 -> p  01274 13 -> p  N/A   14 -> p
-                * N/A   15 -> p
-                * */
-               if (h_processor->trace) fprintf(stdout, "%d -> p\t\t\t", i_set_p[i_opcode >> 6]);
-               h_processor->p = i_set_p[i_opcode >> 6];
-               if (h_processor->trace) fprintf(stdout, "p = %d", h_processor->p);
-               break;
-            }
-            break;
-         }
-         break;
-#endif
+int i_processor_key(oprocessor *h_processor, unsigned int i_code, int b_pressed) /* Queue a key event */
+{
+   unsigned int i_used;
+   okey *h_key;
 
-#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
-      case 0x00: /* Type 0 - Special operations */
-         switch ((i_opcode >> 2) & 0xf)
-         {
-         case 0x00:
-            switch (i_opcode >> 6)
-            {
-            case 0x00: /* No operation (00 0000 0000) */
-               if (h_processor->trace) fprintf(stdout, "nop");
-               break;
-            default:
-               if (h_processor->trace) fprintf(stdout, "\n");
-               v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            break;
+   i_used = (h_processor->tail + KEY_EVENTS - h_processor->head) % KEY_EVENTS;
+   if (i_used >= KEY_EVENTS - (b_pressed ? 2 : 1)) return(False); /* Always leave room to release a key that was pressed */
+   if (i_used == 0) /* Nothing queued so the event is due now unless the last one was too recent */
+   {
+      if ((long) (h_processor->due - h_processor->ticks) < 0) h_processor->due = h_processor->ticks;
+   }
+   h_key = &h_processor->key[h_processor->tail];
+   h_key->time = h_processor->due;
+   h_key->code = i_code;
+   h_key->pressed = b_pressed;
+   h_processor->due += (b_pressed ? KEY_HOLD : KEY_DELAY); /* Time until the next event can be processed */
+   h_processor->tail = (h_processor->tail + 1) % KEY_EVENTS;
+   return(True);
+}
 
-         case 0x01: /* 0 -> status[7:0] - Clear status (11 1100 0100) or 0 -> status[d] - Clear status bit (dd dd00 0100) */
-            if ((i_opcode >> 6) == 7) /* Reserved opcode (01 1100 0100) */
-            {
-               if (h_processor->trace) fprintf(stdout, "\n");
-               v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            if ((i_opcode >> 6) < 15)
-            {
-               if (h_processor->trace) fprintf(stdout, "st = 0 %-2d\t\t", n_map_i[i_opcode >> 6]);
-               h_processor->status[n_map_i[i_opcode >> 6]] = False;
-            }
-            else
-            {
-               int i_count;
-               if (h_processor->trace) fprintf(stdout, "clrst\t\t");
-               for (i_count = 7; i_count >= 0; i_count--) /* Note only clears bits 7-0 of the status register */
-                  h_processor->status[n_map_i[i_opcode >> 6]] = False;
-            }
-            if (h_processor->trace) v_fprint_status(stdout, h_processor);
-            break;
-         case 0x02: /* 0 -> kyf  - Reset keyboard (11 1100 1000) or 1 -> status[d] - Set status bit (dd dd00 0100) */
-            if ((i_opcode >> 6) == 7) /* Reserved opcode (01 1100 1000) */
-            {
-               if (h_processor->trace) fprintf(stdout, "\n");
-               v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            if ((i_opcode >> 6) < 15)
-            {
-               if (h_processor->trace) fprintf(stdout, "st = 1 %-2d\t\t", n_map_i[i_opcode >> 6]);
-               h_processor->status[n_map_i[i_opcode >> 6]] = True;
-               if (h_processor->trace) v_fprint_status(stdout, h_processor);
-            }
-            else
-            {
-               if (h_processor->trace) fprintf(stdout, "rstkb");
-               if (!h_processor->keypressed) h_processor->flags[CARRY] = h_processor->kyf = False; /* Clear keyboard flag if no key pressed */
-            }
-            break;
-         case 0x03: /* Test status bit [dddd] if 0 <= dddd <= 14 (dd dd00 1100) or test keyboard (11 1100 1100) */
-            if ((i_opcode >> 6) == 7) /* Reserved opcode (01 1100 1100) */
-            {
-               if (h_processor->trace) fprintf(stdout, "\n");
-               v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            if ((i_opcode >> 6) < 15)
-            {
-               if (h_processor->trace) fprintf(stdout, "? st = 1 %-2d", n_map_i[i_opcode >> 6]);
-               h_processor->flags[CARRY] = h_processor->status[n_map_i[i_opcode >> 6]];
-            }
-            else
-            {
-               if (h_processor->trace) fprintf(stdout, "chkkb ");
-               h_processor->flags[CARRY] = h_processor->kyf;
-            }
-            break;
-         case 0x04: /* nn -> c[pt] - Load constant n (nn nn01 0000) */
-            if (h_processor->trace) fprintf(stdout, "lc %1x\t\t", i_opcode >> 6);
-            h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor)] = i_opcode >> 6;
-            v_op_dec_pt(h_processor);
-            if (h_processor->trace)
-               v_fprint_register(stdout, h_processor->reg[C_REG]);
-            break;
-         case 0x05: /* Test pointer equal to dddd if 0 <= dddd <= 14 (dd dd00 1100) or decrement pointer (11 1101 0100) */
-            if ((i_opcode >> 6) == 7) /* Reserved opcode (01 1101 0100) */
-            {
-               if (h_processor->trace) fprintf(stdout, "\n");
-               v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            if ((i_opcode >> 6) < 15)
-            {
-               if (h_processor->trace) fprintf(stdout, "? pt = %d", n_map_i[i_opcode >> 6]);
-               h_processor->flags[CARRY] = (*h_active_pointer(h_processor) == n_map_i[i_opcode >> 6]);
-            }
-            else
-            {
-               if (h_processor->trace) fprintf(stdout, "dec pt");
-               v_op_dec_pt(h_processor);
-            }
-            break;
+static void v_processor_keys(oprocessor *h_processor) /* Pass any key events that are due on to the processor */
+{
+   okey *h_key;
 
-         case 0x06:
-            switch (i_opcode >> 6)
-            {
-            case 0x0: /* Reserved opcode (00 0001 1000) */
-               if (h_processor->trace) fprintf(stdout, "\n");
-               v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-               break;
-            case 0x01: /* c[pt + 1:pt] -> g - Load g from c (00 0101 1000) */
-               if (h_processor->trace) fprintf(stdout, "g = c\t\t");
-               h_processor->g[0]  = h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor)] & 0x0f; /* c[pt] -> g[0] */
-               if (*h_active_pointer(h_processor) < (REG_SIZE - 1))  /* Check that pt + 1 is valid */
-                  h_processor->g[1] = h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor) + 1] & 0x0f; /* c[pt + 1] -> g[1] */
-               if (h_processor->trace)
-                  fprintf(stdout, "g = 0x%02x", h_processor->g[0] | (h_processor->g[1] << 4));
-               break;
-            case 0x02: /* g -> c[pt + 1:pt] - Load c from g (00 0101 1000) */
-               if (h_processor->trace) fprintf(stdout, "c = g\t\t");
-               h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor)] = h_processor->g[0]; /* g[0] -> c[pt] */
-               if (*h_active_pointer(h_processor) < (REG_SIZE - 1))  /* Check that pt + 1 is valid */
-                  h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor) + 1] = h_processor->g[1]; /* g[1] -> c[pt + 1] */
-               if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
-               break;
-            case 0x03: /* g -> c[pt + 1:pt], c[pt + 1:pt] -> g - Exchange c and g (00 1101 1000 */
-               if (h_processor->trace) fprintf(stdout, "cgex\t\t");
-               {
-                  int i_temp[2];
-                  i_temp[0] = h_processor->g[0]; i_temp[1] = h_processor->g[1];
-                  h_processor->g[0] = h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor)] & 0x0f; /* c[pt] -> g[0] */
-                  h_processor->g[1] = 0; /* (0 -> g[1]) */
-                  h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor)] = i_temp[0]; /* g[0] -> c[pt] */
-                  if (*h_active_pointer(h_processor) < (REG_SIZE - 1))  /* Check that pt + 1 is valid */
-                  {
-                     h_processor->g[1] = h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor) + 1] & 0x0f; /* c[pt + 1] -> g[1] */
-                     h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor) + 1] = i_temp[1]; /* g[1] -> c[pt + 1] */
-                  }
-               }
-               if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
-               if (h_processor->trace) fprintf(stdout, "g = 0x%02x", h_processor->g[0] | (h_processor->g[1] << 4));
-               break;
-            case 0x05: /* c -> m - Copy C register to M register (01 0101 1000) */
-               if (h_processor->trace) fprintf(stdout, "m = c\t\t");
-               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-               v_reg_copy(h_processor, h_processor->reg[M_REG], h_processor->reg[C_REG]);
-               if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[M_REG]);
-               break;
-            case 0x06: /* m -> c - Copy M register to C register (01 1001 1000) */
-               if (h_processor->trace) fprintf(stdout, "c = m\t\t");
-               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-               v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->reg[M_REG]);
-               if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
-               break;
-            case 0x07: /* c -> m, m -> c - Exchange C register and M register (01 1101 1000) */
-               if (h_processor->trace) fprintf(stdout, "cmex\t\t");
-               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-               v_reg_exch(h_processor, h_processor->reg[M_REG], h_processor->reg[C_REG]);
-               if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
-               if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[M_REG]);
-               break;
-            case 0x0e: /* st[0:7] -> c[0:1] - Load c register from the status byte (11 1001 1000) */
-               if (h_processor->trace) fprintf(stdout, "c = st\t\t");
-               {
-                  int i_status, i_count;
-                  i_status = 0;
-                  for (i_count = 7; i_count >= 0 ; i_count--)
-                  {
-                     i_status <<= 1;
-                     if (h_processor->status[i_count]) i_status |= 0x1;
-                  }
-                  h_processor->reg[C_REG]->nibble[0] = i_status & 0xf;
-                  h_processor->reg[C_REG]->nibble[1] = i_status >> 4;
-               }
-               if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
-               break;
-            case 0x0f: /* c[0:1] -> st[0:7], st[0:7] -> c[0:1] - Exchange c register and the status byte (11 1101 1000) */
-               if (h_processor->trace) fprintf(stdout, "cstex\t\t");
-               {
-                  int i_temp, i_status, i_count;
-                  i_status = 0; /* Save st[0:7] */
-                  for (i_count = 7; i_count >= 0 ; i_count--)
-                  {
-                     i_status <<= 1;
-                     if (h_processor->status[i_count]) i_status |= 0x1;
-                  }
-                  i_temp = h_processor->reg[C_REG]->nibble[0] | h_processor->reg[C_REG]->nibble[1] << 4;
-                  for (i_count = 0; i_count <=7; i_count++)
-                  {
-                     if (i_temp & 0x1)
-                        h_processor->status[i_count] = True;
-                     else
-                        h_processor->status[i_count] = False;
-                     i_temp >>= 1;
-                  }
-                  h_processor->reg[C_REG]->nibble[0] = i_status & 0xf;
-                  h_processor->reg[C_REG]->nibble[1] = i_status >> 4;
-               }
-               if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
-               if (h_processor->trace) v_fprint_status(stdout, h_processor);
-               break;
-            default:
-               if (h_processor->trace) fprintf(stdout, "\n");
-               debug(fprintf(stderr,"%02x\n", (i_opcode >> 6) & 0xf));
-               v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            break;
-         case 0x07: /* Load pointer with dddd if 0 <= dddd <= 14 (dd dd00 1100) or decrement pointer (11 1101 0100) */
-            if ((i_opcode >> 6) == 7) /* Reserved opcode (01 1101 0100)*/
-            {
-               if (h_processor->trace) fprintf(stdout, "\n");
-               v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            if ((i_opcode >> 6) < 15)
-            {
-               if (h_processor->trace) fprintf(stdout, "pt = %d", n_map_i[i_opcode >> 6]);
-               *h_active_pointer(h_processor) = n_map_i[i_opcode >> 6];
-               if (h_processor->trace) fprintf(stdout, "\t\tpt = %02d  ", *h_active_pointer(h_processor));
-            }
-            else
-            {
-               if (h_processor->trace) fprintf(stdout, "inc pt");
-               v_op_inc_pt(h_processor);
-            }
-            break;
+   h_processor->ticks++;
+   while ((h_processor->head != h_processor->tail) && ((long) (h_processor->ticks - h_processor->key[h_processor->head].time) >= 0))
+   {
+      h_key = &h_processor->key[h_processor->head];
+      if (h_key->pressed)
+      {
+         h_processor->code = h_key->code;
+         h_processor->keypressed = True;
+#if !defined(SWITCHES)
+         h_processor->enabled = True; /* Any key press will wake up the processor */
+         h_processor->sleep = False;
+#endif
+      }
+      else
+         h_processor->keypressed = False; /* Don't clear the status bit here!! */
+      h_processor->head = (h_processor->head + 1) % KEY_EVENTS;
+   }
+}
 
-         case 0x08: /* xxxx 10 0000 */
-            switch ((i_opcode >> 6) & 0xf)
-            {
-            case 0x01: /* Power off (00 0110 0000) */
-               if (h_processor->trace) fprintf(stdout, "powoff");
-               if (h_processor->flags[DISPLAY_ENABLE]) /* Sleep */
-               {
-                  h_processor->sleep = True;
-               }
-               else  /* Poweroff */
-               {
-                  h_processor->flags[CARRY] = True; /* Carry set on deep sleep */
-                  h_processor->enabled = False;
-               }
-               h_processor->pc = 0;
-               break;
-            case 0x02: /* pt = p - Select pointer p (00 1010 0000) */
-               if (h_processor->trace) fprintf(stdout, "sel p\t\t");
-               h_processor->ptr = False;
-               break;
-            case 0x03: /* pt = q - Select pointer q (00 1110 0000) */
-               if (h_processor->trace) fprintf(stdout, "sel q\t\t");
-               h_processor->ptr = True;
-               break;
-            case 0x04: /* ? p == q - Test p equal to q  (01 0010 0000) */
-               if (h_processor->trace) fprintf(stdout, "? p = q\t\t");
-               if (h_processor->p == h_processor->q) h_processor->flags[CARRY] = True;
-               break;
-            case 0x05: /* ? low level detect - Test battery state (01 0110 0000) */
-               if (h_processor->trace) fprintf(stdout, "? lld\t\t");
-               /* Do nothing - battery can never go flat */
-               break;
-            case 0x06: /* 0 -> a, 0 -> b, 0 -> c - Clear registers a, b and c (01 1010 0000) */
-               if (h_processor->trace) fprintf(stdout, "clrabc\t\t");
-               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-               v_reg_copy(h_processor, h_processor->reg[A_REG], NULL);
-               v_reg_copy(h_processor, h_processor->reg[B_REG], NULL);
-               v_reg_copy(h_processor, h_processor->reg[C_REG], NULL);
-               if (h_processor->trace)
-               {
-                  v_fprint_register(stdout, h_processor->reg[A_REG]);
-                  v_fprint_register(stdout, h_processor->reg[B_REG]);
-                  v_fprint_register(stdout, h_processor->reg[C_REG]);
-               }
-               break;
-            case 0x07: /* c[6:3] -> pc - Branch using C register (01 1110 0000) */
-               if (h_processor->trace) fprintf(stdout, "goto c\t\t");
-               h_processor->pc = (((h_processor->reg[C_REG]->nibble[6])<< 12) |
-                  (h_processor->reg[C_REG]->nibble[5] << 8) |
-                  (h_processor->reg[C_REG]->nibble[4] << 4) |
-                  (h_processor->reg[C_REG]->nibble[3]));
-               break;
-            case 0x08: /* keys -> c[4:3] - Load c from keys (10 0010 0000) */
-               if (h_processor->trace) fprintf(stdout, "c = keys\t\t");
-               h_processor->reg[C_REG]->nibble[3] = h_processor->code & 0xf;
-               h_processor->reg[C_REG]->nibble[4] = (h_processor->code >> 4) & 0xf;
-               if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
-               break;
-            case 0x09: /* 0 -> decimal - Set hex mode(10 0110 0000) */
-               if (h_processor->trace) fprintf(stdout, "sethex");
-               h_processor->base = 16;
-               break;
-            case 0x0a: /* 1 -> decimal - Set decimal mode (10 0110 0000) */
-               if (h_processor->trace) fprintf(stdout, "setdec");
-               h_processor->base = 10;
-               break;
-            case 0x0b: /* 0 -> display - Display off (10 1110 0000) */
-               if (h_processor->trace) fprintf(stdout, "disoff");
-               h_processor->flags[DISPLAY_ENABLE] = False;
-               break;
-            case 0x0c: /* ~display -> display - Display toggle (10 1110 0000) */
-               if (h_processor->trace) fprintf(stdout, "distog");
-               h_processor->flags[DISPLAY_ENABLE] = !h_processor->flags[DISPLAY_ENABLE];
-               break;
-            case 0x0d: /* if carry stack[0] -> pc, stack[1] -> stack[0], stack[2] -> stack[1], stack[3] -> stack[2], 0 -> stack[3] - Return if carry (11 0110 0000) */
-               if (h_processor->trace) fprintf(stdout, "rtn c");
-               if (h_processor->flags[PREV_CARRY])
-               {
-                  h_processor->sp = (h_processor->sp - 1) & (STACK_SIZE - 1); /* Update stack pointer */
-                  h_processor->pc = h_processor->stack[h_processor->sp]; /* Pop program counter from the stack */
-               }
-               break;
-            case 0x0e: /* if !carry stack[0] -> pc, stack[1] -> stack[0], stack[2] -> stack[1], stack[3] -> stack[2], 0 -> stack[3] - Return if no carry (11 1010 0000) */
-               if (h_processor->trace) fprintf(stdout, "rtn nc");
-               if (!h_processor->flags[PREV_CARRY])
-               {
-                  h_processor->sp = (h_processor->sp - 1) & (STACK_SIZE - 1); /* Update stack pointer */
-                  h_processor->pc = h_processor->stack[h_processor->sp]; /* Pop program counter from the stack */
-               }
-               break;
-            case 0x0f: /* stack[0] -> pc, stack[1] -> stack[0], stack[2] -> stack[1], stack[3] -> stack[2], 0 -> stack[3] - Return (11 1110 0000) */
-               if (h_processor->trace) fprintf(stdout, "rtn");
-               h_processor->sp = (h_processor->sp - 1) & (STACK_SIZE - 1); /* Update stack pointer */
-               h_processor->pc = h_processor->stack[h_processor->sp]; /* Pop program counter from the stack */
-               break;
-            default:
-               if (h_processor->trace) fprintf(stdout, "\n");
-               debug(fprintf(stderr,"%02x\n", (i_opcode >> 6) & 0xf));
-               v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            break;
-         case 0x0a: /* {addr[11:4], nnnn} -> addr, c -> reg[addr] - Load register from c (nn nn10 1000) */
-            if (h_processor->trace) fprintf(stdout, "regn = c %-2d", (i_opcode >> 6));
-            h_processor->addr = (h_processor->addr & 0xff0) | (i_opcode >> 6);
-            h_processor->first = 0;
-            h_processor->last = REG_SIZE - 1;
-            if (i_translate_addr(h_processor->addr) < MEMORY_SIZE)
-#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
-               if ((h_processor->addr != 0x08) && (h_processor->addr != 0x18))  /* Non existent registers */
+#if defined(WOODSTOCK) || defined(SPICE) || defined(HP10) || defined(HP67) || defined(VOYAGER)
+static void v_rom_pages(oprocessor *h_processor) /* Build the ROM page table */
+{
+   unsigned int i_page, i_addr;
+
+   for (i_page = 0; i_page < ROM_PAGES; i_page++)
+   {
+      i_addr = i_page * ROM_PAGE;
+      h_processor->next[i_page][0] = i_addr;
+      if (i_addr + ROM_PAGE >= ROM_SIZE)
+         h_processor->next[i_page][1] = 0; /* Address wraps round at end of memory */
+      else
+         h_processor->next[i_page][1] = (i_addr & 0xf000) | ((i_addr + ROM_PAGE) & 0xfff); /* Address wraps round at end of bank */
+#if !defined(VOYAGER)
+      if (i_addr < 0x1400)
+         h_processor->page[i_page] = i_addr & 0xfff; /* The first ROM chip is mapped to all ROM banks, access implies a switch to bank 0 */
+      else
+         h_processor->page[i_page] = i_addr;
 #endif
-               {
-                  v_reg_copy(h_processor, h_processor->mem[i_translate_addr(h_processor->addr)], h_processor->reg[C_REG]);
-                  if (h_processor->trace) v_fprint_register(stdout, h_processor->mem[i_translate_addr(h_processor->addr)]);
-               }
-            break;
-         case 0x0c:
-            switch ((i_opcode >> 6) & 0xf)
-            {
-#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
-            case 0x00: /* display blink- Display blink (00 0011 0000) */
-               if (h_processor->trace) fprintf(stdout, "blink\t\t");
-               h_processor->flags[DISPLAY_ENABLE] = True;
-               break;
+   }
+}
 #endif
-            case 0x01: /* c -> n - Load n from c (00 0111 0000) */
-               if (h_processor->trace) fprintf(stdout, "n = c\t\t");
-               h_processor->first = 0;
-               h_processor->last = REG_SIZE - 1;
-               v_reg_copy(h_processor, h_processor->reg[N_REG], h_processor->reg[C_REG]);
-               if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[N_REG]);
-               break;
-            case 0x02: /* n -> c - Load C from N (00 1011 0000) */
-               if (h_processor->trace) fprintf(stdout, "c = n\t\t");
-               h_processor->first = 0;
-               h_processor->last = REG_SIZE - 1;
-               v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->reg[N_REG]);
-               if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
-               break;
-            case 0x03: /* c -> n, n-> c - Exchange c and n (00 1111 0000) */
-               h_processor->first = 0;
-               h_processor->last = REG_SIZE - 1;
-               if (h_processor->trace) fprintf(stdout, "cnex\t\t");
-               v_reg_exch(h_processor, h_processor->reg[N_REG], h_processor->reg[C_REG]);
-               if (h_processor->trace)
-               {
-                  v_fprint_register(stdout, h_processor->reg[C_REG]);
-                  v_fprint_register(stdout, h_processor->reg[N_REG]);
-               }
-            break;
-            case 0x04: /* rom[pc++] -> c[2:0] - Load immediate (01 0011 0000) */
-               {
-                  int i_next;
-                  i_next = h_processor->rom[h_processor->pc]; /* Get next opcode */
-                  h_processor->reg[C_REG]->nibble[2] = (i_next >> 8) & 0xf;
-                  h_processor->reg[C_REG]->nibble[1] = (i_next >> 4) & 0xf;
-                  h_processor->reg[C_REG]->nibble[0] = i_next & 0xf;
-                  if (h_processor->trace)
-                  {
-                     fprintf(stdout, "ldi\n");
-                     fprintf(stdout, h_msg_opcode, (h_processor->pc >> 12), (h_processor->pc & 0x0fff), h_processor->rom[h_processor->pc]);
-                     fprintf(stdout,"  ");
-                     fprintf(stdout, h_msg_address, i_next);
-                     fprintf(stdout, "\t\t");
-                     v_fprint_register(stdout, h_processor->reg[C_REG]);
-                  }
-                  v_op_inc_pc(h_processor); /* Increment program counter */
-               }
-               break;
-            case 0x05: /* stack[2] -> stack[3], stack[1] -> stack[2], stack[0] -> stack[1], c -> stack[0] - Push c[6:3] onto the stack (01 0111 0000) */
-               if (h_processor->trace) fprintf(stdout, "stk = c\t\t");
-               h_processor->stack[h_processor->sp] = (h_processor->reg[C_REG]->nibble[6] << 12) | (h_processor->reg[C_REG]->nibble[5] << 8) | (h_processor->reg[C_REG]->nibble[4] << 4) | (h_processor->reg[C_REG]->nibble[3]);
-               h_processor->sp = (h_processor->sp + 1) & (STACK_SIZE - 1); /* Update stack pointer */
-               break;
-            case 0x06: /* stack[2] -> stack[3], stack[1] -> stack[2], stack[0] -> stack[1], c -> stack[0] - Pop c[6:3] from the stack (01 0111 0000) */
-               if (h_processor->trace) fprintf(stdout, "c = stk\t\t");
-               h_processor->sp = (h_processor->sp - 1) & (STACK_SIZE - 1); /* Update stack pointer */
-               h_processor->reg[C_REG]->nibble[3] = h_processor->stack[h_processor->sp] & 0xf;
-               h_processor->reg[C_REG]->nibble[4] = (h_processor->stack[h_processor->sp] >> 4) & 0xf;
-               h_processor->reg[C_REG]->nibble[5] = (h_processor->stack[h_processor->sp] >> 8) & 0xf;
-               h_processor->reg[C_REG]->nibble[6] = (h_processor->stack[h_processor->sp] >> 12) & 0xf;
-               break;
-            case 0x09: /* {addr[11:4], nnnn} -> addr, c -> reg[addr] - Load register address from c (10 0111 1000) */
-                  if (h_processor->trace) fprintf(stdout, "dadd = c\t\t");
-                  h_processor->addr = ((h_processor->reg[C_REG]->nibble[2] << 8) |
-                     (h_processor->reg[C_REG]->nibble[1] << 4) |
-                     (h_processor->reg[C_REG]->nibble[0])) & 0x3ff; /* Load 12 bit address into address register from c */
-                  if (h_processor->trace) fprintf(stdout, "addr = %d", h_processor->addr);
-               break;
-            case 0x0b: /* data = c - Load register from c (10 1111 0000) */
-               if (h_processor->trace) fprintf(stdout, "data = c\t\t");
-               if ((i_translate_addr(h_processor->addr) < MEMORY_SIZE) && (h_processor->addr != 0x08) && (h_processor->addr != 0x18))
-               {
-                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-                  v_reg_copy(h_processor, h_processor->mem[i_translate_addr(h_processor->addr)], h_processor->reg[C_REG]);
-                  if (h_processor->trace) v_fprint_register(stdout, h_processor->mem[i_translate_addr(h_processor->addr)]);
-               }
-               break;
-            case 0x0c: /* c[6:3] -> addr, ram[addr] -> c[2:0] - Exchange c and memory (11 0011 0000) */
-               if (h_processor->trace) fprintf(stdout, "cxisa\t\t");
-               {
-                  int i_addr;
-                  i_addr = (((h_processor->reg[C_REG]->nibble[6])<< 12) | (h_processor->reg[C_REG]->nibble[5] << 8) |
-                     (h_processor->reg[C_REG]->nibble[4] << 4) | (h_processor->reg[C_REG]->nibble[3]));
-                  if (i_addr > ROM_SIZE)
-                     {
-                        if (h_processor->trace) fprintf(stdout, "\n");
-                        v_error(h_err_invalid_address, i_addr, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-                     }
-                  else
-                  {
-                     h_processor->reg[C_REG]->nibble[2] = (h_processor->rom[i_addr] >> 8) & 0xf;
-                     h_processor->reg[C_REG]->nibble[1] = (h_processor->rom[i_addr] >> 4) & 0xf;
-                     h_processor->reg[C_REG]->nibble[0] = (h_processor->rom[i_addr]) & 0xf;
-                  }
-               }
-               if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
-               break;
-            case 0x0d: /* c | a -> c - Load c with c or a (11 0111 0000) */
-               if (h_processor->trace) fprintf(stdout, "c = c or a\t\t");
-               h_processor->first = 0;
-               h_processor->last = REG_SIZE - 1;
-               v_reg_or(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], h_processor->reg[A_REG]);
-               if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
-               break;
-            case 0x0e: /* c | a -> c - Load c with c and a (11 0111 0000) */
-               if (h_processor->trace) fprintf(stdout, "c = c and a");
-               h_processor->first = 0;
-               h_processor->last = REG_SIZE - 1;
-               v_reg_and(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], h_processor->reg[A_REG]);
-               if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
-               break;
-
-            default:
-               if (h_processor->trace) fprintf(stdout, "\n");
-               debug(fprintf(stderr,"%02x\n", (i_opcode >> 6) & 0xf));
-               v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            break;
-         case 0x0e: /* {addr[11:4], nnnn} -> addr, reg[addr] -> c - Load c from register (nn nn11 1000) */
-            if (i_opcode >> 6)
-            {
-               if (h_processor->trace) fprintf(stdout, "c = regn %-2d", i_opcode >> 6);
-               h_processor->addr = (h_processor->addr & 0xff0) | (i_opcode >> 6);
-            }
-            else
-               if (h_processor->trace) fprintf(stdout, "c = data\t\t");
-            h_processor->first = 0;
-            h_processor->last = REG_SIZE - 1;
-            if ((i_translate_addr(h_processor->addr) < MEMORY_SIZE) && (h_processor->addr != 0x08) && (h_processor->addr != 0x18)) /* Treat registers 8 and 18 as if they dont exist */
-               v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->mem[i_translate_addr(h_processor->addr)]);
-            else
-               v_reg_copy(h_processor, h_processor->reg[C_REG], NULL); /* Return zeros if memory doesnt' exist */
-            if (h_processor->trace)
-            {
-               v_fprint_register(stdout,h_processor->reg[C_REG]);
-               fprintf(stdout, "\taddr = %d", h_processor->addr);
-            }
-            break;
-         case 0x0f: /* Rotate c register right (dddd 1111 00) */
-            if (h_processor->trace) fprintf(stdout, "rcr %-3d\t\t", n_map_i[i_opcode >> 6]);
-            {
-               int i_count; ;
-               for (i_count = n_map_i[i_opcode >> 6]; i_count > 0; i_count--)
-               {
-                  int c_temp, i_count;
-                  c_temp = h_processor->reg[C_REG]->nibble[0];
-                  for (i_count = 0; i_count < REG_SIZE; i_count++)
-                     h_processor->reg[C_REG]->nibble[i_count] = h_processor->reg[C_REG]->nibble[i_count + 1];
-                  h_processor->reg[C_REG]->nibble[REG_SIZE - 1] = c_temp;
-                  h_processor->flags[PREV_CARRY] = h_processor->flags[CARRY] = False;
-               }
-            }
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
 
-         default:
-            if (h_processor->trace) fprintf(stdout, "\n");
-            debug(fprintf(stderr,"%02x\n", (i_opcode >> 2) & 0xf));
-            v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-         }
-         break;
+oprocessor *h_processor_create(int *h_rom) /* Create a new processor 'object' */
+{
+   oprocessor *h_processor;
+   int i_count;
+   h_processor = h_arena_alloc(sizeof(*h_processor)); /* Registers are allocated straight after the processor */
+   for (i_count = 0; i_count < REGISTERS; i_count++)
+      h_processor->reg[i_count] = h_register_create((i_count + 1) * -1); /* Allocate storage for the registers */
+   for (i_count = 0; i_count < MEMORY_SIZE; i_count++)
+      h_processor->mem[i_count] = h_register_create(i_count); /* Allocate storage for the RAM */
+#if defined(HP67)
+   h_processor->card = h_register_create(CARD_DATA);
 #endif
-
-#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
-      case 01: /* Type 1 - Branch instruction (two words) */
-         {
-            int i_address, i_next;
-            i_address = i_opcode >> 2;
-            i_next = h_processor->rom[h_processor->pc]; /* Get next opcode */
-            i_address |= ((i_next & 0x3fc) << 6);
-            if (h_processor->trace)
-            {
-               switch (i_next & 0x3)
-               {
-               case 0x0:
-                  fprintf(stdout, "? nc gsb\t\t");
-                  break;
-               case 0x1:
-                  fprintf(stdout, "? c gsb\t\t");
-                  break;
-               case 0x2:
-                  fprintf(stdout, "? nc goto\t\t");
-                  break;
-               case 0x3:
-                  fprintf(stdout, "? c goto\t\t");
-                  break;
-               }
-               fprintf(stdout, "\n");
-               fprintf(stdout, h_msg_opcode, (h_processor->pc >> 12), (h_processor->pc & 0x0fff), h_processor->rom[h_processor->pc]);
-               fprintf(stdout,"  ");
-               fprintf(stdout, h_msg_address, i_address);
-            }
-            h_processor->flags[CARRY] = h_processor->flags[PREV_CARRY]; /* Save carry */
-            v_op_inc_pc(h_processor); /* Increment program counter */
-            switch (i_next & 0x3)
-            {
-            case 0x0: /* if no carry then stack[2] -> stack[3], stack[1] -> stack[2], stack[0] -> stack[1], pc -> stack[0], a -> pc - Branch to subroutine on no carry (aa aaaa aa00, aa aaaa aa00) */
-               if (i_address < ROM_SIZE) /* Check that the target address exists otherwise treat as a 'nop' */
-                  if (!h_processor->flags[PREV_CARRY]) op_jsb(h_processor, i_address);
-               break;
-            case 0x1: /* if carry then stack[2] -> stack[3], stack[1] -> stack[2], stack[0] -> stack[1], pc -> stack[0], a -> pc - Branch to subroutine on no carry (aa aaaa aa00, aa aaaa aa01) */
-               if (i_address < ROM_SIZE) /* Check that the target address exists otherwise treat as a 'nop' */
-                  if (h_processor->flags[PREV_CARRY]) op_jsb(h_processor, i_address);
-               break;
-            case 0x2:  /* if no carry then a -> pc - Branch on no carry (aa aaaa aa00, aa aaaa aa10) */
-               if (!h_processor->flags[PREV_CARRY])
-                  h_processor->pc = i_address;
-               break;
-            case 0x3: /* if carry then a -> pc - Branch on carry (aa aaaa aa00, aa aaaa aa11) */
-               if (h_processor->flags[PREV_CARRY])
-                  h_processor->pc = i_address;
-               break;
-            }
-         }
-         break;
-#else
-      case 01: /* Type 1 - Jump subroutine */
-         if (h_processor->trace) {fprintf(stdout, "jsb "); fprintf(stdout, h_msg_address, ((h_processor->pc & 0x0f00) | i_opcode >> 2));}
-         op_jsb(h_processor, (i_opcode >> 2)); /* Note - uses and eight bit address */
-         break;
+   h_processor->rom = h_rom ; /* Address of ROM */
+#if defined(WOODSTOCK) || defined(SPICE) || defined(HP10) || defined(HP67) || defined(VOYAGER)
+   v_rom_pages(h_processor);
 #endif
-
-#if defined(HP35) || defined(HP80) || defined(HP45) || defined(HP70) || defined(HP55)
-      case 02: /* Type 2 - Arithmetic operations */
-         i_field = (i_opcode >> 2) & 7;
-         switch (i_field) /* Select field
-            000   P  : determined by P                   [P]
-            001   M  : mantissa                          [3 .. 12]
-            010   X  : exponent                          [0 ..  1]
-            011   W  : word                              [0 .. 13]
-            100  WP  : word up to and including P        [0 ..  P]
-            101  MS  : mantissa and sign                 [3 .. 13]
-            110  XS  : exponent sign                     [2]
-            111   S  : sign                              [13] */
-         {
-         case 00: /* P */
-            s_field = "p";
-            h_processor->first = h_processor->p; h_processor->last = h_processor->p;
-            if (h_processor->p >= REG_SIZE)
-            {
-               if (h_processor->trace) fprintf(stdout, "\n");
-               v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            break;
-         case 01: /* M */
-            s_field = "m";
-            h_processor->first = EXP_SIZE; h_processor->last = REG_SIZE - 2;
-            break;
-         case 02: /* X */
-            s_field = "x";
-            h_processor->first = 0; h_processor->last = EXP_SIZE - 1;
-            break;
-         case 03: /* W */
-            s_field = "w";
-            h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-            break;
-         case 04: /* WP */
-            s_field = "wp";
-            h_processor->first =  0; h_processor->last =  h_processor->p; /* break; bug in orig??? */
-            if (h_processor->p >= REG_SIZE)
-            {
-               if (h_processor->trace) fprintf(stdout, "\n");
-               v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            break;
-         case 05: /* MS */
-            s_field = "ms";
-            h_processor->first = EXP_SIZE; h_processor->last = REG_SIZE - 1;
-            break;
-         case 06: /* XS */
-            s_field = "xs";
-            h_processor->first = EXP_SIZE - 1; h_processor->last = EXP_SIZE - 1;
-            break;
-         case 07: /* S */
-            s_field = "s";
-            h_processor->first = REG_SIZE - 1; h_processor->last = REG_SIZE - 1;
-            break;
-         }
-
-         switch (i_opcode >> 5)
-         {
-         case 000: /* if b[f] = 0 */
-            if (h_processor->trace) fprintf(stdout, "if b[%s] = 0", s_field);
-            v_reg_test_eq(h_processor, h_processor->reg[B_REG], NULL);
-            v_op_goto(h_processor);
-            break;
-         case 001: /* 0 -> b[f] */
-            if (h_processor->trace)fprintf(stdout, "0 -> b[%s]\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[B_REG], NULL);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
-            break;
-         case 002: /* if a >= c[f] */
-            if (h_processor->trace) fprintf(stdout, "if a >= c[%s]", s_field);
-            v_reg_sub(h_processor, NULL, h_processor->reg[A_REG], h_processor->reg[C_REG]); /* Less than */
-            h_processor->flags[CARRY] = !h_processor->flags[CARRY];
-            v_op_goto(h_processor);
-            break;
-         case 003: /* if c[f] != 0 */
-            if (h_processor->trace) fprintf(stdout, "if c[%s] != 0", s_field);
-            v_reg_test_ne(h_processor, h_processor->reg[C_REG], NULL);
-            v_op_goto(h_processor);
-            break;
-         case 004: /* b -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "b -> c[%s]\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->reg[B_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
-            break;
-         case 005: /* 0 - c -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "0 - c -> c[%s]", s_field);
-            v_reg_sub(h_processor, h_processor->reg[C_REG], NULL, h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 006: /* 0 -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "0 -> c[%s]\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[C_REG], NULL);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 007: /* 0 - c - 1 -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "0 - c - 1 -> c[%s]\t\t", s_field);
-            h_processor->flags[CARRY] = True; /* Set carry */
-            v_reg_sub(h_processor, h_processor->reg[C_REG], NULL, h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 010: /* shift left a[f] */
-            if (h_processor->trace) fprintf(stdout, "shift left a[%s]\t\t", s_field);
-            v_reg_shl(h_processor, h_processor->reg[A_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
-            break;
-         case 011: /* a -> b[f] */
-            if (h_processor->trace) fprintf(stdout, "a -> b[%s]\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[B_REG], h_processor->reg[A_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
-            break;
-         case 012: /* a - c -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "a - c -> c[%s]\t\t", s_field);
-            v_reg_sub(h_processor, h_processor->reg[C_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 013: /* c - 1 -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "c - 1 -> c[%s]\t\t", s_field);
-            h_processor->flags[CARRY] = True; /* Set carry */
-            v_reg_sub(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], NULL);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 014: /* c -> a[f] */
-            if (h_processor->trace) fprintf(stdout, "c -> a[%s]\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[A_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 015: /* if c[f] = 0 */
-            if (h_processor->trace) fprintf(stdout, "if c[%s] = 0", s_field);
-            v_reg_test_eq(h_processor, h_processor->reg[C_REG], NULL);
-            v_op_goto(h_processor);
-            break;
-         case 016: /* a + c -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "a + c -> c[%s]\t\t", s_field);
-            v_reg_add(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], h_processor->reg[A_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 017: /* c + 1 -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "c + 1 -> c[%s]\t\t", s_field);
-            v_reg_inc(h_processor, h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 020: /* if a >= b[f] */
-            if (h_processor->trace) fprintf(stdout, "if a >= b[%s]", s_field);
-            v_reg_sub(h_processor, NULL, h_processor->reg[A_REG], h_processor->reg[B_REG]); /* Less than */
-            h_processor->flags[CARRY] = !h_processor->flags[CARRY];
-            v_op_goto(h_processor);
-            break;
-         case 021: /* b exchange c[f] */
-            if (h_processor->trace) fprintf(stdout, "b exch c[%s]\t\t", s_field);
-            v_reg_exch(h_processor, h_processor->reg[B_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace)
-            {
-               v_fprint_register(stdout,h_processor->reg[B_REG]);
-               v_fprint_register(stdout,h_processor->reg[C_REG]);
-            }
-            break;
-         case 022: /* shift right c[f] */
-            if (h_processor->trace) fprintf(stdout, "shift right c[%s]\t", s_field);
-            v_reg_shr(h_processor, h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 023: /* if a[f] != 0 */
-            if (h_processor->trace) fprintf(stdout, "if a[%s] != 0", s_field);
-            v_reg_test_ne(h_processor, h_processor->reg[A_REG], NULL);
-            v_op_goto(h_processor);
-            break;
-         case 024: /* shift right b[f] */
-            v_reg_shr(h_processor, h_processor->reg[B_REG]);
-            if (h_processor->trace) fprintf(stdout, "shift right b[%s]\t", s_field);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
-            break;
-         case 025: /* c + c -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "c + c -> c[%s]\t", s_field);
-            v_reg_add(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 026: /* shift right a[f] */
-            if (h_processor->trace) fprintf(stdout, "shift right a[%s]\t", s_field);
-            v_reg_shr(h_processor, h_processor->reg[A_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 027: /* 0 -> a[f] */
-            if (h_processor->trace) fprintf(stdout, "0 -> a[%s]\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[A_REG], NULL);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 030: /* a - b -> a[f] */
-            if (h_processor->trace) fprintf(stdout, "a - b -> a[%s]\t", s_field);
-            v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[B_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 031: /* a exch b[f] */
-            if (h_processor->trace) fprintf(stdout, "a exch b[%s]\t", s_field);
-            v_reg_exch(h_processor, h_processor->reg[A_REG], h_processor->reg[B_REG]);
-            if (h_processor->trace)
-            {
-               v_fprint_register(stdout,h_processor->reg[A_REG]);
-               v_fprint_register(stdout,h_processor->reg[B_REG]);
-            }
-            break;
-         case 032: /* a - c -> a[f] */
-            if (h_processor->trace) fprintf(stdout, "a - c -> a[%s]\t", s_field);
-            v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 033: /* a - 1 -> a[f] */
-            if (h_processor->trace) fprintf(stdout, "a - 1 -> a[%s]\t", s_field);
-            h_processor->flags[CARRY] = True; /* Set carry */
-            v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], NULL);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 034: /* a + b -> a[f] */
-            if (h_processor->trace) fprintf(stdout, "a + b -> a[%s]\t", s_field);
-            v_reg_add(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[B_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 035: /* a exch c[f] */
-            if (h_processor->trace) fprintf(stdout, "a exch c[%s]\t\t", s_field);
-            v_reg_exch(h_processor, h_processor->reg[A_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace)
-            {
-               v_fprint_register(stdout,h_processor->reg[A_REG]);
-               v_fprint_register(stdout,h_processor->reg[C_REG]);
-            }
-            break;
-         case 036: /* a + c -> a[a + c -> a[f] */
-            if (h_processor->trace) fprintf(stdout, "a + c -> a[%s]", s_field);
-            v_reg_add(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 037: /* a + 1 -> a[f] */
-            if (h_processor->trace) fprintf(stdout, "a + 1 -> a[%s]", s_field);
-            v_reg_inc(h_processor, h_processor->reg[A_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         default:
-            if (h_processor->trace) fprintf(stdout, "\n");
-            v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-         }
-         break;
+#if defined(VOYAGER)
+   v_address_map(); /* Only needs to be done once */
 #endif
-
-#if defined(WOODSTOCK) || defined(SPICE) || defined(HP10) || defined(HP67)
-      case 02: /* Type 2 - Arithmetic operations */
-         i_field = (i_opcode >> 2) & 7;
-         switch (i_field) /* Select field
-            000   P  : determined by P                   [P]
-            001  WP  : word up to and including P        [0 ..  P]
-            010  XS  : exponent sign                     [2]
-            011   X  : exponent                          [0 ..  1]
-            100   S  : sign                              [13]
-            101   M  : mantissa                          [3 .. 12]
-            110   W  : word                              [0 .. 13]
-            111  MS  : mantissa and sign                 [3 .. 13] */
-         {
-         case 00: /* P */
-            s_field = "p";
-            h_processor->first = h_processor->p; h_processor->last = h_processor->p;
-            if (h_processor->p >= REG_SIZE)
-            {
-               if (h_processor->trace) fprintf(stdout, "\n");
-               v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            break;
-         case 01: /* WP */
-            s_field = "wp";
-            h_processor->first =  0; h_processor->last =  h_processor->p; /* break; bug in orig??? */
-            if (h_processor->p >= REG_SIZE)
-            {
-               if (h_processor->trace) fprintf(stdout, "\n");
-               v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            break;
-         case 02: /* XS */
-            s_field = "xs";
-            h_processor->first = EXP_SIZE - 1; h_processor->last = EXP_SIZE - 1;
-            break;
-         case 03: /* X */
-            s_field = "x";
-            h_processor->first = 0; h_processor->last = EXP_SIZE - 1;
-            break;
-         case 04: /* S */
-            s_field = "s";
-            h_processor->first = REG_SIZE - 1; h_processor->last = REG_SIZE - 1;
-            break;
-         case 05: /* M */
-            s_field = "m";
-            h_processor->first = EXP_SIZE; h_processor->last = REG_SIZE - 2;
-            break;
-         case 06: /* W */
-            s_field = "w";
-            h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-            break;
-         case 07: /* MS */
-            s_field = "ms";
-            h_processor->first = EXP_SIZE; h_processor->last = REG_SIZE - 1;
-            break;
-         }
-
-         switch (i_opcode >> 5)
-         {
-         case 000: /* 0 -> a[f] */
-            if (h_processor->trace) fprintf(stdout, "0 -> a[%s]\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[A_REG], NULL);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 001: /* 0 -> b[f] */
-            if (h_processor->trace)fprintf(stdout, "0 -> b[%s]\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[B_REG], NULL);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
-            break;
-         case 002: /* a exch b[f] */
-            if (h_processor->trace) fprintf(stdout, "a exch b[%s]\t", s_field);
-            v_reg_exch(h_processor, h_processor->reg[A_REG], h_processor->reg[B_REG]);
-            if (h_processor->trace)
-            {
-               v_fprint_register(stdout,h_processor->reg[A_REG]);
-               v_fprint_register(stdout,h_processor->reg[B_REG]);
-            }
-            break;
-         case 003: /* a -> b[f] */
-            if (h_processor->trace) fprintf(stdout, "a -> b[%s]\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[B_REG], h_processor->reg[A_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
-            break;
-         case 004: /* a exch c[f] */
-            if (h_processor->trace) fprintf(stdout, "a exch c[%s]\t", s_field);
-            v_reg_exch(h_processor, h_processor->reg[A_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace)
-            {
-               v_fprint_register(stdout,h_processor->reg[A_REG]);
-               v_fprint_register(stdout,h_processor->reg[C_REG]);
-            }
-            break;
-         case 005: /* c -> a[f] */
-            if (h_processor->trace) fprintf(stdout, "c -> a[%s]\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[A_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 006: /* b -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "b -> c[%s]\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->reg[B_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 007: /* b exchange c[f] */
-            if (h_processor->trace) fprintf(stdout, "b exch c[%s]\t", s_field);
-            v_reg_exch(h_processor, h_processor->reg[B_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace)
-            {
-               v_fprint_register(stdout,h_processor->reg[B_REG]);
-               v_fprint_register(stdout,h_processor->reg[C_REG]);
-            }
-            break;
-         case 010: /* 0 -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "0 -> c[%s]\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[C_REG], NULL);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 011: /* a + b -> a[f] */
-            if (h_processor->trace) fprintf(stdout, "a + b -> a[%s]\t", s_field);
-            v_reg_add(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[B_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 012: /* a + c -> a[f] */
-            if (h_processor->trace) fprintf(stdout, "a + c -> a[%s]\t", s_field);
-            v_reg_add(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 013: /* c + c -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "c + c -> c[%s]\t", s_field);
-            v_reg_add(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 014: /* a + c -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "a + c -> c[%s]\t", s_field);
-            v_reg_add(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], h_processor->reg[A_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 015: /* a + 1 -> a[f] */
-            if (h_processor->trace) fprintf(stdout, "a + 1 -> a[%s]\t", s_field);
-            v_reg_inc(h_processor, h_processor->reg[A_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 016: /* shift left a[f] */
-            if (h_processor->trace) fprintf(stdout, "shift left a[%s]\t", s_field);
-            fflush(stdout);
-            v_reg_shl(h_processor, h_processor->reg[A_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 017: /* c + 1 -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "c + 1 -> c[%s]\t", s_field);
-            v_reg_inc(h_processor, h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 020: /* a - b -> a[f] */
-            if (h_processor->trace) fprintf(stdout, "a - b -> a[%s]\t", s_field);
-            v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[B_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 021: /* a - c -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "a - c -> c[%s]\t", s_field);
-            v_reg_sub(h_processor, h_processor->reg[C_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 022: /* a - 1 -> a[f] */
-            if (h_processor->trace) fprintf(stdout, "a - 1 -> a[%s]\t", s_field);
-            h_processor->flags[CARRY] = True; /* Set carry */
-            v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], NULL);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 023: /* c - 1 -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "c - 1 -> c[%s]\t", s_field);
-            h_processor->flags[CARRY] = True; /* Set carry */
-            v_reg_sub(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], NULL);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 024: /* 0 - c -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "0 - c -> c[%s]\t", s_field);
-            v_reg_sub(h_processor, h_processor->reg[C_REG], NULL, h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 025: /* 0 - c - 1 -> c[f] */
-            if (h_processor->trace) fprintf(stdout, "0 - c - 1 -> c[%s]\t", s_field);
-            h_processor->flags[CARRY] = True; /* Set carry */
-            v_reg_sub(h_processor, h_processor->reg[C_REG], NULL, h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 026: /* if b[f] = 0 */
-            if (h_processor->trace) fprintf(stdout, "if b[%s] = 0", s_field);
-            v_reg_test_eq(h_processor, h_processor->reg[B_REG], NULL);
-            v_op_goto(h_processor);
-            break;
-         case 027: /* if c[f] = 0 */
-            if (h_processor->trace) fprintf(stdout, "if c[%s] = 0", s_field);
-            v_reg_test_eq(h_processor, h_processor->reg[C_REG], NULL);
-            v_op_goto(h_processor);
-            break;
-         case 030: /* if a >= c[f] */
-            if (h_processor->trace) fprintf(stdout, "if a >= c[%s]", s_field);
-            v_reg_sub(h_processor, NULL, h_processor->reg[A_REG], h_processor->reg[C_REG]); /* Less than */
-            h_processor->flags[CARRY] = !h_processor->flags[CARRY];
-            v_op_goto(h_processor);
-            break;
-         case 031: /* if a >= b[f] */
-            if (h_processor->trace) fprintf(stdout, "if a >= b[%s]", s_field);
-            v_reg_sub(h_processor, NULL, h_processor->reg[A_REG], h_processor->reg[B_REG]); /* Less than */
-            h_processor->flags[CARRY] = !h_processor->flags[CARRY];
-            v_op_goto(h_processor);
-            break;
-         case 032: /* if a[f] != 0 */
-            if (h_processor->trace) fprintf(stdout, "if a[%s] != 0", s_field);
-            v_reg_test_ne(h_processor, h_processor->reg[A_REG], NULL);
-            v_op_goto(h_processor);
-            break;
-         case 033: /* if c[f] != 0 */
-            if (h_processor->trace) fprintf(stdout, "if c[%s] != 0", s_field);
-            v_reg_test_ne(h_processor, h_processor->reg[C_REG], NULL);
-            v_op_goto(h_processor);
-            break;
-         case 034: /* a - c -> a[f] */
-            if (h_processor->trace) fprintf(stdout, "a - c -> a[%s]\t", s_field);
-            v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 035: /* shift right a[f] */
-            if (h_processor->trace) fprintf(stdout, "shift right a[%s]\t", s_field);
-            v_reg_shr(h_processor, h_processor->reg[A_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 036: /* shift right b[f] */
-            v_reg_shr(h_processor, h_processor->reg[B_REG]);
-            if (h_processor->trace) fprintf(stdout, "shift right b[%s]\t", s_field);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
-            break;
-         case 037: /* shift right c[f] */
-            if (h_processor->trace) fprintf(stdout, "shift right c[%s]\t", s_field);
-            v_reg_shr(h_processor, h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         default:
-            if (h_processor->trace) fprintf(stdout, "\n");
-            v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-         }
-         break;
+   h_processor->mode = False;
+   h_processor->timer = False;
+   h_processor->trace = False;
+   h_processor->step = False;
+#if defined(CONTINIOUS)
+   h_processor->memory = NULL;
 #endif
-
-#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
-      case 0x02: /* Type 2 - Arithmetic operations */
-         i_field = (i_opcode >> 2) & 7;
-         switch (i_field) /* Select field
-            000   R  : determined by active pointer            [R]
-            001 S+X  : exponent and sign                       [0 .. 2]
-            010  WR  : word up to and including active pointer [0 ..  P]
-            011   W  : word                                    [0 .. 13]
-            100 P-Q  : word from P up to and including Q       [P .. Q]
-            101  XS  : exponent sign only                      [2]
-            110   M  : mantissa                                [3 .. 12]
-            111   S  : sign                                    [13] */
-         {
-         case 00: /* Active pointer */
-            s_field = "pt";
-            if (h_processor->ptr)
-               h_processor->first = h_processor->last = h_processor->q;
-            else
-               h_processor->first = h_processor->last = h_processor->p;
-            if (h_processor->p >= REG_SIZE || h_processor->q >= REG_SIZE)
-            {
-               if (h_processor->trace) fprintf(stdout, "\n");
-               v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            break;
-         case 01: /* Exponent and sign */
-            s_field = "x";
-            h_processor->first = 0; h_processor->last = EXP_SIZE - 1;
-            break;
-         case 02: /* Word up to the active pointer */
-            s_field = "wpt";
-            h_processor->first =  0;
-            if (h_processor->ptr)
-               h_processor->last = h_processor->q;
-            else
-               h_processor->last = h_processor->p;
-            if (h_processor->p >= REG_SIZE || h_processor->q >= REG_SIZE)
-            {
-               if (h_processor->trace) fprintf(stdout, "\n");
-               v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            break;
-         case 03: /* All nibbles in the word */
-            s_field = "all";
-            h_processor->first = 0; h_processor->last = REG_SIZE - 1;
-            break;
-         case 04: /* Selects range based on pointers */
-            s_field = "pq";
-            h_processor->first = h_processor->p;
-            if (h_processor->p > h_processor->q)
-               h_processor->last = REG_SIZE - 1;
-            else
-               h_processor->last = h_processor->q;
-            if (h_processor->p >= REG_SIZE || h_processor->q >= REG_SIZE)
-            {
-               if (h_processor->trace) fprintf(stdout, "\n");
-               v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            }
-            break;
-         case 05: /* XS */
-            s_field = "xs";
-            h_processor->first = EXP_SIZE - 1; h_processor->last = EXP_SIZE - 1;
-            break;
-         case 06: /* M */
-            s_field = "m";
-            h_processor->first = EXP_SIZE; h_processor->last = REG_SIZE - 2;
-            break;
-         case 07: /* S */
-            s_field = "s";
-            h_processor->first = REG_SIZE - 1; h_processor->last = REG_SIZE - 1;
-            break;
-         }
-
-         switch (i_opcode >> 5)
-         {
-         case 0x00: /* 0 -> a[f] - Clear a (00 000f ff10) */
-            if (h_processor->trace) fprintf(stdout, "a = 0 %s\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[A_REG], NULL);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 0x01: /* 0 -> b[f] - Clear b (00 001f ff10) */
-            if (h_processor->trace)fprintf(stdout, "b = 0 %s\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[B_REG], NULL);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
-            break;
-         case 0x02: /* 0 -> c[f] - Clear c (00 010f ff10) */
-            if (h_processor->trace) fprintf(stdout, "c = 0 %s\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[C_REG], NULL);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 0x03: /* a exch b[f] - Exchange a and b (00 011f ff10) */
-            if (h_processor->trace) fprintf(stdout, "abex %s\t\t", s_field);
-            v_reg_exch(h_processor, h_processor->reg[A_REG], h_processor->reg[B_REG]);
-            if (h_processor->trace)
-            {
-               v_fprint_register(stdout,h_processor->reg[A_REG]);
-               v_fprint_register(stdout,h_processor->reg[B_REG]);
-            }
-            break;
-         case 0x04: /* a -> b[f] - Load b from a (00 100f ff10) */
-            if (h_processor->trace) fprintf(stdout, "b = a %s\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[B_REG], h_processor->reg[A_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
-            break;
-         case 0x05: /* a exch c[f] - Exchange a and c (00 101f ff10) */
-            if (h_processor->trace) fprintf(stdout, "acex %s\t\t", s_field);
-            v_reg_exch(h_processor, h_processor->reg[A_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace)
-            {
-               v_fprint_register(stdout,h_processor->reg[A_REG]);
-               v_fprint_register(stdout,h_processor->reg[C_REG]);
-            }
-            break;
-         case 0x06: /* b -> c[f] - Load c from b (00 110f ff10) */
-            if (h_processor->trace) fprintf(stdout, "c = b %s\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->reg[B_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 0x07: /* b exch c[f] - Exchange b and c (00 111f ff10) */
-            if (h_processor->trace) fprintf(stdout, "bcex %s\t\t", s_field);
-            v_reg_exch(h_processor, h_processor->reg[B_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace)
-            {
-               v_fprint_register(stdout,h_processor->reg[B_REG]);
-               v_fprint_register(stdout,h_processor->reg[C_REG]);
-            }
-            break;
-         case 0x08: /* c -> a[f] - Load a from c (01 000f ff10) */
-            if (h_processor->trace) fprintf(stdout, "a = c %-3s\t\t", s_field);
-            v_reg_copy(h_processor, h_processor->reg[A_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 0x09: /* a + b -> a[f] - Load a with a plus b (01 001f ff10) */
-            if (h_processor->trace) fprintf(stdout, "a = a + b %-3s", s_field);
-            v_reg_add(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[B_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 0x0a: /* a + c -> a[f] - Load a with a plus c (01 010f ff10) */
-            if (h_processor->trace) fprintf(stdout, "a = a + c %-3s", s_field);
-            v_reg_add(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 0x0b: /* a + 1 -> a[f] - Load a with a plus 1 (01 011f ff10) */
-            if (h_processor->trace) fprintf(stdout, "a = a + 1 %-3s", s_field);
-            v_reg_inc(h_processor, h_processor->reg[A_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 0x0c: /* a - b -> a[f] - Load a with a minus b (01 100f ff10) */
-            if (h_processor->trace) fprintf(stdout, "a = a - b %-3s", s_field);
-            v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[B_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 0x0d: /* a - 1 -> a[f] - Load a with a minus 1 (01 101f ff10) */
-            if (h_processor->trace) fprintf(stdout, "a = a - 1 %-3s", s_field);
-            h_processor->flags[CARRY] = True; /* Set carry */
-            v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], NULL);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 0x0e: /* a - c -> a[f] - Load a with a minus c (01 110f ff10) */
-            if (h_processor->trace) fprintf(stdout, "a = a - c %-3s", s_field);
-            v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 0x0f: /* c + c -> c[f] - Load c with c plus c (01 111f ff10) */
-            if (h_processor->trace) fprintf(stdout, "c = c + c %-3s", s_field);
-            v_reg_add(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 0x10: /* a + c -> c[f] - Load c with a plus c (10 000f ff10) */
-            if (h_processor->trace) fprintf(stdout, "c = c + a %-3s", s_field);
-            v_reg_add(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], h_processor->reg[A_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 0x11: /* c + 1 -> c[f] - Load c with c plus 1 (10 001f ff10) */
-            if (h_processor->trace) fprintf(stdout, "c = c + 1 %-3s", s_field);
-            v_reg_inc(h_processor, h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 0x12: /* c - a -> c[f] - Load c with c minus a (10 010f ff10) */
-            if (h_processor->trace) fprintf(stdout, "c = a - c %-3s", s_field);
-            v_reg_sub(h_processor, h_processor->reg[C_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 0x13: /* c - 1 -> c[f] - Load c with c minus 1 (10 011f ff10) */
-            if (h_processor->trace) fprintf(stdout, "c = c - 1 %-3s", s_field);
-            h_processor->flags[CARRY] = True; /* Set carry */
-            v_reg_sub(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], NULL);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 0x14: /* 0 - c -> c f - Load c with 0 minus c (10 100f ff10) */
-            if (h_processor->trace) fprintf(stdout, "c = 0 - c %-3s", s_field);
-            v_reg_sub(h_processor, h_processor->reg[C_REG], NULL, h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 0x15: /* 0 - c - 1 -> c[f] - Complement c (10 101f ff10) */
-            if (h_processor->trace) fprintf(stdout, "c = - c - 1 %-3s", s_field);
-            h_processor->flags[CARRY] = True; /* Set carry */
-            v_reg_sub(h_processor, h_processor->reg[C_REG], NULL, h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 0x16: /* ? b[f] != 0 - Test b not equal to zero (10 110f ff10) */
-            if (h_processor->trace) fprintf(stdout, "? b != 0 %-3s", s_field);
-            v_reg_test_ne(h_processor, h_processor->reg[B_REG], NULL);
-            break;
-         case 0x17: /* ? c != 0 - Test c not equal to zero (10 111f ff10) */
-            if (h_processor->trace) fprintf(stdout, "? c != 0 %-3s", s_field);
-            v_reg_test_ne(h_processor, h_processor->reg[C_REG], NULL);
-            break;
-         case 0x18: /* ? a < c - Test a less than c (11 000f ff10) */
-            if (h_processor->trace) fprintf(stdout, "? a < c %-3s", s_field);
-            v_reg_sub(h_processor, NULL, h_processor->reg[A_REG], h_processor->reg[C_REG]);/* Less than */
-            break;
-         case 0x19: /* ? a < b - Test a less than b (11 001f ff10) */
-            if (h_processor->trace) fprintf(stdout, "? a < b %-3s", s_field);
-            v_reg_sub(h_processor, NULL, h_processor->reg[A_REG], h_processor->reg[B_REG]); /* Less than */
-            break;
-         case 0x1a: /* ? a != 0 - Test a not equal to zero  (11 010f ff10) */
-            if (h_processor->trace) fprintf(stdout, "? a != 0 %-3s", s_field);
-            v_reg_test_ne(h_processor, h_processor->reg[A_REG], NULL);
-            break;
-         case 0x1b: /* ? a != c - Test a not equal to c (11 011f ff10) */
-            if (h_processor->trace) fprintf(stdout, "? a != c %-3s", s_field);
-            v_reg_test_ne(h_processor, h_processor->reg[A_REG], h_processor->reg[C_REG]);
-            break;
-         case 0x1c: /* a >> 1 -> a[f] - Shift right a (11 100f ff10) */
-            if (h_processor->trace) fprintf(stdout, "shr a %s\t\t", s_field);
-            v_reg_shr(h_processor, h_processor->reg[A_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         case 0x1d: /* b >> 1 -> b[f] - Shift right b (11 101f ff10) */
-            v_reg_shr(h_processor, h_processor->reg[B_REG]);
-            if (h_processor->trace) fprintf(stdout, "shr b %s\t\t", s_field);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
-            break;
-         case 0x1e: /* c >> 1 -> c[f] - Shift right c (11 110f ff10) */
-            if (h_processor->trace) fprintf(stdout, "shr c %s\t\t", s_field);
-            v_reg_shr(h_processor, h_processor->reg[C_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
-            break;
-         case 0x1f: /* a << 1 -> a[f] - Shift left a (11 111f ff10) */
-            if (h_processor->trace) fprintf(stdout, "shl a %s\t\t", s_field);
-            fflush(stdout);
-            v_reg_shl(h_processor, h_processor->reg[A_REG]);
-            if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
-            break;
-         default:
-            if (h_processor->trace) fprintf(stdout, "\n");
-            v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-         }
-         break;
+   v_processor_reset(h_processor);
+#if defined(HP10)
+   h_processor->print = False;
 #endif
-
-      case 03:/* Type 3 - Conditional branch */
-         switch (i_opcode & 03)
-         {
-         case 00:
-            if (h_processor->trace) {fprintf(stdout, "call "); fprintf(stdout, h_msg_address, i_opcode >> 2);}
-            if (h_processor->trace) fprintf(stdout, "\n");
-            v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            break;
-         case 01:
-            if (h_processor->trace) {fprintf(stdout, "call "); fprintf(stdout, h_msg_address, i_opcode >> 2);}
-            if (h_processor->trace) fprintf(stdout, "\n");
-            v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            break;
-         case 02:
-            if (h_processor->trace) {fprintf(stdout, "jump "); fprintf(stdout, h_msg_address, i_opcode >> 2);}
-            if (h_processor->trace) fprintf(stdout, "\n");
-            v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-            break;
-#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
-         case 03: /* Relative jump */
-            {
-               int i_offset;
-               i_offset = i_opcode >> 3;
-               if (i_offset >= 0x40) i_offset = i_offset - 128; /* Fixed relative jump offset */
-               if (i_opcode & 00004)
-               {
-                  if (h_processor->trace) fprintf(stdout, "jc ");
-                  if (h_processor->flags[PREV_CARRY])
-                     h_processor->pc = ((i_last + i_offset) & 0xffff);
-               }
-               else
-               {
-                  if (h_processor->trace) fprintf(stdout, "jnc ");
-                  if (!h_processor->flags[PREV_CARRY])
-                     h_processor->pc = ((i_last + i_offset) & 0xffff);
-               }
-               if (h_processor->trace)
-               {
-                  if (i_offset < 0)
-                     fprintf(stdout, h_msg_negative_offset, abs(i_offset));
-                  else
-                     fprintf(stdout, h_msg_positive_offset , abs(i_offset));
-               }
-            }
-            break;
-#else
-         case 03: /* if nc go to */
-            if (h_processor->trace) {fprintf(stdout, "if nc go to "); fprintf(stdout, h_msg_address, ((h_processor->pc & 0x0f00) | i_opcode >> 2));} /* Note - uses and eight bit address */
-            if (!h_processor->flags[PREV_CARRY])
-            {
-               h_processor->pc = (h_processor->pc & 0xff00) | i_opcode >> 2;
-               v_delayed_rom(h_processor);
-            }
-            break;
+#if defined(CONTINIOUS)
+   memset(h_processor->saved, 0xff, STATE_SIZE); /* Nothing saved yet */
 #endif
-         default:
-            if (h_processor->trace) fprintf(stdout, "\n");
-            v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-         }
-         break;
-      default:
-         if (h_processor->trace) fprintf(stdout, "\n");
-         v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
-      }
-      if (h_processor->trace) fprintf(stdout, "\n");
-      h_processor->opcode = i_opcode; /* Keep track of the previous opcode so you know when to increment 'P' */
-   }
+   return(h_processor);
+}
+
+void v_processor_tick(oprocessor *h_processor) /* Decode and execute a single instruction */
+{
+   v_processor_keys(h_processor);
+   if (h_processor->enabled && !h_processor->sleep)
+      v_processor_execute(h_processor);
 }
@@ -55,6 +55,32 @@
  * 28 Dec 22         - Changed the name of printer mode status from mode to
  *                     print - MT
  * 06 Jun 23         - Removed unused references to HP91c and HP97 - MT
+ * 17 Oct 26         - Added a queue of key events, each stamped  with  the
+ *                     time  (in ticks) when it should be passed on to  the
+ *                     processor - MT
+ *                   - Added  definitions  for the register operations  and
+ *                     instruction  decoder shared by each processor family
+ *                     - MT
+ *                   - Added  a copy of the contents of continuous  memory
+ *                     when it was last saved - MT
+ *                   - Added  the  layout of the file used to hold  memory
+ *                     registers in mapped memory - MT
+ *                   - Added a count of writes to the registers used  by
+ *                     the display - MT
+ *                   - Added the memory address translation used by  the
+ *                     voyager models - MT
+ *                   - Added  routines to read and write HP67 program  and
+ *                     data cards - MT
+ *                   - Added autosave() which ignores the processor  state
+ *                     - MT
+ *                   - Added a version to the mapped memory file - MT
+ *                   - Added a ROM page table - MT
+ *                   - Added the HP67 card reader data register and track
+ *                     - MT
+ *                   - Added autosave_failed() - MT
+ *                   - Added address_map() - MT
+ *                   - Key timing is based on how long the ROMs take to
+ *                     read each key - MT
  *
  */
 
@@ -101,19 +127,63 @@
 #define MOTOR           5              /* Motor on */
 #define FUNCTION        6              /* Default function flag */
 #define READY           7
+#define WRITE           8              /* Write mode */
 
-#define STATES          8
+#define STATES          9
+
+#define CARD_DATA       0x99           /* Address of the card reader data register (also read at $9B) */
+#define CARD_WORDS      35             /* Leader, header, 32 words and checksum on one side of a card */
+#define CARD_NIBBLES    7              /* Digits in each word */
 #endif
 
 #if defined(HP10)
 #define BUFSIZE         20             /* Output buffer size */
 #endif
 
+/* A key press is latched into a status bit (or the keyboard flag) by the
+ * next instruction, but the ROM then has to see the key released and act
+ * on it before it looks for another key.  Entering '1 1 2 ENTER 3 + 7 *'
+ * with each key held for 128 ticks,  the slowest ROMs (HP29C, HP34C  and
+ * HP67) need another 256 ticks before the next key, and the others 32 to
+ * 192.  Slow functions take longer (SIN needs about 1500 on the  HP29C),
+ * so a key entered straight after one may still be missed.  A tick is one
+ * instruction, so when single stepping a key is held for the same number
+ * of steps.
+ */
+#define KEY_EVENTS      32             /* Size of the key event queue */
+#define KEY_HOLD        128            /* Minimum number of ticks a key is held down */
+#define KEY_DELAY       384            /* Minimum number of ticks between keys (allows half as much again as the slowest ROM) */
+
+#define ROM_PAGE        0x100          /* Words in each page of the ROM page table */
+#define ROM_PAGES       (0x10000 / ROM_PAGE)
+
+#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
+#define STATE_SIZE      (FLAGS + STATUS_BITS + (REGISTERS * REG_SIZE) + 5 + (MEMORY_SIZE * REG_SIZE))
+#else
+#define STATE_SIZE      (MEMORY_SIZE * REG_SIZE)
+#endif
+#define STATE_MEMORY    (STATE_SIZE - (MEMORY_SIZE * REG_SIZE)) /* Offset of the memory registers in the saved state */
+
 typedef struct {
    int id;
    unsigned char nibble[REG_SIZE];
 } oregister;
 
+#define MEMORY_VERSION  1              /* Change whenever the layout of the mapped memory file changes */
+
+typedef struct {
+   char name[16];                      /* Simulator that created the file */
+   unsigned int version;               /* Layout of the file */
+   unsigned int size;                  /* Number of memory registers */
+   unsigned int length;                /* Size of each register (bytes) */
+} omemory;                             /* Followed by the memory registers */
+
+typedef struct {
+   unsigned long time;                 /* When the event is due (in ticks) */
+   unsigned int code;                  /* Key code */
+   unsigned char pressed;              /* Pressed or released */
+} okey;
+
 typedef struct {
    oregister *reg[REGISTERS];          /* Registers */
    oregister *mem[MEMORY_SIZE];        /* Memory registers */
@@ -125,6 +195,11 @@ typedef struct {
    unsigned char status[STATUS_BITS];  /* Status (S0 - S15) */
 #if defined(HP67)
    unsigned char crc[STATES];          /* Card reader states */
+   oregister *card;                    /* Card reader data register */
+   unsigned long track[CARD_WORDS];    /* Words recorded on the card in the reader */
+   unsigned int words;                 /* Number of words on the card */
+   unsigned int word;                  /* Next word to be read or written */
+   unsigned char turbo;                /* Copy cards straight into memory */
 #endif
    unsigned int opcode;                /* Last opcode */
    unsigned int pc;                    /* Program counter */
@@ -135,12 +210,18 @@ typedef struct {
    unsigned char f;                    /* F register */
    unsigned char p;                    /* P register */
    unsigned char keypressed;           /* Key pressed */
+   okey key[KEY_EVENTS];               /* Key events waiting to be processed */
+   unsigned int head;                  /* Next key event */
+   unsigned int tail;                  /* Next free entry in queue */
+   unsigned long ticks;                /* Number of ticks since reset */
+   unsigned long due;                  /* When the last queued key event is due */
    unsigned char mode;                 /* Save run/prgm switch state */
    unsigned char timer;                /* Save timer switch state */
    unsigned char trace;                /* Trace flag */
    unsigned char step;                 /* Step flag */
    unsigned char sleep;                /* Sleep */
    unsigned char enabled;              /* Enabled */
+   unsigned int display;               /* Number of writes to the registers used by the display */
 #if defined(HP10)
    unsigned char print;                /* Save print mode */
    unsigned int position;              /* Position of next char in buffer */
@@ -154,12 +235,24 @@ typedef struct {
 #else
    unsigned int rom_number;            /* Delayed ROM number */
 #endif
+#if defined(WOODSTOCK) || defined(SPICE) || defined(HP10) || defined(HP67) || defined(VOYAGER)
+   unsigned int next[ROM_PAGES][2];    /* Start of each ROM page, and of the page after it when the program counter runs off the end */
+#if !defined(VOYAGER)
+   unsigned int page[ROM_PAGES];       /* Start of the ROM page selected by each page of the address space */
+#endif
+#endif
+#if defined(CONTINIOUS)
+   unsigned char saved[STATE_SIZE];    /* Continuous memory when last saved */
+   omemory *memory;                    /* Mapped memory registers (if used) */
+#endif
 } oprocessor;
 
 oprocessor *h_processor_create(int *h_rom);
 
 void v_processor_reset(oprocessor *h_processor);
 
+int i_processor_key(oprocessor *h_processor, unsigned int i_code, int b_pressed);
+
 void v_read_rom(oprocessor *h_processor, char *s_pathname);
 
 void v_read_state(oprocessor *h_processor, char *s_pathname);
@@ -168,9 +261,72 @@ void v_restore_state(oprocessor *h_processor);
 
 void v_save_state(oprocessor *h_processor);
 
+void v_autosave(oprocessor *h_processor);
+
+void v_autosave_start();
+
+int i_autosave_failed();
+
+void v_autosave_stop();
+
+void v_map_memory(oprocessor *h_processor, char *s_pathname);
+
+void v_sync_memory(oprocessor *h_processor);
+#if defined(HP67)
+
+void v_read_card(oprocessor *h_processor, char *s_folder);
+
+void v_write_card(oprocessor *h_processor, char *s_folder);
+#endif
+
 void v_fprint_registers(FILE *h_file, oprocessor *h_procesor);
 
 void v_fprint_memory(FILE *h_file, oprocessor *h_procesor);
 
 void v_processor_tick(oprocessor *h_procesor);
+
+/* Shared with the instruction decoder for each processor family */
+
+void v_fprint_register(FILE *h_file, oregister *h_register);
+
+void v_fprint_status(FILE *h_file, oprocessor *h_processor);
+#if defined(HP67)
+void v_card_transfer(oprocessor *h_processor);
+
+void v_card_eject(oprocessor *h_processor);
+#endif
+#if defined(HP10)
+void v_fprint_buffer(FILE *h_file, oprocessor *h_processor);
+#endif
+
+void v_reg_exch(oprocessor *h_processor, oregister *h_destination, oregister *h_source);
+
+void v_reg_copy(oprocessor *h_processor, oregister *h_destination, oregister *h_source);
+#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
+void v_reg_or(oprocessor *h_processor, oregister *h_destination, oregister *h_source, oregister *h_argument);
+
+void v_reg_and(oprocessor *h_processor, oregister *h_destination, oregister *h_source, oregister *h_argument);
+#endif
+
+void v_reg_add(oprocessor *h_processor, oregister *h_destination, oregister *h_source, oregister *h_argument);
+
+void v_reg_sub(oprocessor *h_processor, oregister *h_destination, oregister *h_source, oregister *h_argument);
+
+void v_reg_test_eq(oprocessor *h_processor, oregister *h_destination, oregister *h_source);
+
+void v_reg_test_ne(oprocessor *h_processor, oregister *h_destination, oregister *h_source);
+
+void v_reg_inc(oprocessor *h_processor, oregister *h_register);
+
+void v_reg_shr(oprocessor *h_processor, oregister *h_register);
+
+void v_reg_shl(oprocessor *h_processor, oregister *h_register);
+
+void v_processor_execute(oprocessor *h_processor);
+#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
+
+void v_address_map();
+
+int i_translate_addr(int i_addr);
+#endif
 #endif
@@ -70,6 +70,25 @@
  *                     number digits to determine the size and position  of
  *                     each digit in the display - MT
  *                   - Added dummy digit to the HP10 display - MT
+ * 17 Oct 26         - Only redraws the digits and annunciators that  have
+ *                     changed  since the display was last drawn, so nothing
+ *                     is sent to the X server while the display is  static
+ *                     - MT
+ *                   - Uses the common drawing routines - MT
+ *                   - Allocated from the current arena - MT
+ *                   - Only decodes the voyager display when the display
+ *                     registers have been written to, using a table of the
+ *                     segments shown by each nibble - MT
+ *                   - Only decodes the display when the registers used by
+ *                     the display have been written to, or the display has
+ *                     been enabled or disabled - MT
+ *                   - Uses a look up table to find the segments shown  in
+ *                     each digit of the HP67 and woodstock displays - MT
+ *                   - The classic and spice decoders are deliberately left
+ *                     unchanged, as each digit depends on its  neighbours
+ *                     (decimal point offset and sign) - MT
+ *                   - Unexpected output formats are only reported when the
+ *                     display is decoded, not every time it is updated - MT
  *
  */
 
@@ -80,6 +99,7 @@
 
 #include <stdlib.h>    /* malloc(), etc. */
 #include <stdio.h>     /* fprintf(), etc. */
+#include <string.h>    /* memset(), etc. */
 
 #include <X11/Xlib.h>  /* XOpenDisplay(), etc. */
 #include <X11/Xutil.h> /* XSizeHints etc. */
@@ -94,6 +114,8 @@
 #include "x11-calc-colour.h"
 #include "x11-calc-segment.h"
 #include "x11-calc-display.h"
+#include "x11-calc-render.h"
+#include "x11-calc-arena.h"
 #include "x11-calc-cpu.h"
 
 #include "gcc-debug.h"
@@ -118,7 +140,7 @@ odisplay *h_display_create(int i_index, int i_left, int i_top, int i_width, int
 
 
    /* Attempt to allocate memory for a display. */
-   if ((h_display = malloc(sizeof(*h_display)))==NULL) v_error("Memory allocation failed!");
+   h_display = h_arena_alloc(sizeof(*h_display));
    h_display->index = i_index;
    h_display->left = i_left;
    h_display->top = i_top;
@@ -145,7 +167,9 @@ odisplay *h_display_create(int i_index, int i_left, int i_top, int i_width, int
    }
    for (i_count = 0; i_count < DIGITS; i_count++) {
       h_display->segment[i_count]->mask = DISPLAY_SPACE;
+      h_display->mask[i_count] = -1; /* Not drawn yet */
    }
+   h_display->enabled = -1; /* Not decoded yet */
 
 #if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
    i_top += i_display_height - h_small_font->descent;
@@ -190,6 +214,9 @@ odisplay *h_display_create(int i_index, int i_left, int i_top, int i_width, int
    i_width = 1 + XTextWidth(h_small_font, " PRGM ", 6) * SCALE_WIDTH;
    h_display->label[7] = h_label_create(010, " PRGM " , h_small_font, i_left, i_top,
       i_width, i_height, i_foreground, i_background, False);
+
+   for (i_count = 0; i_count < INDECATORS; i_count++)
+      h_display->state[i_count] = -1; /* Not drawn yet */
 #endif
 
    h_display->foreground = i_foreground;
@@ -212,26 +239,93 @@ int i_display_draw(Display* x_display, int x_application_window, int i_screen, o
 
    if (h_display->display_top != 0 || h_display->display_left != 0 || h_display->display_width != h_display->width || h_display->height != h_display->display_height)
    {
-      XSetForeground(x_display, DefaultGC(x_display, i_screen), h_display->border); /* Set the border colour. */
-      XFillRectangle(x_display, x_application_window, DefaultGC(x_display, i_screen), h_display->left, h_display->top, h_display->width, h_display->height); /* Fill in the border. */
+      v_render_fill(x_display, x_application_window, h_display->border, h_display->left, h_display->top, h_display->width, h_display->height); /* Fill in the border. */
    }
 
-   XSetForeground(x_display, DefaultGC(x_display, i_screen), h_display->fill); /* Set the background colour. */
-   XFillRectangle(x_display, x_application_window, DefaultGC(x_display, i_screen), h_display->left + h_display->display_left, h_display->top + h_display->display_top, h_display->display_width, h_display->display_height); /* Fill in the background. */
+   v_render_fill(x_display, x_application_window, h_display->fill, h_display->left + h_display->display_left, h_display->top + h_display->display_top, h_display->display_width, h_display->display_height); /* Fill in the background. */
+   v_render_flush(x_display);
 
    /* Draw display segments. */
    for (i_count = 0; i_count < DIGITS; i_count++)
-      if (!(h_display->segment[i_count] == NULL)) i_segment_draw(x_display, x_application_window, i_screen, h_display->segment[i_count]);
+      if (!(h_display->segment[i_count] == NULL))
+      {
+         i_segment_draw(x_display, x_application_window, i_screen, h_display->segment[i_count]);
+         h_display->mask[i_count] = h_display->segment[i_count]->mask;
+      }
 
 #if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
    for (i_count = 0; i_count < INDECATORS; i_count++)
+   {
       i_label_draw(x_display, x_application_window, i_screen, h_display->label[i_count]);
+      if (h_display->label[i_count] != NULL) h_display->state[i_count] = h_display->label[i_count]->state;
+   }
 #endif
 
   return (True);
 
 }
 
+/*
+ * display_refresh (display, window, screen, display)
+ *
+ * Redraws only the digits (and annunciators) that have changed since the
+ * display was last drawn, so nothing is drawn if the display is static.
+ *
+ */
+
+int i_display_refresh(Display* x_display, int x_application_window, int i_screen, odisplay *h_display){
+
+   int i_count;
+#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
+   int i_left, i_right, i_top, i_height;
+   char b_changed = False;
+#endif
+
+   for (i_count = 0; i_count < DIGITS; i_count++)
+      if (h_display->segment[i_count] != NULL)
+         if (h_display->segment[i_count]->mask != h_display->mask[i_count])
+         {
+            i_segment_draw(x_display, x_application_window, i_screen, h_display->segment[i_count]); /* Each digit fills in its own background */
+            h_display->mask[i_count] = h_display->segment[i_count]->mask;
+         }
+
+#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
+   /*
+    * Some annunciators share the same position (RAD and GRAD) and each one
+    * fills in a background slightly wider than the label, so if any of them
+    * have changed clear the whole row and draw all those that are visible.
+    */
+   i_left = h_display->left + h_display->display_left + h_display->display_width;
+   i_right = h_display->left + h_display->display_left;
+   i_top = i_height = 0;
+   for (i_count = 0; i_count < INDECATORS; i_count++)
+      if (h_display->label[i_count] != NULL)
+      {
+         if (h_display->label[i_count]->state != h_display->state[i_count]) b_changed = True;
+         if (h_display->label[i_count]->left - 3 < i_left) i_left = h_display->label[i_count]->left - 3;
+         if (h_display->label[i_count]->left + h_display->label[i_count]->width + 3 > i_right) i_right = h_display->label[i_count]->left + h_display->label[i_count]->width + 3;
+         i_top = h_display->label[i_count]->top;
+         i_height = h_display->label[i_count]->height;
+      }
+
+   if (b_changed)
+   {
+      if (i_left < h_display->left + h_display->display_left) i_left = h_display->left + h_display->display_left;
+      if (i_right > h_display->left + h_display->display_left + h_display->display_width) i_right = h_display->left + h_display->display_left + h_display->display_width;
+      v_render_fill(x_display, x_application_window, h_display->fill, i_left, i_top, i_right - i_left, i_height); /* Clear the annunciators. */
+      v_render_flush(x_display);
+      for (i_count = 0; i_count < INDECATORS; i_count++)
+         if (h_display->label[i_count] != NULL)
+         {
+            i_label_draw(x_display, x_application_window, i_screen, h_display->label[i_count]);
+            h_display->state[i_count] = h_display->label[i_count]->state;
+         }
+   }
+#endif
+
+   return (True);
+}
+
 /*
  * display_update (display, window, screen, display)
  *
@@ -239,14 +333,41 @@ int i_display_draw(Display* x_display, int x_application_window, int i_screen, o
  *
  */
 
-int i_display_update(Display* x_display, int x_application_window, int i_screen, odisplay *h_display, oprocessor *h_processor){
+static void v_display_decode(odisplay *h_display, oprocessor *h_processor) /* Work out which segments are shown in each digit */
+{
 #if defined(HP67) || defined(HP19c)
-   int i_count;
+   int i_count, i_format, i_value;
    static int c_digits [] =
    {
       DISPLAY_ZERO, DISPLAY_ONE, DISPLAY_TWO, DISPLAY_THREE, DISPLAY_FOUR, DISPLAY_FIVE, DISPLAY_SIX, DISPLAY_SEVEN,
       DISPLAY_EIGHT, DISPLAY_NINE, DISPLAY_r, DISPLAY_C, DISPLAY_o, DISPLAY_d, DISPLAY_E, DISPLAY_SPACE
    };
+   static int i_glyph[16][16]; /* Segments shown for each format (B) and value (A) */
+   static char b_table = False;
+
+   if (!b_table) /* Build the look up table the first time through */
+   {
+      for (i_format = 0; i_format < 16; i_format++)
+         for (i_value = 0; i_value < 16; i_value++)
+            switch (i_format) {
+            case 0x03: /* Decimal point */
+               i_glyph[i_format][i_value] = DISPLAY_DECIMAL;
+               break;
+            case 0x0F:
+            case 0x02:
+            case 0x01: /* Space */
+               i_glyph[i_format][i_value] = DISPLAY_SPACE;
+               break;
+            case 0x09:
+            case 0x04:
+            case 0x00: /* Number */
+               i_glyph[i_format][i_value] = c_digits[i_value];
+               break;
+            default:
+               i_glyph[i_format][i_value] = -1; /* Unexpected */
+            }
+      b_table = True;
+   }
 
    for (i_count = 0; i_count < DIGITS; i_count++) {
       if (h_display->segment[i_count] != NULL) {
@@ -270,21 +391,10 @@ int i_display_update(Display* x_display, int x_application_window, int i_screen,
                }
                break;
             default:
-               switch (h_processor->reg[B_REG]->nibble[REG_SIZE - i_count] & 0x0F) {
-               case 0x03: /* Decimal point */
-                  h_display->segment[i_count]->mask = DISPLAY_DECIMAL;
-                  break;
-               case 0x0F:
-               case 0x02:
-               case 0x01: /* Space */
-                     h_display->segment[i_count]->mask = DISPLAY_SPACE;
-                  break;
-               case 0x09:
-               case 0x04:
-               case 0x00: /* Number */
-                  h_display->segment[i_count]->mask = c_digits[h_processor->reg[A_REG]->nibble[REG_SIZE - i_count]];
-                  break;
-               default:
+               i_value = i_glyph[h_processor->reg[B_REG]->nibble[REG_SIZE - i_count] & 0x0F][h_processor->reg[A_REG]->nibble[REG_SIZE - i_count]];
+               if (i_value >= 0)
+                  h_display->segment[i_count]->mask = i_value;
+               else {
                   debug(v_fprint_registers(stderr, h_processor);
                   v_warning("Unexpected output format specified in %s line : %d\n", __FILE__, __LINE__));
                }
@@ -428,8 +538,17 @@ int i_display_update(Display* x_display, int x_application_window, int i_screen,
     * the segments individually, using the table below to map the values in
     * the two memory registers to each segment in each digit...
     *
+    * Since  each digit only depends on a few nibbles the table is used  to
+    * build a list of the nibbles used by each digit and the segments shown
+    * for every value of each nibble, and only digits using a nibble that
+    * has changed since the display was last decoded are decoded again.
+    *
     */
-   int i_count, i_counter;
+   int i_count, i_counter, i_index, i_digit, b_enabled, b_changed;
+   static int i_nibbles[DIGITS]; /* Number of nibbles used by each digit */
+   static int i_nibble[DIGITS][9][2]; /* Register and nibble used by each digit */
+   static int i_segments[DIGITS][9][16]; /* Segments shown for each value of each nibble */
+   static char b_table = False;
 #if defined(HP10c) /* Uses a different display to the earlier models so the look up table is different */
    static int i_map [DIGITS][9][3] =
    { /*      A             B             C             D             E             F             G             H             I                    */
@@ -447,21 +566,6 @@ int i_display_update(Display* x_display, int x_application_window, int i_screen,
       {{ 9,  6,  2}, { 9,  6,  1}, { 9,  6,  4}, { 9,  4,  8}, { 9,  6,  8}, { 9,  5,  8}, { 9,  5,  4}, { 9,  5,  2}, { 9,  5,  1}}  /* Digit 10 */
    };
 
-   for (i_count = 0; i_count < INDECATORS; i_count++)
-      if (h_display->label[i_count] != NULL)
-         h_display->label[i_count]->state = False;
-
-   if (h_processor->flags[DISPLAY_ENABLE] && h_processor->enabled)
-   {
-      h_display->label[0]->state = False;                                     /* USER - not used */
-      h_display->label[1]->state = (h_processor->mem[10]->nibble[13] & 0x4);  /* f */
-      h_display->label[2]->state = False;                                     /* g - not used */
-      h_display->label[3]->state = (h_processor->mem[9]->nibble[2] & 0x1);    /* RAD */
-      h_display->label[4]->state = (h_processor->mem[9]->nibble[1] & 0x4);    /* GRAD */
-      h_display->label[5]->state = False;                                     /* D.MY - not used */
-      h_display->label[6]->state = False;                                     /* C - not used */
-      h_display->label[7]->state = (h_processor->mem[9]->nibble[4] & 0x4);    /* PRGM */
-   }
 #else
    static int i_map [DIGITS][9][3] =
    { /*      A             B             C             D             E             F             G             H             I                    */
@@ -479,6 +583,53 @@ int i_display_update(Display* x_display, int x_application_window, int i_screen,
       {{10, 13,  2}, {10, 13,  1}, {10, 12,  4}, {10, 10,  2}, {10, 12,  8}, {10, 13,  8}, {10, 13,  4}, {10, 10,  8}, {10, 10,  4}}  /* Digit 10 */
    };
 
+#endif
+
+   if (!b_table) /* Build the look up tables the first time through */
+   {
+      for (i_digit = 0; i_digit < DIGITS; i_digit++)
+      {
+         i_nibbles[i_digit] = 0;
+         for (i_counter = 0; i_counter < 9; i_counter++)
+         {
+            if (i_map[i_digit][i_counter][0] > 0)
+            {
+               for (i_count = 0; i_count < i_nibbles[i_digit]; i_count++) /* Find the nibble */
+                  if ((i_nibble[i_digit][i_count][0] == i_map[i_digit][i_counter][0]) && (i_nibble[i_digit][i_count][1] == i_map[i_digit][i_counter][1])) break;
+               if (i_count == i_nibbles[i_digit]) /* Add it if this is the first time it has been used */
+               {
+                  i_nibble[i_digit][i_count][0] = i_map[i_digit][i_counter][0];
+                  i_nibble[i_digit][i_count][1] = i_map[i_digit][i_counter][1];
+                  memset(i_segments[i_digit][i_count], 0, sizeof(i_segments[i_digit][i_count]));
+                  i_nibbles[i_digit]++;
+               }
+               for (i_index = 0; i_index < 16; i_index++)
+                  if (i_index & i_map[i_digit][i_counter][2]) i_segments[i_digit][i_count][i_index] |= (1 << i_counter);
+            }
+         }
+      }
+      b_table = True;
+   }
+
+   b_enabled = (h_processor->flags[DISPLAY_ENABLE] && h_processor->enabled);
+
+#if defined(HP10c)
+   for (i_count = 0; i_count < INDECATORS; i_count++)
+      if (h_display->label[i_count] != NULL)
+         h_display->label[i_count]->state = False;
+
+   if (h_processor->flags[DISPLAY_ENABLE] && h_processor->enabled)
+   {
+      h_display->label[0]->state = False;                                     /* USER - not used */
+      h_display->label[1]->state = (h_processor->mem[10]->nibble[13] & 0x4);  /* f */
+      h_display->label[2]->state = False;                                     /* g - not used */
+      h_display->label[3]->state = (h_processor->mem[9]->nibble[2] & 0x1);    /* RAD */
+      h_display->label[4]->state = (h_processor->mem[9]->nibble[1] & 0x4);    /* GRAD */
+      h_display->label[5]->state = False;                                     /* D.MY - not used */
+      h_display->label[6]->state = False;                                     /* C - not used */
+      h_display->label[7]->state = (h_processor->mem[9]->nibble[4] & 0x4);    /* PRGM */
+   }
+#else
    for (i_count = 0; i_count < INDECATORS; i_count++)
       if (h_display->label[i_count] != NULL)
          h_display->label[i_count]->state = False;
@@ -497,51 +648,87 @@ int i_display_update(Display* x_display, int x_application_window, int i_screen,
       h_display->label[5]->state = (h_processor->mem[10]->nibble[9] & 0x4);   /* D.MY */
       h_display->label[6]->state = (h_processor->mem[10]->nibble[8] & 0x1);   /* C */
       h_display->label[7]->state = (h_processor->mem[10]->nibble[10] & 0x1);  /* PRGM */
-}
+   }
 #endif
-   for (i_count = 0; i_count < DIGITS; i_count++)
+
+   for (i_digit = 0; i_digit < DIGITS; i_digit++)
    {
-      if (h_display->segment[i_count] != NULL)
+      if (h_display->segment[i_digit] != NULL)
       {
-         h_display->segment[i_count]->mask = DISPLAY_SPACE;
-         if (h_processor->flags[DISPLAY_ENABLE] && h_processor->enabled)
+         if (b_enabled)
          {
-            for (i_counter = 0; i_counter < 9; i_counter++)
+            b_changed = (b_enabled != h_display->enabled);
+            for (i_count = 0; i_count < i_nibbles[i_digit]; i_count++)
             {
-               if (i_map[i_count][i_counter][0] > 0)
-                  if ((h_processor->mem[i_map[i_count][i_counter][0]]->nibble[i_map[i_count][i_counter][1]] & i_map[i_count][i_counter][2]))
-                     h_display->segment[i_count]->mask |= (1 << i_counter); /* Mask determines which segments are on */
+               i_index = h_processor->mem[i_nibble[i_digit][i_count][0]]->nibble[i_nibble[i_digit][i_count][1]];
+               if (i_index != h_display->nibble[i_nibble[i_digit][i_count][0] - 9][i_nibble[i_digit][i_count][1]]) b_changed = True;
+            }
+            if (b_changed) /* Only decode digits that use a nibble that has changed */
+            {
+               h_display->segment[i_digit]->mask = DISPLAY_SPACE;
+               for (i_count = 0; i_count < i_nibbles[i_digit]; i_count++)
+                  h_display->segment[i_digit]->mask |= i_segments[i_digit][i_count][h_processor->mem[i_nibble[i_digit][i_count][0]]->nibble[i_nibble[i_digit][i_count][1]]]; /* Mask determines which segments are on */
             }
          }
+         else
+            h_display->segment[i_digit]->mask = DISPLAY_SPACE;
       }
    }
+   for (i_count = 0; i_count < REG_SIZE; i_count++) /* Keep a copy of the display registers */
+   {
+      h_display->nibble[0][i_count] = h_processor->mem[9]->nibble[i_count];
+      h_display->nibble[1][i_count] = h_processor->mem[10]->nibble[i_count];
+   }
 #else
-   int i_count;
+   int i_count, i_format, i_value;
    static int c_digits [] =
    {
       DISPLAY_ZERO, DISPLAY_ONE, DISPLAY_TWO, DISPLAY_THREE, DISPLAY_FOUR, DISPLAY_FIVE, DISPLAY_SIX, DISPLAY_SEVEN,
       DISPLAY_EIGHT, DISPLAY_NINE, DISPLAY_r, DISPLAY_c, DISPLAY_o, DISPLAY_P, DISPLAY_E, DISPLAY_SPACE
    };
+   static int i_glyph[8][16]; /* Segments shown for each format (B) and value (A) */
+   static char b_table = False;
 
-   for (i_count = 0; i_count < DIGITS; i_count++) {
-      if (h_display->segment[i_count] != NULL) {
-         if (h_processor->flags[DISPLAY_ENABLE] && h_processor->enabled) {
-            h_display->segment[i_count]->mask = c_digits[h_processor->reg[A_REG]->nibble[REG_SIZE - 1 - i_count]];
-            switch (h_processor->reg[B_REG]->nibble[REG_SIZE - 1 - i_count] & 0x07) {
+   if (!b_table) /* Build the look up table the first time through */
+   {
+      for (i_format = 0; i_format < 8; i_format++)
+         for (i_value = 0; i_value < 16; i_value++)
+            switch (i_format) {
             case 0x02: /* Sign */
-               if (h_processor->reg[A_REG]->nibble[REG_SIZE - 1 - i_count])
-                  h_display->segment[i_count]->mask = DISPLAY_MINUS;
+               if (i_value)
+                  i_glyph[i_format][i_value] = DISPLAY_MINUS;
                else
-                  h_display->segment[i_count]->mask = DISPLAY_SPACE;
+                  i_glyph[i_format][i_value] = DISPLAY_SPACE;
                break;
             case 0x01: /* Number and decimal point */
-               h_display->segment[i_count]->mask = h_display->segment[i_count]->mask | DISPLAY_DECIMAL;
+               i_glyph[i_format][i_value] = c_digits[i_value] | DISPLAY_DECIMAL;
+               break;
+            default: /* Number */
+               i_glyph[i_format][i_value] = c_digits[i_value];
             }
-         }
+      b_table = True;
+   }
+
+   for (i_count = 0; i_count < DIGITS; i_count++) {
+      if (h_display->segment[i_count] != NULL) {
+         if (h_processor->flags[DISPLAY_ENABLE] && h_processor->enabled)
+            h_display->segment[i_count]->mask = i_glyph[h_processor->reg[B_REG]->nibble[REG_SIZE - 1 - i_count] & 0x07][h_processor->reg[A_REG]->nibble[REG_SIZE - 1 - i_count]];
          else
             h_display->segment[i_count]->mask = DISPLAY_SPACE;
       }
    }
 #endif
+}
+
+int i_display_update(Display* x_display, int x_application_window, int i_screen, odisplay *h_display, oprocessor *h_processor){
+   int b_enabled;
+
+   b_enabled = (h_processor->flags[DISPLAY_ENABLE] && h_processor->enabled);
+   if ((b_enabled != h_display->enabled) || (h_processor->display != h_display->generation)) /* Only decode the display (and report any unexpected formats) if it has changed */
+   {
+      v_display_decode(h_display, h_processor);
+      h_display->generation = h_processor->display;
+      h_display->enabled = b_enabled;
+   }
    return (True);
 }
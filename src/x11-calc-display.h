@@ -34,6 +34,11 @@
  * 12 Mar 22         - Added display annunciators - MT
  * 11 Dec 22         - Renamed models with continious memory and added hp25
  *                     hp33e, and hp38e - MT
+ * 17 Oct 26         - Keeps  track  of the segments and  annunciators  that
+ *                     were shown when the display was last drawn - MT
+ *                   - Keeps a copy of the voyager display registers - MT
+ *                   - Keeps  track of the number of writes to the registers
+ *                     used by the display when it was last decoded - MT
  *
  */
 
@@ -71,6 +76,7 @@
 typedef struct { /* Calculator display structure. */
    int index;
    osegment* segment[DIGITS];
+   int mask[DIGITS]; /* Segments shown when last drawn */
    int left;
    int top;
    int width;
@@ -85,6 +91,12 @@ typedef struct { /* Calculator display structure. */
    unsigned int border;
 #if defined(INDECATORS)
    olabel* label[INDECATORS];
+   int state[INDECATORS]; /* Annunciators shown when last drawn */
+#endif
+   unsigned int generation; /* Number of writes to the registers used by the display when last decoded */
+   int enabled; /* Display enabled when last decoded */
+#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
+   unsigned char nibble[2][REG_SIZE]; /* Display registers when last decoded */
 #endif
 } odisplay;
 
@@ -95,4 +107,6 @@ odisplay *h_display_create(int i_index,
 
 int i_display_draw(Display* x_display, int x_application_window, int i_screen, odisplay *h_display);
 
+int i_display_refresh(Display* x_display, int x_application_window, int i_screen, odisplay *h_display);
+
 int i_display_update(Display* x_display, int x_application_window, int i_screen, odisplay *h_display, oprocessor *h_processor);
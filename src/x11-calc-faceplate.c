@@ -0,0 +1,169 @@
+/*
+ * x11-calc-faceplate.c - RPN (Reverse Polish) calculator simulator.
+ *
+ * Copyright(C) 2026   MT
+ *
+ * Defines the routines and data structures used to hold an off-screen copy
+ * of the calculator faceplate.
+ *
+ * The  labels, switches and buttons are drawn into a pixmap once, so  when
+ * part of the window is exposed it can be redrawn by just copying the area
+ * that  was exposed from the pixmap.  Since an expose event is  often  one
+ * of  a series the area to be redrawn is accumulated until the last  event
+ * in the series arrives and then copied in one go.
+ *
+ * This  program is free software: you can redistribute it and/or modify it
+ * under  the terms of the GNU General Public License as published  by  the
+ * Free  Software Foundation, either version 3 of the License, or (at  your
+ * option) any later version.
+ *
+ * This  program  is distributed in the hope that it will  be  useful,  but
+ * WITHOUT   ANY   WARRANTY;   without even   the   implied   warranty   of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You  should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * 17 Oct 26         - Initial version - MT
+ *                   - Faceplate may be held in a client side image - MT
+ *                   - Added faceplate_free() - MT
+ *                   - Keeps  a map showing which button or switch is  at
+ *                     each position - MT
+ *                   - Allocated from the current arena - MT
+ *                   - Map is allocated from the current arena too - MT
+ *
+ */
+
+#define VERSION        "0.1"
+#define BUILD          "0001"
+#define DATE           "17 Oct 26"
+#define AUTHOR         "MT"
+
+#include <stdio.h>     /* fprintf(), etc. */
+#include <stdlib.h>    /* malloc(), etc. */
+#include <string.h>    /* memset(), etc. */
+
+#include <X11/Xlib.h>  /* XOpenDisplay(), etc. */
+#include <X11/Xutil.h> /* XSizeHints etc. */
+
+#include "x11-calc-font.h"
+#include "x11-calc-label.h"
+#include "x11-calc-switch.h"
+#include "x11-calc-button.h"
+#include "x11-calc-faceplate.h"
+#include "x11-calc-render.h"
+#include "x11-calc-arena.h"
+
+#include "x11-calc.h"
+
+#include "gcc-debug.h"
+
+/*
+ * faceplate_create (display, window, screen, width, height, background)
+ *
+ * Allocates storage for the faceplate and creates an empty pixmap to hold
+ * a copy of it, or exits the program if there isn't enough memory.
+ *
+ */
+
+ofaceplate *h_faceplate_create(Display *h_display, int x_application_window, int i_screen,
+   int i_width, int i_height, unsigned int i_background) {
+
+   ofaceplate *h_faceplate; /* Pointer to faceplate. */
+
+   /* Attempt to allocate memory for a faceplate. */
+   h_faceplate = h_arena_alloc(sizeof(*h_faceplate));
+
+   h_faceplate->width = i_width;
+   h_faceplate->height = i_height;
+   h_faceplate->background = i_background;
+   h_faceplate->left = h_faceplate->top = h_faceplate->right = h_faceplate->bottom = 0; /* Nothing to redraw */
+
+   h_faceplate->map = h_arena_alloc(i_width * i_height * sizeof(*h_faceplate->map)); /* Released with the rest of the layout */
+   memset(h_faceplate->map, 0, i_width * i_height * sizeof(*h_faceplate->map));
+
+   h_faceplate->pixmap = x_render_create(h_display, x_application_window, i_width, i_height);
+   v_render_fill(h_display, h_faceplate->pixmap, i_background, 0, 0, i_width, i_height); /* Fill in the background. */
+   v_render_flush(h_display);
+   return(h_faceplate);
+}
+
+/*
+ * faceplate_expose (faceplate, left, top, width, height)
+ *
+ * Adds an area to the region of the window that needs to be redrawn.
+ *
+ */
+
+void v_faceplate_expose(ofaceplate *h_faceplate, int i_left, int i_top, int i_width, int i_height) {
+
+   if ((i_width <= 0) || (i_height <= 0)) return;
+   if (h_faceplate->right <= h_faceplate->left || h_faceplate->bottom <= h_faceplate->top)
+   {
+      h_faceplate->left = i_left;
+      h_faceplate->top = i_top;
+      h_faceplate->right = i_left + i_width;
+      h_faceplate->bottom = i_top + i_height;
+   }
+   else
+   {
+      if (i_left < h_faceplate->left) h_faceplate->left = i_left;
+      if (i_top < h_faceplate->top) h_faceplate->top = i_top;
+      if (i_left + i_width > h_faceplate->right) h_faceplate->right = i_left + i_width;
+      if (i_top + i_height > h_faceplate->bottom) h_faceplate->bottom = i_top + i_height;
+   }
+}
+
+/*
+ * faceplate_draw (display, window, screen, faceplate)
+ *
+ * Copies the area that needs to be redrawn from the pixmap to the window.
+ *
+ */
+
+int i_faceplate_draw(Display *h_display, int x_application_window, int i_screen, ofaceplate *h_faceplate) {
+
+   if (h_faceplate->right <= h_faceplate->left || h_faceplate->bottom <= h_faceplate->top) return(False); /* Nothing to do */
+
+   v_render_copy(h_display, h_faceplate->pixmap, x_application_window,
+      h_faceplate->left, h_faceplate->top,
+      h_faceplate->right - h_faceplate->left, h_faceplate->bottom - h_faceplate->top,
+      h_faceplate->left, h_faceplate->top);
+   h_faceplate->left = h_faceplate->top = h_faceplate->right = h_faceplate->bottom = 0;
+   return(True);
+}
+
+/* faceplate_free (display, faceplate) */
+
+void v_faceplate_free(Display *h_display, ofaceplate *h_faceplate) {
+
+   v_render_free(h_display, h_faceplate->pixmap); /* The faceplate and map belong to the arena */
+}
+
+/*
+ * faceplate_map (faceplate, left, top, width, height, value)
+ *
+ * Marks the inside of a button or switch on the map, so it can be found by
+ * position without having to check every button and switch.
+ *
+ */
+
+void v_faceplate_map(ofaceplate *h_faceplate, int i_left, int i_top, int i_width, int i_height, int i_value) {
+
+   int i_x, i_y;
+
+   for (i_y = i_top + 1; i_y < i_top + i_height; i_y++) /* Edges aren't included */
+      if ((i_y >= 0) && (i_y < h_faceplate->height))
+         for (i_x = i_left + 1; i_x < i_left + i_width; i_x++)
+            if ((i_x >= 0) && (i_x < h_faceplate->width))
+               h_faceplate->map[i_y * h_faceplate->width + i_x] = i_value;
+}
+
+/* faceplate_find (faceplate, x, y) */
+
+int i_faceplate_find(ofaceplate *h_faceplate, int i_xpos, int i_ypos) {
+
+   if ((i_xpos < 0) || (i_xpos >= h_faceplate->width) || (i_ypos < 0) || (i_ypos >= h_faceplate->height)) return(0);
+   return(h_faceplate->map[i_ypos * h_faceplate->width + i_xpos]);
+}
@@ -0,0 +1,53 @@
+/*
+ * x11-calc-faceplate.h - RPN (Reverse Polish) calculator simulator.
+ *
+ * Copyright(C) 2026   MT
+ *
+ * Defines the routines and data structures used to hold an off-screen copy
+ * of the calculator faceplate.
+ *
+ * This  program is free software: you can redistribute it and/or modify it
+ * under  the terms of the GNU General Public License as published  by  the
+ * Free  Software Foundation, either version 3 of the License, or (at  your
+ * option) any later version.
+ *
+ * This  program  is distributed in the hope that it will  be  useful,  but
+ * WITHOUT   ANY   WARRANTY;   without even   the   implied   warranty   of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You  should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * 17 Oct 26         - Initial version - MT
+ *                   - Added faceplate_free() - MT
+ *                   - Added a map of the buttons and switches - MT
+ *
+ */
+
+#define FACEPLATE_SWITCH 0x80  /* Switches are identified by adding this to their index */
+
+typedef struct { /* Calculator faceplate structure */
+   Pixmap pixmap; /* Off-screen copy of the faceplate */
+   int width;
+   int height;
+   unsigned int background; /* Background colour */
+   int left; /* Area waiting to be redrawn */
+   int top;
+   int right;
+   int bottom;
+   unsigned char *map; /* Identifies what is at each position (allocated from the arena) */
+} ofaceplate;
+
+ofaceplate *h_faceplate_create(Display *h_display, int x_application_window, int i_screen,
+   int i_width, int i_height, unsigned int i_background);
+
+void v_faceplate_expose(ofaceplate *h_faceplate, int i_left, int i_top, int i_width, int i_height);
+
+int i_faceplate_draw(Display *h_display, int x_application_window, int i_screen, ofaceplate *h_faceplate);
+
+void v_faceplate_free(Display *h_display, ofaceplate *h_faceplate);
+
+void v_faceplate_map(ofaceplate *h_faceplate, int i_left, int i_top, int i_width, int i_height, int i_value);
+
+int i_faceplate_find(ofaceplate *h_faceplate, int i_xpos, int i_ypos);
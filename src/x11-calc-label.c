@@ -24,6 +24,8 @@
  * 10 Feb 22         - Added background shading and horizontal line - MT
  * 12 Mar 22         - Implemented a state property allowing the appearance
  *                     of the label to be changed (hidden, or no line) - MT
+ * 17 Oct 26         - Uses the common drawing routines - MT
+ *                   - Allocated from the current arena - MT
  *
  * TO DO:            - Implement ability to align text in a label using the
  *                     style property to modify the position and appearance
@@ -51,6 +53,8 @@
 #include "x11-calc.h"
 
 #include "x11-calc-colour.h"
+#include "x11-calc-render.h"
+#include "x11-calc-arena.h"
 #include "gcc-debug.h"
 
 /* label_pressed (label, x, y) */
@@ -79,8 +83,7 @@ olabel *h_label_create(int i_index, char* s_text, XFontStruct *h_font,
 
    olabel *h_label; /* Ponter to label. */
 
-   /* Attempt to allcoate memory for a label. */
-   if ((h_label = malloc (sizeof(*h_label)))==NULL) v_error("Memory allocation failed!");
+   h_label = h_arena_alloc(sizeof(*h_label));
 
    h_label->index = i_index;
    h_label->text = s_text;
@@ -101,26 +104,29 @@ olabel *h_label_create(int i_index, char* s_text, XFontStruct *h_font,
 
 int i_label_draw(Display *h_display, int x_application_window, int i_screen, olabel *h_label){
 
+   XFontStruct *h_font;
+   unsigned int i_colour;
    int i_indent, i_upper, i_offset;
    if (h_label != NULL) {
       if (h_label->state)
       {
          i_offset = h_label->top + h_label->height / 2;
-         XSetFont(h_display, DefaultGC(h_display, i_screen), h_label->text_font->fid); /* Set the text font. */
+         h_font = h_label->text_font; /* Set the text font. */
          i_indent = 1 + h_label->left + (h_label->width - XTextWidth(h_label->text_font, h_label->text, strlen(h_label->text))) / 2; /* Find position of the text. */
          i_upper = h_label->top + (h_label->text_font->ascent) + (h_label->height - (h_label->text_font->ascent + h_label->text_font->descent)) / 2; /* Position text in middle of label. */
 
-         XSetForeground(h_display, DefaultGC(h_display, i_screen), h_label->background);
-         XFillRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), h_label->left, h_label->top , h_label->width, h_label->height); /* Fill in label background. */
+         i_colour = h_label->background;
+         v_render_fill(h_display, x_application_window, i_colour, h_label->left, h_label->top , h_label->width, h_label->height); /* Fill in label background. */
 
-         XSetForeground(h_display, DefaultGC(h_display, i_screen), h_label->colour); /* Set the text colour. */
-         if (h_label->state < 0) XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen),h_label->left , i_offset, h_label->left + h_label->width - 2, i_offset); /* Draw line through middle of label. */
+         i_colour = h_label->colour; /* Set the text colour. */
+         if (h_label->state < 0) v_render_line(h_display, x_application_window, i_colour, h_label->left , i_offset, h_label->left + h_label->width - 2, i_offset); /* Draw line through middle of label. */
 
-         XSetForeground(h_display, DefaultGC(h_display, i_screen), h_label->background);
-         XFillRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), (i_indent - 3), h_label->top , XTextWidth(h_label->text_font, h_label->text, strlen(h_label->text)) + 5, h_label->height); /* Fill in label background. */
+         i_colour = h_label->background;
+         v_render_fill(h_display, x_application_window, i_colour, (i_indent - 3), h_label->top , XTextWidth(h_label->text_font, h_label->text, strlen(h_label->text)) + 5, h_label->height); /* Fill in label background. */
 
-         XSetForeground(h_display, DefaultGC(h_display, i_screen), h_label->colour); /* Set the background colour. */
-         XDrawString(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent, i_upper, h_label->text, strlen(h_label->text)); /* Draw the text. */
+         i_colour = h_label->colour; /* Set the background colour. */
+         v_render_text(h_display, x_application_window, i_colour, h_font, i_indent, i_upper, h_label->text, strlen(h_label->text)); /* Draw the text. */
+         v_render_flush(h_display);
       }
    }
    return(True);
@@ -42,6 +42,21 @@
  *                     unix like systems - MT
  * 18 Jan 23         - Shortened help message (max string length for C90 is
  *                     509 characters) - MT
+ * 17 Oct 26         - Added '--shm' to help text - MT
+ *                   - Moved  the long options into a separate message  to
+ *                     keep both strings under the C90 limit - MT
+ *                   - Added '-o' to help text - MT
+ *                   - Added '--refresh' to help text - MT
+ *                   - Added '--scale' to help text - MT
+ *                   - Added '--verbose' to help text and start up timing
+ *                     message - MT
+ *                   - Added '-m' to help text - MT
+ *                   - Added  help text and error messages for HP67 cards
+ *                     - MT
+ *                   - Added an error message for option values that are
+ *                     out of range - MT
+ *                   - Added '--turbo' to help text, and an error message
+ *                     for when there is no room for a new card - MT
  *
  */
 
@@ -73,6 +88,7 @@ const char * h_msg_rom = "%o:%o";
 #if defined(LANG_es)
 const char * h_msg_loading = "Cargando '%s'.\n";
 const char * h_msg_saving = "Guardando '%s'.\n";
+const char * h_msg_startup = "Arranque : %-10s %4ld ms\n";
 
 const char * h_err_register_alloc = "Error de ejecucion\t: %s linea: %d: iFallo la asignacion de memoria!\n";
 const char * h_err_opening_file = "No se puede abrir '%s'.\n";
@@ -99,20 +115,34 @@ const char * c_msg_usage = "Uso: %s [OPCION]... [ARCHIVO]\n\
 Simularor de calculadora RPN para X11.\n\n\
   -b  ADDR                 punto de interrupcion (octal)\n\
   -i  OPCODE               instruccion de trampa (octal)\n\
+  -m  FILE                 mantener la memoria continua en FILE\n\
+  -o  FILE                 guardar una imagen (PPM) en FILE y salir\n\
   -r  FILE                 leer el contenido de la ROM de FILE\n\
   -s,                      un paso\n\
-  -t,                      seguimiento de la ejecucion\n\
+  -t,                      seguimiento de la ejecucion\n";
+const char * h_msg_options = "\
       --cursor             mostrar cursor (default)\n\
       --no-cursor          ocultar cursor\n\
+      --scale=N            escala de la interfaz (0.5 - 8)\n\
+      --shm                usar memoria compartida (MIT-SHM)\n\
+      --refresh=HZ         frecuencia de refresco de la pantalla (60)\n\
+      --verbose            mostrar el tiempo de arranque\n\
       --help               mostrar esta ayuda y salir\n\
       --version            mostrar version y salir\n\n";
+const char * h_msg_card_options = "\
+  -c  DIR                  leer y escribir tarjetas en DIR\n\
+      --turbo              copiar las tarjetas directamente a la memoria\n";
 const char * h_err_invalid_operand = "operando(s) inválido\n";
 const char * h_err_invalid_option = "opcion invalida -- '%c'\n";
 const char * h_err_unrecognised_option = "opcion no reconocida '%s'\n";
 const char * h_err_invalid_number = "no es un numero octal -- '%s' \n";
 const char * h_err_address_range = "fuera del rango  -- '%s' \n";
+const char * h_err_option_range = "valor fuera del rango -- '%s' \n";
 const char * h_err_missing_argument = "opcion requiere un argumento -- '%s'\n";
 const char * h_err_invalid_argument = "argumento esperado no es -- '%c' \n";
+const char * h_err_memory_file = "archivo de memoria no valido -- '%s'\n";
+const char * h_err_cards_full = "no hay espacio para otra tarjeta en '%s'\n";
+const char * h_err_no_cards = "no hay tarjetas en '%s'\n";
 #else
 const char * c_msg_usage = "Uso: %s [OPCION]... [ARCHIVO]\n\
 Una simulación de calculadora RPN para X11.\n\n\
@@ -131,6 +161,7 @@ const char * h_err_invalid_option = "opcion invalida %s\n";
 #elif defined(LANG_de)
 const char * h_msg_loading = "Lade '%s'.\n";
 const char * h_msg_saving = "Speichere '%s'.\n";
+const char * h_msg_startup = "Start : %-10s %4ld ms\n";
 
 const char * h_err_register_alloc = "Laufzeitfehler\t: %s Zeile : %d : Speicheranforderung fehlgeschlagen!\n";
 const char * h_err_opening_file = "Kann '%s' nicht oeffnen.\n";
@@ -157,20 +188,34 @@ const char * c_msg_usage = "Verwendung: %s [OPTION]... [DATEI]\n\
 Eine RPN rechner-simulation fuer X11.\n\n\
   -b  ADDR                 haltepunkt an adresse setzen (oktal)\n\
   -i, OPCODE               haltepunkt auf Opcode setzen  (oktal)\n\
+  -m  FILE                 dauerspeicher in FILE halten\n\
+  -o  FILE                 ein bild (PPM) in FILE speichern und beenden\n\
   -r  FILE                 lesen sie den ROM inhalt von FILE\n\
   -s,                      einzelschritt\n\
-  -t,                      ausfuehrung protokollieren\n\
+  -t,                      ausfuehrung protokollieren\n";
+const char * h_msg_options = "\
       --cursor             cursor anzeigen (default)\n\
       --no-cursor          cursor verbergen\n\
+      --scale=N            skalierung der oberflaeche (0.5 - 8)\n\
+      --shm                gemeinsamen Speicher nutzen (MIT-SHM)\n\
+      --refresh=HZ         bildwiederholrate der anzeige (60)\n\
+      --verbose            startzeiten anzeigen\n\
       --help               diese hilfe anzeigen und dann beenden\n\
       --version            versionsinformationen ausgeben und dann beenden\n\n";
+const char * h_msg_card_options = "\
+  -c  DIR                  karten in DIR lesen und schreiben\n\
+      --turbo              karten direkt in den speicher kopieren\n";
 const char * h_err_invalid_operand = "ungueltige(r) operand(en)\n";
 const char * h_err_invalid_option = "ungueltige option -- '%c'\n";
 const char * h_err_unrecognised_option = "unbekannte option '%s'\n";
 const char * h_err_invalid_number = "keine gueltige oktalzahl -- '%s' \n";
 const char * h_err_address_range = "ausserhalb des adressbereichs -- '%s' \n";
+const char * h_err_option_range = "wert ausserhalb des bereichs -- '%s' \n";
 const char * h_err_missing_argument = "option benoetigt ein argument -- '%s'\n";
 const char * h_err_invalid_argument = "argument erwartet, nicht -- '%c' \n";
+const char * h_err_memory_file = "ungueltige speicherdatei -- '%s'\n";
+const char * h_err_cards_full = "kein platz fuer eine neue karte in '%s'\n";
+const char * h_err_no_cards = "keine karten in '%s'\n";
 #else
 const char * c_msg_usage = "Verwendung: %s [OPTION...] [DATEI]\n\
 Eine RPN rechner simulation fur X11.\n\n\
@@ -189,6 +234,7 @@ const char * h_err_invalid_option = "ungueltige option %s\n";
 #elif defined(LANG_fr)
 const char * h_msg_loading = "Chargement de '%s'.\n";
 const char * h_msg_saving = "Enregistrement de '%s'.\n";
+const char * h_msg_startup = "Demarrage : %-10s %4ld ms\n";
 
 const char * h_err_register_alloc = "Erreur d'execution\t : Ligne %s : %d : Echec de l'allocation de memoire !\n";
 const char * h_err_opening_file = "Impossible d'ouvrir '%s'.\n";
@@ -215,20 +261,34 @@ const char * c_msg_usage = "Utilisation : %s [OPTION]... [FICHIER]\n\
 Une simulation RPN Calculator pour X11.\n\n\
   -b  ADDR                 définir un point d'arrêt (octal)\n\
   -i, OPCODE               définir un piège d'instruction (octal)\n\
+  -m  FILE                 garder la memoire continue dans FILE\n\
+  -o  FILE                 enregistrer une image (PPM) dans FILE et quitter\n\
   -r  FILE                 lire le contenu de la ROM de FILE\n\
   -s,                      single step\n\
-  -t,                      trace execution\n\
+  -t,                      trace execution\n";
+const char * h_msg_options = "\
       --cursor             curseur d'affichage (par défaut)\n\
       --no-cursor          masquer le curseur\n\
+      --scale=N            echelle de l'interface (0.5 - 8)\n\
+      --shm                utiliser la memoire partagee (MIT-SHM)\n\
+      --refresh=HZ         frequence de rafraichissement (60)\n\
+      --verbose            afficher le temps de demarrage\n\
       --help               afficher cette aide et quitter\n\
       --version            affiche les informations de version et quitte\n\n";
+const char * h_msg_card_options = "\
+  -c  DIR                  lire et ecrire les cartes dans DIR\n\
+      --turbo              copier les cartes directement en memoire\n";
 const char * h_err_invalid_operand = "opérande(s) invalide(s)\n";
 const char * h_err_invalid_option = "option invalide -- '%c'\n";
 const char * h_err_unrecognised_option = "option non reconnue '%s'\n";
 const char * h_err_invalid_number = "pas un nombre octal -- '%s' \n";
 const char * h_err_address_range = "hors de portée -- '%s' \n";
+const char * h_err_option_range = "valeur hors limites -- '%s' \n";
 const char * h_err_missing_argument = "l'option necessite un argument -- '%s'\n";
 const char * h_err_invalid_argument = "argument attendu -- '%c' \n";
+const char * h_err_memory_file = "fichier de memoire invalide -- '%s'\n";
+const char * h_err_cards_full = "plus de place pour une nouvelle carte dans '%s'\n";
+const char * h_err_no_cards = "aucune carte dans '%s'\n";
 #else
 const char * c_msg_usage = "Utilisation : %s [OPTION]... [FICHIER]\n\
 Une simulation RPN Calculator pour X11.\n\n\
@@ -248,6 +308,7 @@ const char * h_err_invalid_option = "option invalide %s\n";
 
 const char * h_msg_loading = "Loading '%s'.\n";
 const char * h_msg_saving = "Saving '%s'.\n";
+const char * h_msg_startup = "Startup : %-10s %4ld ms\n";
 
 const char * h_err_register_alloc = "Run-time error\t: %s line : %d : Memory allocation failed!\n";
 const char * h_err_opening_file = "Unable to open '%s'.\n";
@@ -274,20 +335,34 @@ const char * c_msg_usage = "Usage: %s [OPTION]... [FILE]\n\
 An RPN Calculator simulation for X11.\n\n\
   -b  ADDR                 set break-point (octal)\n\
   -i, OPCODE               set instruction trap (octal)\n\
+  -m  FILE                 keep continuous memory in FILE\n\
+  -o  FILE                 save a picture (PPM) to FILE and exit\n\
   -r  FILE                 read ROM from FILE\n\
   -s,                      single step\n\
-  -t,                      trace\n\
+  -t,                      trace\n";
+const char * h_msg_options = "\
       --cursor             display cursor\n\
       --no-cursor          hide cursor\n\
+      --scale=N            scale the user interface (0.5 - 8)\n\
+      --shm                draw using shared memory (MIT-SHM)\n\
+      --refresh=HZ         display refresh rate (default 60)\n\
+      --verbose            show start up timing\n\
       --help               display this help and exit\n\
       --version            output version information and exit\n\n";
+const char * h_msg_card_options = "\
+  -c  DIR                  read and write cards in DIR\n\
+      --turbo              copy cards straight into memory\n";
 const char * h_err_invalid_operand = "invalid operand(s)\n";
 const char * h_err_invalid_option = "invalid option -- '%c'\n";
 const char * h_err_unrecognised_option = "unrecognised option '%s'\n";
 const char * h_err_invalid_number = "not an octal number -- '%s' \n";
 const char * h_err_address_range = "out of range -- '%s' \n";
+const char * h_err_option_range = "value out of range -- '%s' \n";
 const char * h_err_missing_argument = "option requires an argument -- '%s'\n";
 const char * h_err_invalid_argument = "expected argument not -- '%c' \n";
+const char * h_err_memory_file = "invalid memory file -- '%s'\n";
+const char * h_err_cards_full = "no room for a new card in '%s'\n";
+const char * h_err_no_cards = "no cards in '%s'\n";
 #else
 const char * c_msg_usage = "Usage: %s [OPTION...] [FILE]\n\
 An RPN Calculator simulation for X11.\n\n\
@@ -24,11 +24,22 @@
  * 24 Dec 22         - Added and explicit check for '__APPLE__' in order to
  *                     allow Mac OS  to be handled in the same way as other
  *                     unix like systems - MT
+ * 17 Oct 26         - Added help text for long options - MT
+ *                   - Added start up timing message - MT
+ *                   - Added an error message for an invalid memory file -
+ *                     MT
+ *                   - Added help text and error messages for HP67 cards
+ *                     - MT
+ *                   - Added an error message for option values that are
+ *                     out of range - MT
+ *                   - Added an error message for when there is no room
+ *                     for a new card - MT
  *
  */
 
 extern char * h_msg_loading;
 extern char * h_msg_saving;
+extern char * h_msg_startup;
 
 extern char * h_err_register_alloc;
 extern char * h_err_opening_file;
@@ -47,11 +58,17 @@ extern char * c_msg_usage;
 extern char * h_err_invalid_operand;
 extern char * h_err_invalid_option;
 #if defined(unix) || defined(__unix__) || defined(__APPLE__)
+extern char * h_msg_options;
+extern char * h_msg_card_options;
 extern char * h_err_unrecognised_option;
 extern char * h_err_invalid_number;
 extern char * h_err_address_range;
+extern char * h_err_option_range;
 extern char * h_err_missing_argument;
 extern char * h_err_invalid_argument;
+extern char * h_err_memory_file;
+extern char * h_err_cards_full;
+extern char * h_err_no_cards;
 #endif
 
 extern char * h_msg_licence;
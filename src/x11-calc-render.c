@@ -0,0 +1,822 @@
+/*
+ * x11-calc-render.c - RPN (Reverse Polish) calculator simulator.
+ *
+ * Copyright(C) 2026   MT
+ *
+ * Drawing primitives.
+ *
+ * Implements the routines used to draw lines, rectangles and text in a given
+ * colour.
+ *
+ * Instead of changing the foreground colour of the default graphics context
+ * every  time  a different colour is needed a separate  graphics  context is
+ * created  for  each colour the first time it is used.   Lines  and  filled
+ * rectangles are not drawn immediately but are added to a batch, which is
+ * only sent to the X server (using a single request for each type of shape)
+ * when the colour changes, when some text is drawn, or when it is flushed.
+ *
+ * Since  the shapes in a batch are all the same colour the order in  which
+ * they are drawn doesn't matter.
+ *
+ * When  the  MIT shared memory extension is available the window  can  be
+ * drawn using a frame buffer held in shared memory instead.   In this case
+ * off-screen  images are also held in memory and everything is drawn  by
+ * the program itself, and only the area of the frame buffer that has been
+ * changed is sent to the X server when the frame buffer is synchronised.
+ *
+ * The same client side images can also be used without an X server at all
+ * (using the built in bitmap fonts) to save a picture of the calculator.
+ *
+ * This  program is free software: you can redistribute it and/or modify it
+ * under  the terms of the GNU General Public License as published  by  the
+ * Free  Software Foundation, either version 3 of the License, or (at  your
+ * option) any later version.
+ *
+ * This  program  is distributed in the hope that it will  be  useful,  but
+ * WITHOUT   ANY   WARRANTY;   without even   the   implied   warranty   of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You  should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * 17 Oct 26         - Initial version - MT
+ *                   - Added  client side images and an optional  frame
+ *                     buffer using the MIT shared memory extension - MT
+ *                   - Client  side images can be created without  an  X
+ *                     server and saved as a PPM file - MT
+ *                   - Added render_flush_fonts() to discard the glyphs of
+ *                     fonts that have been freed - MT
+ *
+ */
+
+#define VERSION        "0.1"
+#define BUILD          "0001"
+#define DATE           "17 Oct 26"
+#define AUTHOR         "MT"
+
+#include <stdio.h>     /* fprintf(), etc. */
+#include <stdlib.h>    /* malloc(), etc. */
+#include <string.h>    /* strcmp(), etc. */
+
+#include <X11/Xlib.h>  /* XOpenDisplay(), etc. */
+#include <X11/Xutil.h> /* XSizeHints etc. */
+
+#if defined(MITSHM)
+#include <sys/ipc.h>   /* IPC_PRIVATE, etc. */
+#include <sys/shm.h>   /* shmget(), etc. */
+#include <X11/extensions/XShm.h> /* XShmPutImage(), etc. */
+#endif
+
+#include "x11-calc-font.h"
+#include "x11-calc-label.h"
+#include "x11-calc-switch.h"
+#include "x11-calc-button.h"
+#include "x11-calc-render.h"
+#include "x11-calc-bitmap.h"
+
+#include "x11-calc.h"
+
+#include "gcc-debug.h"
+
+static unsigned int i_palette[RENDER_COLOURS]; /* Colour used by each graphics context */
+static GC x_palette[RENDER_COLOURS]; /* Graphics context for each colour */
+static Font x_palette_font[RENDER_COLOURS]; /* Font selected in each graphics context */
+static int i_palette_size = 0;
+
+static Drawable x_batch_drawable = None; /* Where the current batch will be drawn */
+static int i_batch_colour = -1; /* Colour of the current batch (palette index) */
+static XSegment x_batch_lines[RENDER_BATCH];
+static XRectangle x_batch_rectangles[RENDER_BATCH];
+static XRectangle x_batch_fills[RENDER_BATCH];
+static int i_batch_lines = 0;
+static int i_batch_rectangles = 0;
+static int i_batch_fills = 0;
+
+typedef struct { /* Client side image */
+   int width;
+   int height;
+   int stride; /* Pixels per row */
+   unsigned int *pixel;
+} oimage;
+
+typedef struct { /* Client side copy of the glyphs in a font */
+   Font fid;
+   int origin; /* Horizontal offset of the origin of each glyph */
+   int ascent;
+   int width; /* Size of each glyph */
+   int height;
+   unsigned char *mask; /* Glyphs arranged in 16 rows of 16 */
+} oglyphs;
+
+static oimage **h_surface = NULL; /* Client side images */
+static int i_surfaces = 0;
+
+static oglyphs h_glyphs[RENDER_FONTS];
+static int i_fonts = 0;
+static int i_next_font = 0; /* Next font to be discarded when they are all in use */
+
+static oimage h_frame; /* Frame buffer */
+static Window x_frame_window = None; /* Window drawn using the frame buffer */
+static int i_frame_left = 0, i_frame_top = 0, i_frame_right = 0, i_frame_bottom = 0; /* Area that has changed */
+#if defined(MITSHM)
+static XImage *h_frame_image = NULL;
+static XShmSegmentInfo x_frame_segment;
+static int b_frame_error;
+#endif
+
+/*
+ * render_colour (display, drawable, colour)
+ *
+ * Returns  the index of the graphics context for the given colour, creating
+ * a new one if this is the first time the colour has been used (or reusing
+ * an existing one if there are no more free slots).
+ *
+ */
+
+static int i_render_colour(Display *h_display, Drawable x_drawable, unsigned int i_colour){
+
+   XGCValues x_values;
+   static int i_next = 0;
+   int i_count;
+
+   for (i_count = 0; i_count < i_palette_size; i_count++)
+      if (i_palette[i_count] == i_colour) return(i_count);
+
+   if (i_palette_size < RENDER_COLOURS)
+   {
+      x_values.foreground = i_colour;
+      x_values.graphics_exposures = False;
+      x_palette[i_palette_size] = XCreateGC(h_display, x_drawable, GCForeground | GCGraphicsExposures, &x_values);
+      x_palette_font[i_palette_size] = None;
+      i_palette[i_palette_size] = i_colour;
+      return(i_palette_size++);
+   }
+
+   i_count = i_next; /* All graphics contexts in use so change the colour of one */
+   i_next = (i_next + 1) % RENDER_COLOURS;
+   XSetForeground(h_display, x_palette[i_count], i_colour);
+   i_palette[i_count] = i_colour;
+   return(i_count);
+}
+
+/*
+ * render_image (drawable)
+ *
+ * Returns  the client side image for a drawable, or NULL if the drawable is
+ * held by the X server.
+ *
+ */
+
+static oimage *h_render_image(Drawable x_drawable){
+
+   if (x_drawable & RENDER_IMAGE)
+   {
+      if ((x_drawable & ~RENDER_IMAGE) < i_surfaces) return(h_surface[x_drawable & ~RENDER_IMAGE]);
+   }
+   else if ((x_frame_window != None) && (x_drawable == x_frame_window))
+      return(&h_frame);
+   return(NULL);
+}
+
+/*
+ * frame_damage (left, top, right, bottom)
+ *
+ * Adds an area to the part of the frame buffer that has been changed.
+ *
+ */
+
+static void v_frame_damage(int i_left, int i_top, int i_right, int i_bottom){
+
+   if (i_frame_right <= i_frame_left)
+   {
+      i_frame_left = i_left; i_frame_top = i_top;
+      i_frame_right = i_right; i_frame_bottom = i_bottom;
+   }
+   else
+   {
+      if (i_left < i_frame_left) i_frame_left = i_left;
+      if (i_top < i_frame_top) i_frame_top = i_top;
+      if (i_right > i_frame_right) i_frame_right = i_right;
+      if (i_bottom > i_frame_bottom) i_frame_bottom = i_bottom;
+   }
+}
+
+/*
+ * image_fill (image, colour, left, top, width, height)
+ *
+ * Fills a rectangle in a client side image, keeping track of the area that
+ * has changed if the image is the frame buffer.
+ *
+ */
+
+static void v_image_fill(oimage *h_image, unsigned int i_colour, int i_left, int i_top, int i_width, int i_height){
+
+   unsigned int *h_pixel;
+   int i_right, i_bottom, i_x, i_y;
+
+   i_right = i_left + i_width;
+   i_bottom = i_top + i_height;
+   if (i_left < 0) i_left = 0;
+   if (i_top < 0) i_top = 0;
+   if (i_right > h_image->width) i_right = h_image->width;
+   if (i_bottom > h_image->height) i_bottom = h_image->height;
+   if ((i_right <= i_left) || (i_bottom <= i_top)) return;
+
+   for (i_y = i_top; i_y < i_bottom; i_y++)
+   {
+      h_pixel = h_image->pixel + i_y * h_image->stride;
+      for (i_x = i_left; i_x < i_right; i_x++) h_pixel[i_x] = i_colour;
+   }
+
+   if (h_image == &h_frame) v_frame_damage(i_left, i_top, i_right, i_bottom);
+}
+
+/*
+ * image_line (image, colour, x1, y1, x2, y2)
+ *
+ * Draws a line including both end points (like a zero width line drawn by
+ * the X server).
+ *
+ */
+
+static void v_image_line(oimage *h_image, unsigned int i_colour, int i_x1, int i_y1, int i_x2, int i_y2){
+
+   int i_dx, i_dy, i_sx, i_sy, i_error, i_twice;
+
+   if ((i_x1 == i_x2) || (i_y1 == i_y2)) /* Horizontal and vertical lines are just thin rectangles */
+   {
+      v_image_fill(h_image, i_colour, (i_x1 < i_x2) ? i_x1 : i_x2, (i_y1 < i_y2) ? i_y1 : i_y2,
+         abs(i_x2 - i_x1) + 1, abs(i_y2 - i_y1) + 1);
+      return;
+   }
+
+   i_dx = abs(i_x2 - i_x1); i_sx = (i_x1 < i_x2) ? 1 : -1;
+   i_dy = -abs(i_y2 - i_y1); i_sy = (i_y1 < i_y2) ? 1 : -1;
+   i_error = i_dx + i_dy;
+   for (;;)
+   {
+      v_image_fill(h_image, i_colour, i_x1, i_y1, 1, 1);
+      if ((i_x1 == i_x2) && (i_y1 == i_y2)) break;
+      i_twice = 2 * i_error;
+      if (i_twice >= i_dy) { i_error += i_dy; i_x1 += i_sx; }
+      if (i_twice <= i_dx) { i_error += i_dx; i_y1 += i_sy; }
+   }
+}
+
+/*
+ * render_flush_fonts (display)
+ *
+ * Discards the glyphs copied from every font.  Must be called when fonts
+ * are freed, as the X server may reuse their ids for different fonts.
+ *
+ */
+
+void v_render_flush_fonts(Display *h_display){
+
+   int i_count;
+
+   for (i_count = 0; i_count < i_fonts; i_count++)
+      free(h_glyphs[i_count].mask);
+   i_fonts = 0;
+   i_next_font = 0;
+}
+
+/*
+ * render_glyphs (display, font)
+ *
+ * Returns  a client side copy of the glyphs in a font.   The first time  a
+ * font is used all the glyphs are drawn by the X server in a pixmap which
+ * is then copied back from the server, so they look exactly the same as
+ * any text drawn by the server.  Built in fonts are copied from the bitmap
+ * instead.
+ *
+ */
+
+static oglyphs *h_render_glyphs(Display *h_display, XFontStruct *h_font){
+
+   oglyphs *h_glyph;
+   XImage *h_sheet;
+   Pixmap x_pixmap;
+   GC x_gc;
+   char c_char;
+   int i_count, i_x, i_y, i_width, i_height;
+
+   for (i_count = 0; i_count < i_fonts; i_count++)
+      if (h_glyphs[i_count].fid == h_font->fid) return(&h_glyphs[i_count]);
+
+   if (i_fonts < RENDER_FONTS)
+      h_glyph = &h_glyphs[i_fonts++];
+   else
+   {
+      h_glyph = &h_glyphs[i_next_font]; /* Discard the least recently loaded font */
+      i_next_font = (i_next_font + 1) % RENDER_FONTS;
+      free(h_glyph->mask);
+   }
+
+   h_glyph->fid = h_font->fid;
+   h_glyph->origin = (h_font->min_bounds.lbearing < 0) ? -h_font->min_bounds.lbearing : 0;
+   h_glyph->ascent = h_font->max_bounds.ascent;
+   h_glyph->width = h_glyph->origin + h_font->max_bounds.rbearing;
+   h_glyph->height = h_font->max_bounds.ascent + h_font->max_bounds.descent;
+   if (h_glyph->width < 1) h_glyph->width = 1;
+   if (h_glyph->height < 1) h_glyph->height = 1;
+   i_width = h_glyph->width * 16;
+   i_height = h_glyph->height * 16;
+   if ((h_glyph->mask = malloc(i_width * i_height)) == NULL) v_error("Memory allocation failed!");
+
+   if (h_font->fid & RENDER_IMAGE) /* Built in font */
+   {
+      const obitmap *h_source = &h_bitmap[h_font->fid & ~RENDER_IMAGE];
+      for (i_count = 0; i_count < i_width * i_height; i_count++) h_glyph->mask[i_count] = 0;
+      for (i_count = BITMAP_FIRST; i_count <= BITMAP_LAST; i_count++)
+         for (i_y = 0; i_y < h_glyph->height; i_y++)
+            for (i_x = 0; i_x < h_glyph->width; i_x++)
+               h_glyph->mask[((i_count / 16) * h_glyph->height + i_y) * i_width + (i_count % 16) * h_glyph->width + i_x] =
+                  (h_source->bitmap[(i_count - BITMAP_FIRST) * h_glyph->height + i_y] & (0x80 >> i_x)) != 0;
+      return(h_glyph);
+   }
+
+   x_pixmap = XCreatePixmap(h_display, DefaultRootWindow(h_display), i_width, i_height,
+      DefaultDepth(h_display, DefaultScreen(h_display)));
+   x_gc = XCreateGC(h_display, x_pixmap, 0, NULL);
+   XSetForeground(h_display, x_gc, BlackPixel(h_display, DefaultScreen(h_display)));
+   XFillRectangle(h_display, x_pixmap, x_gc, 0, 0, i_width, i_height);
+   XSetForeground(h_display, x_gc, WhitePixel(h_display, DefaultScreen(h_display)));
+   XSetFont(h_display, x_gc, h_font->fid);
+   for (i_count = 1; i_count < 256; i_count++)
+   {
+      c_char = i_count;
+      XDrawString(h_display, x_pixmap, x_gc, (i_count % 16) * h_glyph->width + h_glyph->origin,
+         (i_count / 16) * h_glyph->height + h_glyph->ascent, &c_char, 1);
+   }
+   h_sheet = XGetImage(h_display, x_pixmap, 0, 0, i_width, i_height, AllPlanes, ZPixmap);
+   for (i_y = 0; i_y < i_height; i_y++)
+      for (i_x = 0; i_x < i_width; i_x++)
+         h_glyph->mask[i_y * i_width + i_x] = (h_sheet != NULL) &&
+            (XGetPixel(h_sheet, i_x, i_y) != BlackPixel(h_display, DefaultScreen(h_display)));
+   if (h_sheet != NULL) XDestroyImage(h_sheet);
+   XFreeGC(h_display, x_gc);
+   XFreePixmap(h_display, x_pixmap);
+   return(h_glyph);
+}
+
+/*
+ * image_text (display, image, colour, font, left, top, text, length)
+ *
+ * Draws text in a client side image one glyph at a time.
+ *
+ */
+
+static void v_image_text(Display *h_display, oimage *h_image, unsigned int i_colour,
+   XFontStruct *h_font, int i_left, int i_top, char *s_text, int i_length){
+
+   oglyphs *h_glyph;
+   unsigned char *h_mask;
+   int i_count, i_char, i_x, i_y;
+
+   h_glyph = h_render_glyphs(h_display, h_font);
+   for (i_count = 0; i_count < i_length; i_count++)
+   {
+      i_char = (unsigned char) s_text[i_count];
+      for (i_y = 0; i_y < h_glyph->height; i_y++)
+      {
+         h_mask = h_glyph->mask + ((i_char / 16) * h_glyph->height + i_y) * h_glyph->width * 16 + (i_char % 16) * h_glyph->width;
+         for (i_x = 0; i_x < h_glyph->width; i_x++)
+            if (h_mask[i_x])
+               v_image_fill(h_image, i_colour, i_left - h_glyph->origin + i_x, i_top - h_glyph->ascent + i_y, 1, 1);
+      }
+      i_left += XTextWidth(h_font, &s_text[i_count], 1);
+   }
+}
+
+/*
+ * render_flush (display)
+ *
+ * Draws any lines and rectangles in the current batch.
+ *
+ */
+
+void v_render_flush(Display *h_display){
+
+   if (i_batch_colour >= 0)
+   {
+      if (i_batch_fills > 0)
+         XFillRectangles(h_display, x_batch_drawable, x_palette[i_batch_colour], x_batch_fills, i_batch_fills);
+      if (i_batch_rectangles > 0)
+         XDrawRectangles(h_display, x_batch_drawable, x_palette[i_batch_colour], x_batch_rectangles, i_batch_rectangles);
+      if (i_batch_lines > 0)
+         XDrawSegments(h_display, x_batch_drawable, x_palette[i_batch_colour], x_batch_lines, i_batch_lines);
+   }
+   i_batch_fills = i_batch_rectangles = i_batch_lines = 0;
+   i_batch_colour = -1;
+   x_batch_drawable = None;
+}
+
+/*
+ * render_batch (display, drawable, colour)
+ *
+ * Starts a new batch if the colour or drawable has changed.
+ *
+ */
+
+static void v_render_batch(Display *h_display, Drawable x_drawable, unsigned int i_colour){
+
+   if ((i_batch_colour < 0) || (x_drawable != x_batch_drawable) || (i_palette[i_batch_colour] != i_colour))
+   {
+      v_render_flush(h_display);
+      i_batch_colour = i_render_colour(h_display, x_drawable, i_colour);
+      x_batch_drawable = x_drawable;
+   }
+}
+
+/* render_line (display, drawable, colour, x1, y1, x2, y2) */
+
+void v_render_line(Display *h_display, Drawable x_drawable, unsigned int i_colour,
+   int i_x1, int i_y1, int i_x2, int i_y2){
+
+   oimage *h_target;
+
+   if ((h_target = h_render_image(x_drawable)) != NULL)
+   {
+      v_image_line(h_target, i_colour, i_x1, i_y1, i_x2, i_y2);
+      return;
+   }
+   v_render_batch(h_display, x_drawable, i_colour);
+   if (i_batch_lines >= RENDER_BATCH)
+   {
+      v_render_flush(h_display);
+      v_render_batch(h_display, x_drawable, i_colour);
+   }
+   x_batch_lines[i_batch_lines].x1 = i_x1;
+   x_batch_lines[i_batch_lines].y1 = i_y1;
+   x_batch_lines[i_batch_lines].x2 = i_x2;
+   x_batch_lines[i_batch_lines].y2 = i_y2;
+   i_batch_lines++;
+}
+
+/* render_rectangle (display, drawable, colour, left, top, width, height) */
+
+void v_render_rectangle(Display *h_display, Drawable x_drawable, unsigned int i_colour,
+   int i_left, int i_top, int i_width, int i_height){
+
+   oimage *h_target;
+
+   if ((h_target = h_render_image(x_drawable)) != NULL) /* The outline is one pixel larger than the rectangle */
+   {
+      v_image_fill(h_target, i_colour, i_left, i_top, i_width + 1, 1);
+      v_image_fill(h_target, i_colour, i_left, i_top + i_height, i_width + 1, 1);
+      v_image_fill(h_target, i_colour, i_left, i_top, 1, i_height + 1);
+      v_image_fill(h_target, i_colour, i_left + i_width, i_top, 1, i_height + 1);
+      return;
+   }
+   v_render_batch(h_display, x_drawable, i_colour);
+   if (i_batch_rectangles >= RENDER_BATCH)
+   {
+      v_render_flush(h_display);
+      v_render_batch(h_display, x_drawable, i_colour);
+   }
+   x_batch_rectangles[i_batch_rectangles].x = i_left;
+   x_batch_rectangles[i_batch_rectangles].y = i_top;
+   x_batch_rectangles[i_batch_rectangles].width = i_width;
+   x_batch_rectangles[i_batch_rectangles].height = i_height;
+   i_batch_rectangles++;
+}
+
+/* render_fill (display, drawable, colour, left, top, width, height) */
+
+void v_render_fill(Display *h_display, Drawable x_drawable, unsigned int i_colour,
+   int i_left, int i_top, int i_width, int i_height){
+
+   oimage *h_target;
+
+   if ((i_width <= 0) || (i_height <= 0)) return;
+   if ((h_target = h_render_image(x_drawable)) != NULL)
+   {
+      v_image_fill(h_target, i_colour, i_left, i_top, i_width, i_height);
+      return;
+   }
+   v_render_batch(h_display, x_drawable, i_colour);
+   if (i_batch_fills >= RENDER_BATCH)
+   {
+      v_render_flush(h_display);
+      v_render_batch(h_display, x_drawable, i_colour);
+   }
+   x_batch_fills[i_batch_fills].x = i_left;
+   x_batch_fills[i_batch_fills].y = i_top;
+   x_batch_fills[i_batch_fills].width = i_width;
+   x_batch_fills[i_batch_fills].height = i_height;
+   i_batch_fills++;
+}
+
+/*
+ * render_text (display, drawable, colour, font, left, top, text, length)
+ *
+ * Draws  any shapes in the current batch, then draws the text  using  the
+ * graphics context for the given colour.
+ *
+ */
+
+void v_render_text(Display *h_display, Drawable x_drawable, unsigned int i_colour,
+   XFontStruct *h_font, int i_left, int i_top, char *s_text, int i_length){
+
+   oimage *h_target;
+   int i_index;
+
+   if ((h_target = h_render_image(x_drawable)) != NULL)
+   {
+      v_image_text(h_display, h_target, i_colour, h_font, i_left, i_top, s_text, i_length);
+      return;
+   }
+   v_render_flush(h_display);
+   i_index = i_render_colour(h_display, x_drawable, i_colour);
+   if (x_palette_font[i_index] != h_font->fid)
+   {
+      XSetFont(h_display, x_palette[i_index], h_font->fid);
+      x_palette_font[i_index] = h_font->fid;
+   }
+   XDrawString(h_display, x_drawable, x_palette[i_index], i_left, i_top, s_text, i_length);
+}
+
+/*
+ * render_create (display, parent, width, height)
+ *
+ * Creates an off-screen drawable.   If the parent is drawn by the  program
+ * (or there is no display) this will be a client side image, otherwise it
+ * will be a pixmap.
+ *
+ */
+
+Drawable x_render_create(Display *h_display, Drawable x_parent, int i_width, int i_height){
+
+   oimage *h_new;
+   int i_index;
+
+   if ((h_display != NULL) && (h_render_image(x_parent) == NULL))
+      return(XCreatePixmap(h_display, x_parent, i_width, i_height, DefaultDepth(h_display, DefaultScreen(h_display))));
+
+   for (i_index = 0; i_index < i_surfaces; i_index++) /* Look for a free slot */
+      if (h_surface[i_index] == NULL) break;
+   if (i_index >= i_surfaces)
+   {
+      if ((h_surface = realloc(h_surface, (i_surfaces + 1) * sizeof(*h_surface))) == NULL) v_error("Memory allocation failed!");
+      i_index = i_surfaces++;
+   }
+   if ((h_new = malloc(sizeof(*h_new))) == NULL) v_error("Memory allocation failed!");
+   if ((h_new->pixel = malloc(i_width * i_height * sizeof(*h_new->pixel))) == NULL) v_error("Memory allocation failed!");
+   h_new->width = h_new->stride = i_width;
+   h_new->height = i_height;
+   h_surface[i_index] = h_new;
+   return(RENDER_IMAGE | i_index);
+}
+
+/* render_free (display, drawable) */
+
+void v_render_free(Display *h_display, Drawable x_drawable){
+
+   oimage *h_target;
+
+   if (x_drawable & RENDER_IMAGE)
+   {
+      if ((h_target = h_render_image(x_drawable)) != NULL)
+      {
+         free(h_target->pixel);
+         free(h_target);
+         h_surface[x_drawable & ~RENDER_IMAGE] = NULL;
+      }
+   }
+   else
+   {
+      v_render_flush(h_display); /* Don't leave anything in the batch that refers to the pixmap */
+      XFreePixmap(h_display, x_drawable);
+   }
+}
+
+/*
+ * render_copy (display, source, target, left, top, width, height, x, y)
+ *
+ * Copies an area from one drawable to another.
+ *
+ */
+
+void v_render_copy(Display *h_display, Drawable x_source, Drawable x_target,
+   int i_left, int i_top, int i_width, int i_height, int i_x, int i_y){
+
+   oimage *h_source, *h_target;
+   unsigned int *h_from, *h_to;
+   int i_count, i_row;
+
+   h_source = h_render_image(x_source);
+   h_target = h_render_image(x_target);
+   if ((h_source == NULL) || (h_target == NULL))
+   {
+      v_render_flush(h_display);
+      XCopyArea(h_display, x_source, x_target, DefaultGC(h_display, DefaultScreen(h_display)),
+         i_left, i_top, i_width, i_height, i_x, i_y);
+      return;
+   }
+
+   if (i_left < 0) { i_width += i_left; i_x -= i_left; i_left = 0; } /* Clip to the source */
+   if (i_top < 0) { i_height += i_top; i_y -= i_top; i_top = 0; }
+   if (i_left + i_width > h_source->width) i_width = h_source->width - i_left;
+   if (i_top + i_height > h_source->height) i_height = h_source->height - i_top;
+   if (i_x < 0) { i_width += i_x; i_left -= i_x; i_x = 0; } /* Clip to the target */
+   if (i_y < 0) { i_height += i_y; i_top -= i_y; i_y = 0; }
+   if (i_x + i_width > h_target->width) i_width = h_target->width - i_x;
+   if (i_y + i_height > h_target->height) i_height = h_target->height - i_y;
+   if ((i_width <= 0) || (i_height <= 0)) return;
+
+   for (i_row = 0; i_row < i_height; i_row++)
+   {
+      h_from = h_source->pixel + (i_top + i_row) * h_source->stride + i_left;
+      h_to = h_target->pixel + (i_y + i_row) * h_target->stride + i_x;
+      for (i_count = 0; i_count < i_width; i_count++) h_to[i_count] = h_from[i_count];
+   }
+   if (h_target == &h_frame) v_frame_damage(i_x, i_y, i_x + i_width, i_y + i_height);
+}
+
+/*
+ * render_error (display, event)
+ *
+ * Records any error reported by the X server while attaching the  shared
+ * memory segment (if the X server is on another machine for example).
+ *
+ */
+
+#if defined(MITSHM)
+static int i_render_error(Display *h_display, XErrorEvent *h_event){
+
+   b_frame_error = True;
+   return(0);
+}
+#endif
+
+/*
+ * render_framebuffer (display, window, screen, width, height)
+ *
+ * Attempts  to create a frame buffer in shared memory that will be used to
+ * draw the window.   Returns False (and the window will be drawn by the X
+ * server as usual) if the MIT shared memory extension is not available or
+ * the window doesn't use 32-bit true colour pixels.
+ *
+ */
+
+int i_render_framebuffer(Display *h_display, Window x_window, int i_screen, int i_width, int i_height){
+
+#if defined(MITSHM)
+   int (*h_handler)(Display *, XErrorEvent *);
+   Visual *h_visual;
+   int i_order = 1;
+
+   if (x_frame_window != None) return(True); /* Already created */
+   if (!XShmQueryExtension(h_display)) return(False);
+   h_visual = DefaultVisual(h_display, i_screen);
+   if (h_visual->class != TrueColor) return(False);
+
+   h_frame_image = XShmCreateImage(h_display, h_visual, DefaultDepth(h_display, i_screen), ZPixmap, NULL,
+      &x_frame_segment, i_width, i_height);
+   if (h_frame_image == NULL) return(False);
+   if ((h_frame_image->bits_per_pixel != 32) || (sizeof(*h_frame.pixel) != 4) ||
+      (h_frame_image->byte_order != ((*(char *) &i_order) ? LSBFirst : MSBFirst))) /* Pixels must match the native format */
+   {
+      XDestroyImage(h_frame_image);
+      return(False);
+   }
+
+   x_frame_segment.shmid = shmget(IPC_PRIVATE, h_frame_image->bytes_per_line * i_height, IPC_CREAT | 0600);
+   if (x_frame_segment.shmid < 0)
+   {
+      XDestroyImage(h_frame_image);
+      return(False);
+   }
+   x_frame_segment.shmaddr = h_frame_image->data = shmat(x_frame_segment.shmid, NULL, 0);
+   x_frame_segment.readOnly = False;
+   b_frame_error = (x_frame_segment.shmaddr == (char *) -1);
+   if (!b_frame_error)
+   {
+      XSync(h_display, False);
+      h_handler = XSetErrorHandler(i_render_error);
+      XShmAttach(h_display, &x_frame_segment);
+      XSync(h_display, False); /* Wait for any error */
+      XSetErrorHandler(h_handler);
+   }
+   shmctl(x_frame_segment.shmid, IPC_RMID, NULL); /* Segment is removed when it is detached */
+   if (b_frame_error)
+   {
+      if (x_frame_segment.shmaddr != (char *) -1) shmdt(x_frame_segment.shmaddr);
+      h_frame_image->data = NULL;
+      XDestroyImage(h_frame_image);
+      return(False);
+   }
+
+   v_render_flush(h_display);
+   h_frame.width = i_width;
+   h_frame.height = i_height;
+   h_frame.stride = h_frame_image->bytes_per_line / 4;
+   h_frame.pixel = (unsigned int *) h_frame_image->data;
+   x_frame_window = x_window;
+   i_frame_left = i_frame_top = i_frame_right = i_frame_bottom = 0;
+   return(True);
+#else
+   return(False);
+#endif
+}
+
+/*
+ * render_sync (display)
+ *
+ * Sends anything that hasn't been drawn to the X server, and copies any part
+ * of the frame buffer that has changed to the window.
+ *
+ */
+
+void v_render_sync(Display *h_display){
+
+   v_render_flush(h_display);
+#if defined(MITSHM)
+   if ((x_frame_window != None) && (i_frame_right > i_frame_left))
+   {
+      XShmPutImage(h_display, x_frame_window, DefaultGC(h_display, DefaultScreen(h_display)), h_frame_image,
+         i_frame_left, i_frame_top, i_frame_left, i_frame_top,
+         i_frame_right - i_frame_left, i_frame_bottom - i_frame_top, False);
+      XSync(h_display, False); /* Don't change the frame buffer until the X server has finished with it */
+      i_frame_left = i_frame_top = i_frame_right = i_frame_bottom = 0;
+   }
+#endif
+}
+
+/* render_close (display) */
+
+void v_render_close(Display *h_display){
+
+   v_render_flush(h_display);
+#if defined(MITSHM)
+   if (x_frame_window != None)
+   {
+      XShmDetach(h_display, &x_frame_segment);
+      XSync(h_display, False);
+      shmdt(x_frame_segment.shmaddr);
+      h_frame_image->data = NULL;
+      XDestroyImage(h_frame_image);
+      x_frame_window = None;
+   }
+#endif
+}
+
+/*
+ * render_font (name)
+ *
+ * Returns  one of the built in fonts for use without an X server (picking
+ * the one that replaces the named X font if possible).
+ *
+ */
+
+XFontStruct *h_render_font(char *s_name){
+
+   XFontStruct *h_font;
+   int i_index;
+
+   for (i_index = sizeof(h_bitmap) / sizeof(*h_bitmap) - 1; i_index > 0; i_index--)
+      if (!strcmp(s_name, h_bitmap[i_index].name)) break;
+
+   if ((h_font = calloc(1, sizeof(*h_font))) == NULL) v_error("Memory allocation failed!");
+   h_font->fid = RENDER_IMAGE | i_index;
+   h_font->min_char_or_byte2 = BITMAP_FIRST;
+   h_font->max_char_or_byte2 = BITMAP_LAST;
+   h_font->default_char = ' ';
+   h_font->all_chars_exist = True;
+   h_font->max_bounds.width = h_font->max_bounds.rbearing = h_bitmap[i_index].width; /* All characters are the same size */
+   h_font->max_bounds.ascent = h_font->ascent = h_bitmap[i_index].ascent;
+   h_font->max_bounds.descent = h_font->descent = h_bitmap[i_index].descent;
+   h_font->min_bounds = h_font->max_bounds;
+   return(h_font);
+}
+
+/*
+ * render_save (drawable, filename)
+ *
+ * Saves a client side image as a PPM file, returning False if the file can
+ * not be written.
+ *
+ */
+
+int i_render_save(Drawable x_drawable, char *s_filename){
+
+   oimage *h_source;
+   FILE *h_file;
+   unsigned int i_pixel;
+   int i_x, i_y;
+
+   if ((h_source = h_render_image(x_drawable)) == NULL) return(False);
+   if ((h_file = fopen(s_filename, "wb")) == NULL) return(False);
+   fprintf(h_file, "P6\n%d %d\n255\n", h_source->width, h_source->height);
+   for (i_y = 0; i_y < h_source->height; i_y++)
+      for (i_x = 0; i_x < h_source->width; i_x++)
+      {
+         i_pixel = h_source->pixel[i_y * h_source->stride + i_x];
+         fputc((i_pixel >> 16) & 0xff, h_file);
+         fputc((i_pixel >> 8) & 0xff, h_file);
+         fputc(i_pixel & 0xff, h_file);
+      }
+   return(fclose(h_file) == 0);
+}
@@ -0,0 +1,68 @@
+/*
+ * x11-calc-render.h - RPN (Reverse Polish) calculator simulator.
+ *
+ * Copyright(C) 2026   MT
+ *
+ * Drawing primitives.
+ *
+ * Defines the routines used to draw lines, rectangles and text in a given
+ * colour.
+ *
+ * This  program is free software: you can redistribute it and/or modify it
+ * under  the terms of the GNU General Public License as published  by  the
+ * Free  Software Foundation, either version 3 of the License, or (at  your
+ * option) any later version.
+ *
+ * This  program  is distributed in the hope that it will  be  useful,  but
+ * WITHOUT   ANY   WARRANTY;   without even   the   implied   warranty   of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You  should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * 17 Oct 26         - Initial version - MT
+ *                   - Added  client side images and an optional  frame
+ *                     buffer using the MIT shared memory extension - MT
+ *                   - Added routines to draw without an X server - MT
+ *                   - Added render_flush_fonts() - MT
+ *
+ */
+
+#define RENDER_COLOURS  32             /* Number of graphics contexts */
+#define RENDER_BATCH    64             /* Maximum number of lines or rectangles in a batch */
+#define RENDER_FONTS    8              /* Number of fonts with client side glyphs */
+#define RENDER_IMAGE    0x40000000     /* Identifies a client side image (resource ids only use 29 bits) */
+
+void v_render_line(Display *h_display, Drawable x_drawable, unsigned int i_colour,
+   int i_x1, int i_y1, int i_x2, int i_y2);
+
+void v_render_rectangle(Display *h_display, Drawable x_drawable, unsigned int i_colour,
+   int i_left, int i_top, int i_width, int i_height);
+
+void v_render_fill(Display *h_display, Drawable x_drawable, unsigned int i_colour,
+   int i_left, int i_top, int i_width, int i_height);
+
+void v_render_text(Display *h_display, Drawable x_drawable, unsigned int i_colour,
+   XFontStruct *h_font, int i_left, int i_top, char *s_text, int i_length);
+
+void v_render_flush(Display *h_display);
+
+void v_render_flush_fonts(Display *h_display);
+
+Drawable x_render_create(Display *h_display, Drawable x_parent, int i_width, int i_height);
+
+void v_render_free(Display *h_display, Drawable x_drawable);
+
+void v_render_copy(Display *h_display, Drawable x_source, Drawable x_target,
+   int i_left, int i_top, int i_width, int i_height, int i_x, int i_y);
+
+int i_render_framebuffer(Display *h_display, Window x_window, int i_screen, int i_width, int i_height);
+
+void v_render_sync(Display *h_display);
+
+void v_render_close(Display *h_display);
+
+XFontStruct *h_render_font(char *s_name);
+
+int i_render_save(Drawable x_drawable, char *s_filename);
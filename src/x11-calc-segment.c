@@ -46,6 +46,13 @@
  * 03 Jan 21         - Changed debug() macro so that debug code is executed
  *                     when DEBUG is defined (doesn't need to be true) - MT
  * 08 Feb 22         - Include header for labels - MT
+ * 17 Oct 26         - Each combination of segments is only drawn once into
+ *                     a  pixmap  the first time it is used,  after  which
+ *                     drawing a digit just copies the pixmap - MT
+ *                   - Uses the common drawing routines - MT
+ *                   - Cached digits may be held in client side images - MT
+ *                   - The cached digits can be discarded explicitly - MT
+ *                   - Allocated from the current arena - MT
  *
  * TO DO :           - Optimize drawing of display segment by drawing in
  ^                     all the darker background regions before the foreground.
@@ -71,9 +78,15 @@
 
 #include "x11-calc-colour.h"
 #include "x11-calc-segment.h"
+#include "x11-calc-render.h"
+#include "x11-calc-arena.h"
 
 #include "gcc-debug.h"
 
+static Pixmap x_glyph[SEG_MASKS]; /* Pixmaps for each combination of segments */
+static int i_glyph_width, i_glyph_height; /* Size of the digits in the glyph cache */
+static unsigned int i_glyph_foreground, i_glyph_background; /* Colours used in the glyph cache */
+
 /*
  * segment_create (index, text, left, top, width, height, state,
  *                colour)
@@ -90,7 +103,7 @@ osegment *h_segment_create(int i_index, int i_mask, int i_left, int i_top,
    osegment *h_segment; /* Ponter to segment */
 
    /* Attempt to allocate memory for a segment */
-   if ((h_segment = malloc (sizeof(*h_segment)))==NULL) v_error("Memory allocation failed!");
+   h_segment = h_arena_alloc(sizeof(*h_segment));
 
    h_segment->index = i_index;
    h_segment->mask = i_mask;
@@ -105,8 +118,9 @@ osegment *h_segment_create(int i_index, int i_mask, int i_left, int i_top,
    return (h_segment);
 }
 
-int i_segment_draw(Display *h_display, int x_application_window, int i_screen, osegment *h_segment){ /* Draws all the segments */
+static void v_segment_render(Display *h_display, Drawable x_drawable, int i_screen, osegment *h_segment){ /* Draws all the segments */
 
+   unsigned int i_colour;
    int i_left, i_right, i_upper, i_lower;
    int i_offset;
 #if defined(HP10) || defined(HP67) || defined(HP35) || defined(HP80) || defined(HP45) || defined(HP70) || defined(HP55)
@@ -133,122 +147,191 @@ int i_segment_draw(Display *h_display, int x_application_window, int i_screen, o
       h_segment->mask & SEG_B && 1, h_segment->mask & SEG_A && 1));
 
    /* Draw the display segment background */
-   XSetForeground(h_display, DefaultGC(h_display, i_screen), h_segment->background);
-   XFillRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), h_segment->left, h_segment->top, h_segment->width, h_segment->height);
-   XDrawRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), h_segment->left, h_segment->top, h_segment->width, h_segment->height);
+   i_colour = h_segment->background;
+   v_render_fill(h_display, x_drawable, i_colour, h_segment->left, h_segment->top, h_segment->width, h_segment->height);
+   v_render_rectangle(h_display, x_drawable, i_colour, h_segment->left, h_segment->top, h_segment->width, h_segment->height);
 
    /* Fill in the background for each active display segment */
-   XSetForeground(h_display, DefaultGC(h_display, i_screen), i_shade(h_segment->foreground));
+   i_colour = i_shade(h_segment->foreground);
 
    if (h_segment->mask & SEG_A) { /* Draw the segment A */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_left, i_upper, i_right, i_upper);
-      XFillRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), i_left + 1, i_upper - 1, i_right - i_left - 1, 3);
+      v_render_line(h_display, x_drawable, i_colour, i_left, i_upper, i_right, i_upper);
+      v_render_fill(h_display, x_drawable, i_colour, i_left + 1, i_upper - 1, i_right - i_left - 1, 3);
    }
 
    if (h_segment->mask & SEG_B) { /* Draw the segment B */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_left , i_upper, i_left, i_offset);
-      XFillRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), i_left - 1, i_upper + 1, 3, i_offset - i_upper - 1);
+      v_render_line(h_display, x_drawable, i_colour, i_left , i_upper, i_left, i_offset);
+      v_render_fill(h_display, x_drawable, i_colour, i_left - 1, i_upper + 1, 3, i_offset - i_upper - 1);
    }
 
    if (h_segment->mask & SEG_C) { /* Draw the segment C */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_left , i_offset, i_left, i_lower);
-      XFillRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), i_left - 1, i_offset + 1, 3, i_lower - i_offset - 1);
+      v_render_line(h_display, x_drawable, i_colour, i_left , i_offset, i_left, i_lower);
+      v_render_fill(h_display, x_drawable, i_colour, i_left - 1, i_offset + 1, 3, i_lower - i_offset - 1);
    }
 
    if (h_segment->mask & SEG_D) { /* Draw the segment D */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_left, i_lower, i_right, i_lower);
-      XFillRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), i_left + 1, i_lower - 1, i_right - i_left - 1, 3);
+      v_render_line(h_display, x_drawable, i_colour, i_left, i_lower, i_right, i_lower);
+      v_render_fill(h_display, x_drawable, i_colour, i_left + 1, i_lower - 1, i_right - i_left - 1, 3);
    }
 
    if (h_segment->mask & SEG_E) { /* Draw the segment E */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right , i_lower, i_right, i_offset);
-      XFillRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right - 1, i_offset + 1, 3, i_lower - i_offset - 1);
+      v_render_line(h_display, x_drawable, i_colour, i_right , i_lower, i_right, i_offset);
+      v_render_fill(h_display, x_drawable, i_colour, i_right - 1, i_offset + 1, 3, i_lower - i_offset - 1);
    }
 
    if (h_segment->mask & SEG_F) { /* Draw the segment F */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right , i_offset, i_right, i_upper);
-      XFillRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right - 1, i_upper + 1, 3, i_offset - i_upper - 1);
+      v_render_line(h_display, x_drawable, i_colour, i_right , i_offset, i_right, i_upper);
+      v_render_fill(h_display, x_drawable, i_colour, i_right - 1, i_upper + 1, 3, i_offset - i_upper - 1);
    }
 
    if (h_segment->mask & SEG_G) { /* Draw the segment G */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_left, i_offset, i_right, i_offset);
-      XFillRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), i_left + 1, i_offset - 1, i_right - i_left - 1, 3);
+      v_render_line(h_display, x_drawable, i_colour, i_left, i_offset, i_right, i_offset);
+      v_render_fill(h_display, x_drawable, i_colour, i_left + 1, i_offset - 1, i_right - i_left - 1, 3);
    }
 
 #if defined(HP10) || defined(HP67) || defined(HP35) || defined(HP80) || defined(HP45) || defined(HP70) || defined(HP55)
    if (h_segment->mask & SEG_DECIMAL) { /* Draw a decimal point separator */
-      XFillRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), i_middle - 1 , (i_upper + 3 * (i_lower - i_upper) / 4) - 1, 3, 3);
+      v_render_fill(h_display, x_drawable, i_colour, i_middle - 1 , (i_upper + 3 * (i_lower - i_upper) / 4) - 1, 3, 3);
    }
 #else
    if (h_segment->mask & SEG_DECIMAL) { /* Draw a decimal point separator */
-      XFillRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right + 3, i_lower - 1, 3, 3);
+      v_render_fill(h_display, x_drawable, i_colour, i_right + 3, i_lower - 1, 3, 3);
    }
 
    if (h_segment->mask & SEG_COMMA) { /* Draw a comma separator */
-      XFillRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right + 3, i_lower - 1, 3, 3);
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right + 3, i_lower + 2, i_right + 3, i_lower + 2);
+      v_render_fill(h_display, x_drawable, i_colour, i_right + 3, i_lower - 1, 3, 3);
+      v_render_line(h_display, x_drawable, i_colour, i_right + 3, i_lower + 2, i_right + 3, i_lower + 2);
    }
 
    if (h_segment->mask & SEG_COLON) { /* Draw a colon separator */
-      XFillRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right + 3, i_offset - 4, 3, 3);
-      XFillRectangle(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right + 3, i_offset + 2, 3, 3);
+      v_render_fill(h_display, x_drawable, i_colour, i_right + 3, i_offset - 4, 3, 3);
+      v_render_fill(h_display, x_drawable, i_colour, i_right + 3, i_offset + 2, 3, 3);
    }
 #endif
 
    /* Draw the in the foreground elements */
-   XSetForeground(h_display, DefaultGC(h_display, i_screen), h_segment->foreground);
+   i_colour = h_segment->foreground;
    if (h_segment->mask & SEG_A) { /* Draw the segment A */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_left + 1, i_upper, i_right - 1, i_upper);
+      v_render_line(h_display, x_drawable, i_colour, i_left + 1, i_upper, i_right - 1, i_upper);
    }
 
    if (h_segment->mask & SEG_B) { /* Draw the segment B */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_left , i_upper + 1, i_left, i_offset - 1);
+      v_render_line(h_display, x_drawable, i_colour, i_left , i_upper + 1, i_left, i_offset - 1);
    }
 
    if (h_segment->mask & SEG_C) { /* Draw the segment C */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_left , i_offset + 1, i_left, i_lower - 1);
+      v_render_line(h_display, x_drawable, i_colour, i_left , i_offset + 1, i_left, i_lower - 1);
    }
 
    if (h_segment->mask & SEG_D) { /* Draw the segment D */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_left + 1, i_lower, i_right - 1, i_lower);
+      v_render_line(h_display, x_drawable, i_colour, i_left + 1, i_lower, i_right - 1, i_lower);
    }
 
    if (h_segment->mask & SEG_E) { /* Draw the segment E */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right , i_lower - 1, i_right, i_offset + 1);
+      v_render_line(h_display, x_drawable, i_colour, i_right , i_lower - 1, i_right, i_offset + 1);
    }
 
    if (h_segment->mask & SEG_F) { /* Draw the segment F */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right , i_offset - 1, i_right, i_upper + 1);
+      v_render_line(h_display, x_drawable, i_colour, i_right , i_offset - 1, i_right, i_upper + 1);
    }
 
    if (h_segment->mask & SEG_G) { /* Draw the segment G */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_left + 1, i_offset, i_right - 1, i_offset);
+      v_render_line(h_display, x_drawable, i_colour, i_left + 1, i_offset, i_right - 1, i_offset);
    }
 
 #if defined(HP10) || defined(HP67) || defined(HP35) || defined(HP80) || defined(HP45) || defined(HP70) || defined(HP55)
    if (h_segment->mask & SEG_DECIMAL) { /* Draw a decimal point separator */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_middle, (i_upper + 3 * (i_lower - i_upper) / 4) - 1, i_middle, (i_upper + 3 * (i_lower - i_upper) / 4) + 1);
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_middle - 1, (i_upper + 3 * (i_lower - i_upper) / 4), i_middle + 1, (i_upper + 3 * (i_lower - i_upper) / 4));
+      v_render_line(h_display, x_drawable, i_colour, i_middle, (i_upper + 3 * (i_lower - i_upper) / 4) - 1, i_middle, (i_upper + 3 * (i_lower - i_upper) / 4) + 1);
+      v_render_line(h_display, x_drawable, i_colour, i_middle - 1, (i_upper + 3 * (i_lower - i_upper) / 4), i_middle + 1, (i_upper + 3 * (i_lower - i_upper) / 4));
    }
 #else
    if (h_segment->mask & SEG_DECIMAL) { /* Draw a decimal point separator */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right + 3, i_lower, i_right + 5, i_lower);
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right + 4, i_lower - 1, i_right + 4, i_lower + 1);
+      v_render_line(h_display, x_drawable, i_colour, i_right + 3, i_lower, i_right + 5, i_lower);
+      v_render_line(h_display, x_drawable, i_colour, i_right + 4, i_lower - 1, i_right + 4, i_lower + 1);
    }
 
    if (h_segment->mask & SEG_COMMA) { /* Draw a comma separator */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right + 3, i_lower, i_right + 5, i_lower);
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right + 4, i_lower - 1, i_right + 4, i_lower + 1);
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right + 3, i_lower + 3, i_right + 4, i_lower + 3);
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right + 2, i_lower + 4, i_right + 3, i_lower + 4);
+      v_render_line(h_display, x_drawable, i_colour, i_right + 3, i_lower, i_right + 5, i_lower);
+      v_render_line(h_display, x_drawable, i_colour, i_right + 4, i_lower - 1, i_right + 4, i_lower + 1);
+      v_render_line(h_display, x_drawable, i_colour, i_right + 3, i_lower + 3, i_right + 4, i_lower + 3);
+      v_render_line(h_display, x_drawable, i_colour, i_right + 2, i_lower + 4, i_right + 3, i_lower + 4);
    }
 
    if (h_segment->mask & SEG_COLON) { /* Draw a decimal point separator */
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right + 3, i_offset - 3, i_right + 5, i_offset - 3);
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right + 4, i_offset - 4, i_right + 4, i_offset - 2);
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right + 3, i_offset + 3, i_right + 5, i_offset + 3);
-      XDrawLine(h_display, x_application_window, DefaultGC(h_display, i_screen), i_right + 4, i_offset + 4, i_right + 4, i_offset + 2);
+      v_render_line(h_display, x_drawable, i_colour, i_right + 3, i_offset - 3, i_right + 5, i_offset - 3);
+      v_render_line(h_display, x_drawable, i_colour, i_right + 4, i_offset - 4, i_right + 4, i_offset - 2);
+      v_render_line(h_display, x_drawable, i_colour, i_right + 3, i_offset + 3, i_right + 5, i_offset + 3);
+      v_render_line(h_display, x_drawable, i_colour, i_right + 4, i_offset + 4, i_right + 4, i_offset + 2);
    }
 #endif
+}
+
+/*
+ * segment_flush (display)
+ *
+ * Frees the pixmaps used to hold each combination of segments.
+ *
+ */
+
+void v_segment_flush(Display *h_display){
+
+   int i_count;
+
+   for (i_count = 0; i_count < SEG_MASKS; i_count++)
+      if (x_glyph[i_count] != None)
+      {
+         v_render_free(h_display, x_glyph[i_count]);
+         x_glyph[i_count] = None;
+      }
+}
+
+/*
+ * segment_draw (display, window, screen, segment)
+ *
+ * Draws  a digit by copying the pixmap holding the required combination of
+ * segments,  drawing  it first if this is the first time this  combination
+ * has been used.
+ *
+ * All the digits in a display are the same size and colour so they share a
+ * single  set of pixmaps which are discarded if a digit with  a  different
+ * size or colour is drawn.
+ *
+ */
+
+int i_segment_draw(Display *h_display, int x_application_window, int i_screen, osegment *h_segment){
+
+   osegment h_glyph;
+   int i_mask;
+
+   i_mask = h_segment->mask;
+   if ((i_mask < 0) || (i_mask >= SEG_MASKS)) /* Not a valid combination of segments so just draw it */
+   {
+      v_segment_render(h_display, x_application_window, i_screen, h_segment);
+      v_render_flush(h_display);
+      return(True);
+   }
+
+   if ((h_segment->width != i_glyph_width) || (h_segment->height != i_glyph_height) ||
+      (h_segment->foreground != i_glyph_foreground) || (h_segment->background != i_glyph_background))
+   {
+      v_segment_flush(h_display);
+      i_glyph_width = h_segment->width;
+      i_glyph_height = h_segment->height;
+      i_glyph_foreground = h_segment->foreground;
+      i_glyph_background = h_segment->background;
+   }
+
+   if (x_glyph[i_mask] == None) /* Draw the digit in a pixmap the first time it is used */
+   {
+      x_glyph[i_mask] = x_render_create(h_display, x_application_window, i_glyph_width + 1, i_glyph_height + 1);
+      h_glyph = *h_segment;
+      h_glyph.left = 0;
+      h_glyph.top = 0;
+      v_segment_render(h_display, x_glyph[i_mask], i_screen, &h_glyph);
+      v_render_flush(h_display);
+   }
+
+   v_render_copy(h_display, x_glyph[i_mask], x_application_window, 0, 0,
+      i_glyph_width + 1, i_glyph_height + 1, h_segment->left, h_segment->top);
    return(True);
 }
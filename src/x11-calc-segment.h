@@ -25,6 +25,9 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  *
  * 14 Jul 13         - Initial version - MT
+ * 17 Oct 26         - Added the number of possible segment combinations  -
+ *                     MT
+ *                   - Made segment_flush() public - MT
  *
  */
 
@@ -39,6 +42,8 @@
 #define SEG_COMMA      0x0100
 #define SEG_COLON      0x0200
 
+#define SEG_MASKS      0x0400  /* Number of possible combinations */
+
 typedef struct { /* Calculator segment structure. */
    int index;
    int mask;
@@ -55,4 +60,6 @@ osegment *h_segment_create(int i_index, int i_mask, int i_left, int i_top,
 
 int i_segment_draw(Display *h_display, int x_application_window, int i_screen,osegment *h_segment);
 
+void v_segment_flush(Display *h_display);
+
 
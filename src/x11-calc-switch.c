@@ -22,6 +22,8 @@
  * 10 Oct 21         - Allow use of NULL pointers - MT
  * 03 Jan 21         - Changed debug() macro so that debug code is executed
  *                     when DEBUG is defined (doesn't need to be true) - MT
+ * 17 Oct 26         - Uses the common drawing routines - MT
+ *                   - Allocated from the current arena - MT
  *
  */
 
@@ -45,6 +47,8 @@
 #include "x11-calc.h"
 
 #include "x11-calc-colour.h"
+#include "x11-calc-render.h"
+#include "x11-calc-arena.h"
 #include "gcc-debug.h"
 
 /* switch_pressed (switch, x, y) */
@@ -77,7 +81,7 @@ oswitch *h_switch_create(int i_index, char* s_text, char* s_alternate,
    oswitch *h_switch; /* Ponter to switch. */
 
    /* Attempt to allcoate memory for a switch. */
-   if ((h_switch = malloc (sizeof(*h_switch)))==NULL) v_error("Memory allocation failed!");
+   h_switch = h_arena_alloc(sizeof(*h_switch));
 
    h_switch->index = i_index;
    h_switch->text = s_text;
@@ -99,26 +103,29 @@ oswitch *h_switch_create(int i_index, char* s_text, char* s_alternate,
 
 int i_switch_draw(Display *h_display, int x_application_window, int i_screen, oswitch *h_switch){
 
+   XFontStruct *h_font;
+   unsigned int i_colour;
    int i_indent, i_upper;
 
    if (h_switch != NULL) {
       if (h_switch->state) /* Select the text colour */
-         XSetForeground(h_display, DefaultGC(h_display, i_screen), h_switch->alternate_colour);
+         i_colour = h_switch->alternate_colour;
       else
-         XSetForeground(h_display, DefaultGC(h_display, i_screen), h_switch->colour);
+         i_colour = h_switch->colour;
 
-      XSetFont(h_display, DefaultGC(h_display, i_screen), h_switch->text_font->fid); /* Set the text font. */
+      h_font = h_switch->text_font; /* Set the text font. */
       i_upper = h_switch->top + (h_switch->text_font->ascent) + (h_switch->height - (h_switch->text_font->ascent + h_switch->text_font->descent)) / 2;
       i_indent = 1 + h_switch->left + ((h_switch->width / 2) - XTextWidth(h_switch->text_font, h_switch->text, strlen(h_switch->text))) / 2; /* Find position of the text */
-      XDrawString(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent, i_upper, h_switch->text, strlen(h_switch->text)); /* Draw the main text */
+      v_render_text(h_display, x_application_window, i_colour, h_font, i_indent, i_upper, h_switch->text, strlen(h_switch->text)); /* Draw the main text */
 
       if (h_switch->state) /* Select the alternate text colour */
-         XSetForeground(h_display, DefaultGC(h_display, i_screen), h_switch->colour);
+         i_colour = h_switch->colour;
       else
-         XSetForeground(h_display, DefaultGC(h_display, i_screen), h_switch->alternate_colour);
+         i_colour = h_switch->alternate_colour;
 
       i_indent = 1 + h_switch->left + (h_switch->width / 2) + ((h_switch->width / 2) - XTextWidth(h_switch->text_font, h_switch->text, strlen(h_switch->text))) / 2; /* Find position of the text */
-      XDrawString(h_display, x_application_window, DefaultGC(h_display, i_screen), i_indent, i_upper, h_switch->alternate, strlen(h_switch->alternate)); /* Draw the main text */
+      v_render_text(h_display, x_application_window, i_colour, h_font, i_indent, i_upper, h_switch->alternate, strlen(h_switch->alternate)); /* Draw the main text */
+      v_render_flush(h_display);
    }
    return(True);
 }
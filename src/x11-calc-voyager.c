@@ -0,0 +1,1021 @@
+/*
+ * x11-calc-voyager.c - RPN (Reverse Polish) calculator simulator.
+ *
+ * Copyright(C) 2018   MT
+ *
+ * Voyager processor simulator.
+ *
+ * Decodes  and  executes  the instructions  used  by  the  Voyager
+ * series (HP10C, HP11C, HP12C, HP15C and HP16C).
+ *
+ * This  program is free software: you can redistribute it and/or modify it
+ * under  the terms of the GNU General Public License as published  by  the
+ * Free  Software Foundation, either version 3 of the License, or (at  your
+ * option) any later version.
+ *
+ * This  program  is distributed in the hope that it will  be  useful,  but
+ * WITHOUT   ANY   WARRANTY;   without even   the   implied   warranty   of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You  should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * 17 Oct 26         - Initial version (moved from x11-calc-cpu.c) - MT
+ *                   - Translates  each  address to a memory  register  using
+ *                     a table built from the memory map for each model - MT
+ *                   - Fixed the check for an invalid ROM address in cxisa
+ *                     - MT
+ *                   - Uses the ROM page table to increment the  program
+ *                     counter - MT
+ *                   - The address table is built once when the processor
+ *                     is created - MT
+ *
+ */
+
+#define NAME           "x11-calc-voyager"
+#define VERSION        "0.1"
+#define BUILD          "0001"
+#define DATE           "17 Oct 26"
+#define AUTHOR         "MT"
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+
+#include "x11-calc-font.h"
+#include "x11-calc-label.h"
+#include "x11-calc-switch.h"
+#include "x11-calc-button.h"
+
+#include "x11-calc-cpu.h"
+#include "x11-calc-arena.h"
+
+#include "x11-calc-messages.h"
+
+#include "gcc-debug.h" /* print() */
+#include "gcc-wait.h"  /* i_wait() */
+
+#if defined(HP10c) || defined(HP11c) || defined(HP12c) || defined(HP15c) || defined(HP16c)
+
+static unsigned char *h_active_pointer (oprocessor *h_processor) /* Return address of active pointer */
+{
+   if (h_processor->ptr)
+      return &h_processor->q;
+   else
+      return &h_processor->p;
+}
+
+static void v_op_inc_pt(oprocessor *h_processor) /* Increment active pointer */
+{
+   if (*h_active_pointer(h_processor) == REG_SIZE - 1)
+      *h_active_pointer(h_processor) = 0;
+   else
+   {
+      if (*h_active_pointer(h_processor) > 0)
+         *h_active_pointer(h_processor) = *h_active_pointer(h_processor) + 1;
+      else
+      {
+         if (h_processor->opcode != h_processor->rom[h_processor->pc - 1]) /* Literally the only way to work out if the pointer */
+            *h_active_pointer(h_processor) = *h_active_pointer(h_processor) + 1; /* should be incremented when it is zero is to check the previous opcode ! */
+      }
+   }
+}
+
+static void v_op_dec_pt(oprocessor *h_processor) /* Decrement active pointer */
+{
+   if (*h_active_pointer(h_processor) == 0) *h_active_pointer(h_processor) = REG_SIZE - 1; else *h_active_pointer(h_processor) = *h_active_pointer(h_processor) - 1;
+}
+
+static const int i_memory_ranges[][2] = MEMORY_MAP; /* First and last address of each range of memory registers */
+static const int i_missing[] = {0x08, 0x18}; /* Non existent registers */
+static short i_memory_map[256]; /* Memory register used for each address (or -1 if it doesn't exist) */
+
+void v_address_map() /* Number the memory registers at each address */
+{
+   int i_count, i_addr, i_register = 0;
+
+   for (i_addr = 0; i_addr < (int) (sizeof(i_memory_map) / sizeof(*i_memory_map)); i_addr++)
+      i_memory_map[i_addr] = -1;
+   for (i_count = 0; i_count < (int) (sizeof(i_memory_ranges) / sizeof(*i_memory_ranges)); i_count++)
+      for (i_addr = i_memory_ranges[i_count][0]; (i_addr <= i_memory_ranges[i_count][1]) && (i_register < MEMORY_SIZE); i_addr++)
+         i_memory_map[i_addr] = i_register++;
+   for (i_count = 0; i_count < (int) (sizeof(i_missing) / sizeof(*i_missing)); i_count++)
+      i_memory_map[i_missing[i_count]] = -1; /* Keeps its place, so the registers below are not renumbered */
+}
+
+int i_translate_addr(int i_addr) /* Translate address to a memory register (returns -1 if it doesn't exist) */
+{
+   if ((i_addr < 0) || (i_addr >= (int) (sizeof(i_memory_map) / sizeof(*i_memory_map)))) return(-1);
+   return(i_memory_map[i_addr]);
+}
+
+static void v_op_inc_pc(oprocessor *h_processor) /* Increment program counter */
+{
+   h_processor->pc = h_processor->next[h_processor->pc / ROM_PAGE][((h_processor->pc % ROM_PAGE) + 1) / ROM_PAGE] | ((h_processor->pc + 1) % ROM_PAGE); /* Wraps round at the end of each bank and the end of memory */
+   h_processor->flags[PREV_CARRY] = h_processor->flags[CARRY];
+   h_processor->flags[CARRY] = False;
+}
+
+void op_jsb(oprocessor *h_processor, int i_address) /* Call to subroutine */
+{
+   h_processor->stack[h_processor->sp] = h_processor->pc; /* Push current address on the stack */
+   h_processor->sp = (h_processor->sp + 1) & (STACK_SIZE - 1); /* Update stack pointer */
+   h_processor->pc = i_address; /* Long address */
+}
+
+void v_op_goto(oprocessor *h_processor) /* Conditional go to */
+{
+   if (h_processor->trace)
+   {
+      fprintf(stdout, "\n"); fprintf(stdout,h_msg_opcode, (h_processor->pc >> 12), (h_processor->pc & 0x0fff), h_processor->rom[h_processor->pc]);
+      fprintf(stdout,"  then go to ");
+   }
+   h_processor->flags[PREV_CARRY] = h_processor->flags[CARRY];
+   h_processor->flags[CARRY] = False;
+   if (h_processor->trace) fprintf(stdout, h_msg_address, ((h_processor->pc & 0xc00) | h_processor->rom[h_processor->pc] )); /* Mask off the bank number and least significant 10 bits */
+   if (h_processor->flags[PREV_CARRY])  /* Do if True */
+      h_processor->pc = ((h_processor->pc & 0xfc00) | h_processor->rom[h_processor->pc]); /* Use a _ten_ bit address */
+   else
+      v_op_inc_pc(h_processor);
+}
+
+void v_processor_execute(oprocessor *h_processor) /* Decode and execute a single instruction */
+{
+
+   static const int n_map_i[16] = {  3,  4,  5, 10,  8,  6, 11, -1,  2,  9,  7, 13,  1, 12,  0, -1 }; /* map nnnn to index */
+
+   unsigned int i_last; /* Save the current PC */
+   unsigned int i_opcode;
+   unsigned int i_field; /* Field modifier */
+   const char *s_field; /* Holds pointer to field name */
+   int i_register; /* Memory register at the current data address */
+
+   if (h_processor->keypressed) h_processor->kyf = True; /* Set keyboard flag if key pressed */
+
+   i_opcode = h_processor->rom[h_processor->pc]; /* Get next instruction */
+   i_last = h_processor->pc;
+   if (h_processor->trace)
+      fprintf(stdout, h_msg_opcode, (i_last >> 12), (i_last & 0x0fff), h_processor->rom[i_last]);
+   v_op_inc_pc(h_processor); /* Increment program counter _before_ decoding the opcode */
+   switch (i_opcode & 03)
+   {
+
+   case 0x00: /* Type 0 - Special operations */
+      switch ((i_opcode >> 2) & 0xf)
+      {
+      case 0x00:
+         switch (i_opcode >> 6)
+         {
+         case 0x00: /* No operation (00 0000 0000) */
+            if (h_processor->trace) fprintf(stdout, "nop");
+            break;
+         default:
+            if (h_processor->trace) fprintf(stdout, "\n");
+            v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         break;
+
+      case 0x01: /* 0 -> status[7:0] - Clear status (11 1100 0100) or 0 -> status[d] - Clear status bit (dd dd00 0100) */
+         if ((i_opcode >> 6) == 7) /* Reserved opcode (01 1100 0100) */
+         {
+            if (h_processor->trace) fprintf(stdout, "\n");
+            v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         if ((i_opcode >> 6) < 15)
+         {
+            if (h_processor->trace) fprintf(stdout, "st = 0 %-2d\t\t", n_map_i[i_opcode >> 6]);
+            h_processor->status[n_map_i[i_opcode >> 6]] = False;
+         }
+         else
+         {
+            int i_count;
+            if (h_processor->trace) fprintf(stdout, "clrst\t\t");
+            for (i_count = 7; i_count >= 0; i_count--) /* Note only clears bits 7-0 of the status register */
+               h_processor->status[n_map_i[i_opcode >> 6]] = False;
+         }
+         if (h_processor->trace) v_fprint_status(stdout, h_processor);
+         break;
+      case 0x02: /* 0 -> kyf  - Reset keyboard (11 1100 1000) or 1 -> status[d] - Set status bit (dd dd00 0100) */
+         if ((i_opcode >> 6) == 7) /* Reserved opcode (01 1100 1000) */
+         {
+            if (h_processor->trace) fprintf(stdout, "\n");
+            v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         if ((i_opcode >> 6) < 15)
+         {
+            if (h_processor->trace) fprintf(stdout, "st = 1 %-2d\t\t", n_map_i[i_opcode >> 6]);
+            h_processor->status[n_map_i[i_opcode >> 6]] = True;
+            if (h_processor->trace) v_fprint_status(stdout, h_processor);
+         }
+         else
+         {
+            if (h_processor->trace) fprintf(stdout, "rstkb");
+            if (!h_processor->keypressed) h_processor->flags[CARRY] = h_processor->kyf = False; /* Clear keyboard flag if no key pressed */
+         }
+         break;
+      case 0x03: /* Test status bit [dddd] if 0 <= dddd <= 14 (dd dd00 1100) or test keyboard (11 1100 1100) */
+         if ((i_opcode >> 6) == 7) /* Reserved opcode (01 1100 1100) */
+         {
+            if (h_processor->trace) fprintf(stdout, "\n");
+            v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         if ((i_opcode >> 6) < 15)
+         {
+            if (h_processor->trace) fprintf(stdout, "? st = 1 %-2d", n_map_i[i_opcode >> 6]);
+            h_processor->flags[CARRY] = h_processor->status[n_map_i[i_opcode >> 6]];
+         }
+         else
+         {
+            if (h_processor->trace) fprintf(stdout, "chkkb ");
+            h_processor->flags[CARRY] = h_processor->kyf;
+         }
+         break;
+      case 0x04: /* nn -> c[pt] - Load constant n (nn nn01 0000) */
+         if (h_processor->trace) fprintf(stdout, "lc %1x\t\t", i_opcode >> 6);
+         h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor)] = i_opcode >> 6;
+         v_op_dec_pt(h_processor);
+         if (h_processor->trace)
+            v_fprint_register(stdout, h_processor->reg[C_REG]);
+         break;
+      case 0x05: /* Test pointer equal to dddd if 0 <= dddd <= 14 (dd dd00 1100) or decrement pointer (11 1101 0100) */
+         if ((i_opcode >> 6) == 7) /* Reserved opcode (01 1101 0100) */
+         {
+            if (h_processor->trace) fprintf(stdout, "\n");
+            v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         if ((i_opcode >> 6) < 15)
+         {
+            if (h_processor->trace) fprintf(stdout, "? pt = %d", n_map_i[i_opcode >> 6]);
+            h_processor->flags[CARRY] = (*h_active_pointer(h_processor) == n_map_i[i_opcode >> 6]);
+         }
+         else
+         {
+            if (h_processor->trace) fprintf(stdout, "dec pt");
+            v_op_dec_pt(h_processor);
+         }
+         break;
+
+      case 0x06:
+         switch (i_opcode >> 6)
+         {
+         case 0x0: /* Reserved opcode (00 0001 1000) */
+            if (h_processor->trace) fprintf(stdout, "\n");
+            v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+            break;
+         case 0x01: /* c[pt + 1:pt] -> g - Load g from c (00 0101 1000) */
+            if (h_processor->trace) fprintf(stdout, "g = c\t\t");
+            h_processor->g[0]  = h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor)] & 0x0f; /* c[pt] -> g[0] */
+            if (*h_active_pointer(h_processor) < (REG_SIZE - 1))  /* Check that pt + 1 is valid */
+               h_processor->g[1] = h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor) + 1] & 0x0f; /* c[pt + 1] -> g[1] */
+            if (h_processor->trace)
+               fprintf(stdout, "g = 0x%02x", h_processor->g[0] | (h_processor->g[1] << 4));
+            break;
+         case 0x02: /* g -> c[pt + 1:pt] - Load c from g (00 0101 1000) */
+            if (h_processor->trace) fprintf(stdout, "c = g\t\t");
+            h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor)] = h_processor->g[0]; /* g[0] -> c[pt] */
+            if (*h_active_pointer(h_processor) < (REG_SIZE - 1))  /* Check that pt + 1 is valid */
+               h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor) + 1] = h_processor->g[1]; /* g[1] -> c[pt + 1] */
+            if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
+            break;
+         case 0x03: /* g -> c[pt + 1:pt], c[pt + 1:pt] -> g - Exchange c and g (00 1101 1000 */
+            if (h_processor->trace) fprintf(stdout, "cgex\t\t");
+            {
+               int i_temp[2];
+               i_temp[0] = h_processor->g[0]; i_temp[1] = h_processor->g[1];
+               h_processor->g[0] = h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor)] & 0x0f; /* c[pt] -> g[0] */
+               h_processor->g[1] = 0; /* (0 -> g[1]) */
+               h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor)] = i_temp[0]; /* g[0] -> c[pt] */
+               if (*h_active_pointer(h_processor) < (REG_SIZE - 1))  /* Check that pt + 1 is valid */
+               {
+                  h_processor->g[1] = h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor) + 1] & 0x0f; /* c[pt + 1] -> g[1] */
+                  h_processor->reg[C_REG]->nibble[*h_active_pointer(h_processor) + 1] = i_temp[1]; /* g[1] -> c[pt + 1] */
+               }
+            }
+            if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
+            if (h_processor->trace) fprintf(stdout, "g = 0x%02x", h_processor->g[0] | (h_processor->g[1] << 4));
+            break;
+         case 0x05: /* c -> m - Copy C register to M register (01 0101 1000) */
+            if (h_processor->trace) fprintf(stdout, "m = c\t\t");
+            h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+            v_reg_copy(h_processor, h_processor->reg[M_REG], h_processor->reg[C_REG]);
+            if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[M_REG]);
+            break;
+         case 0x06: /* m -> c - Copy M register to C register (01 1001 1000) */
+            if (h_processor->trace) fprintf(stdout, "c = m\t\t");
+            h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+            v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->reg[M_REG]);
+            if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
+            break;
+         case 0x07: /* c -> m, m -> c - Exchange C register and M register (01 1101 1000) */
+            if (h_processor->trace) fprintf(stdout, "cmex\t\t");
+            h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+            v_reg_exch(h_processor, h_processor->reg[M_REG], h_processor->reg[C_REG]);
+            if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
+            if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[M_REG]);
+            break;
+         case 0x0e: /* st[0:7] -> c[0:1] - Load c register from the status byte (11 1001 1000) */
+            if (h_processor->trace) fprintf(stdout, "c = st\t\t");
+            {
+               int i_status, i_count;
+               i_status = 0;
+               for (i_count = 7; i_count >= 0 ; i_count--)
+               {
+                  i_status <<= 1;
+                  if (h_processor->status[i_count]) i_status |= 0x1;
+               }
+               h_processor->reg[C_REG]->nibble[0] = i_status & 0xf;
+               h_processor->reg[C_REG]->nibble[1] = i_status >> 4;
+            }
+            if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
+            break;
+         case 0x0f: /* c[0:1] -> st[0:7], st[0:7] -> c[0:1] - Exchange c register and the status byte (11 1101 1000) */
+            if (h_processor->trace) fprintf(stdout, "cstex\t\t");
+            {
+               int i_temp, i_status, i_count;
+               i_status = 0; /* Save st[0:7] */
+               for (i_count = 7; i_count >= 0 ; i_count--)
+               {
+                  i_status <<= 1;
+                  if (h_processor->status[i_count]) i_status |= 0x1;
+               }
+               i_temp = h_processor->reg[C_REG]->nibble[0] | h_processor->reg[C_REG]->nibble[1] << 4;
+               for (i_count = 0; i_count <=7; i_count++)
+               {
+                  if (i_temp & 0x1)
+                     h_processor->status[i_count] = True;
+                  else
+                     h_processor->status[i_count] = False;
+                  i_temp >>= 1;
+               }
+               h_processor->reg[C_REG]->nibble[0] = i_status & 0xf;
+               h_processor->reg[C_REG]->nibble[1] = i_status >> 4;
+            }
+            if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
+            if (h_processor->trace) v_fprint_status(stdout, h_processor);
+            break;
+         default:
+            if (h_processor->trace) fprintf(stdout, "\n");
+            debug(fprintf(stderr,"%02x\n", (i_opcode >> 6) & 0xf));
+            v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         break;
+      case 0x07: /* Load pointer with dddd if 0 <= dddd <= 14 (dd dd00 1100) or decrement pointer (11 1101 0100) */
+         if ((i_opcode >> 6) == 7) /* Reserved opcode (01 1101 0100)*/
+         {
+            if (h_processor->trace) fprintf(stdout, "\n");
+            v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         if ((i_opcode >> 6) < 15)
+         {
+            if (h_processor->trace) fprintf(stdout, "pt = %d", n_map_i[i_opcode >> 6]);
+            *h_active_pointer(h_processor) = n_map_i[i_opcode >> 6];
+            if (h_processor->trace) fprintf(stdout, "\t\tpt = %02d  ", *h_active_pointer(h_processor));
+         }
+         else
+         {
+            if (h_processor->trace) fprintf(stdout, "inc pt");
+            v_op_inc_pt(h_processor);
+         }
+         break;
+
+      case 0x08: /* xxxx 10 0000 */
+         switch ((i_opcode >> 6) & 0xf)
+         {
+         case 0x01: /* Power off (00 0110 0000) */
+            if (h_processor->trace) fprintf(stdout, "powoff");
+            if (h_processor->flags[DISPLAY_ENABLE]) /* Sleep */
+            {
+               h_processor->sleep = True;
+            }
+            else  /* Poweroff */
+            {
+               h_processor->flags[CARRY] = True; /* Carry set on deep sleep */
+               h_processor->enabled = False;
+            }
+            h_processor->pc = 0;
+            break;
+         case 0x02: /* pt = p - Select pointer p (00 1010 0000) */
+            if (h_processor->trace) fprintf(stdout, "sel p\t\t");
+            h_processor->ptr = False;
+            break;
+         case 0x03: /* pt = q - Select pointer q (00 1110 0000) */
+            if (h_processor->trace) fprintf(stdout, "sel q\t\t");
+            h_processor->ptr = True;
+            break;
+         case 0x04: /* ? p == q - Test p equal to q  (01 0010 0000) */
+            if (h_processor->trace) fprintf(stdout, "? p = q\t\t");
+            if (h_processor->p == h_processor->q) h_processor->flags[CARRY] = True;
+            break;
+         case 0x05: /* ? low level detect - Test battery state (01 0110 0000) */
+            if (h_processor->trace) fprintf(stdout, "? lld\t\t");
+            /* Do nothing - battery can never go flat */
+            break;
+         case 0x06: /* 0 -> a, 0 -> b, 0 -> c - Clear registers a, b and c (01 1010 0000) */
+            if (h_processor->trace) fprintf(stdout, "clrabc\t\t");
+            h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+            v_reg_copy(h_processor, h_processor->reg[A_REG], NULL);
+            v_reg_copy(h_processor, h_processor->reg[B_REG], NULL);
+            v_reg_copy(h_processor, h_processor->reg[C_REG], NULL);
+            if (h_processor->trace)
+            {
+               v_fprint_register(stdout, h_processor->reg[A_REG]);
+               v_fprint_register(stdout, h_processor->reg[B_REG]);
+               v_fprint_register(stdout, h_processor->reg[C_REG]);
+            }
+            break;
+         case 0x07: /* c[6:3] -> pc - Branch using C register (01 1110 0000) */
+            if (h_processor->trace) fprintf(stdout, "goto c\t\t");
+            h_processor->pc = (((h_processor->reg[C_REG]->nibble[6])<< 12) |
+               (h_processor->reg[C_REG]->nibble[5] << 8) |
+               (h_processor->reg[C_REG]->nibble[4] << 4) |
+               (h_processor->reg[C_REG]->nibble[3]));
+            break;
+         case 0x08: /* keys -> c[4:3] - Load c from keys (10 0010 0000) */
+            if (h_processor->trace) fprintf(stdout, "c = keys\t\t");
+            h_processor->reg[C_REG]->nibble[3] = h_processor->code & 0xf;
+            h_processor->reg[C_REG]->nibble[4] = (h_processor->code >> 4) & 0xf;
+            if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
+            break;
+         case 0x09: /* 0 -> decimal - Set hex mode(10 0110 0000) */
+            if (h_processor->trace) fprintf(stdout, "sethex");
+            h_processor->base = 16;
+            break;
+         case 0x0a: /* 1 -> decimal - Set decimal mode (10 0110 0000) */
+            if (h_processor->trace) fprintf(stdout, "setdec");
+            h_processor->base = 10;
+            break;
+         case 0x0b: /* 0 -> display - Display off (10 1110 0000) */
+            if (h_processor->trace) fprintf(stdout, "disoff");
+            h_processor->flags[DISPLAY_ENABLE] = False;
+            break;
+         case 0x0c: /* ~display -> display - Display toggle (10 1110 0000) */
+            if (h_processor->trace) fprintf(stdout, "distog");
+            h_processor->flags[DISPLAY_ENABLE] = !h_processor->flags[DISPLAY_ENABLE];
+            break;
+         case 0x0d: /* if carry stack[0] -> pc, stack[1] -> stack[0], stack[2] -> stack[1], stack[3] -> stack[2], 0 -> stack[3] - Return if carry (11 0110 0000) */
+            if (h_processor->trace) fprintf(stdout, "rtn c");
+            if (h_processor->flags[PREV_CARRY])
+            {
+               h_processor->sp = (h_processor->sp - 1) & (STACK_SIZE - 1); /* Update stack pointer */
+               h_processor->pc = h_processor->stack[h_processor->sp]; /* Pop program counter from the stack */
+            }
+            break;
+         case 0x0e: /* if !carry stack[0] -> pc, stack[1] -> stack[0], stack[2] -> stack[1], stack[3] -> stack[2], 0 -> stack[3] - Return if no carry (11 1010 0000) */
+            if (h_processor->trace) fprintf(stdout, "rtn nc");
+            if (!h_processor->flags[PREV_CARRY])
+            {
+               h_processor->sp = (h_processor->sp - 1) & (STACK_SIZE - 1); /* Update stack pointer */
+               h_processor->pc = h_processor->stack[h_processor->sp]; /* Pop program counter from the stack */
+            }
+            break;
+         case 0x0f: /* stack[0] -> pc, stack[1] -> stack[0], stack[2] -> stack[1], stack[3] -> stack[2], 0 -> stack[3] - Return (11 1110 0000) */
+            if (h_processor->trace) fprintf(stdout, "rtn");
+            h_processor->sp = (h_processor->sp - 1) & (STACK_SIZE - 1); /* Update stack pointer */
+            h_processor->pc = h_processor->stack[h_processor->sp]; /* Pop program counter from the stack */
+            break;
+         default:
+            if (h_processor->trace) fprintf(stdout, "\n");
+            debug(fprintf(stderr,"%02x\n", (i_opcode >> 6) & 0xf));
+            v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         break;
+      case 0x0a: /* {addr[11:4], nnnn} -> addr, c -> reg[addr] - Load register from c (nn nn10 1000) */
+         if (h_processor->trace) fprintf(stdout, "regn = c %-2d", (i_opcode >> 6));
+         h_processor->addr = (h_processor->addr & 0xff0) | (i_opcode >> 6);
+         h_processor->first = 0;
+         h_processor->last = REG_SIZE - 1;
+         if ((i_register = i_translate_addr(h_processor->addr)) >= 0) /* Ignore non existent registers */
+         {
+            v_reg_copy(h_processor, h_processor->mem[i_register], h_processor->reg[C_REG]);
+            if (h_processor->trace) v_fprint_register(stdout, h_processor->mem[i_register]);
+         }
+         break;
+      case 0x0c:
+         switch ((i_opcode >> 6) & 0xf)
+         {
+         case 0x00: /* display blink- Display blink (00 0011 0000) */
+            if (h_processor->trace) fprintf(stdout, "blink\t\t");
+            h_processor->flags[DISPLAY_ENABLE] = True;
+            break;
+         case 0x01: /* c -> n - Load n from c (00 0111 0000) */
+            if (h_processor->trace) fprintf(stdout, "n = c\t\t");
+            h_processor->first = 0;
+            h_processor->last = REG_SIZE - 1;
+            v_reg_copy(h_processor, h_processor->reg[N_REG], h_processor->reg[C_REG]);
+            if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[N_REG]);
+            break;
+         case 0x02: /* n -> c - Load C from N (00 1011 0000) */
+            if (h_processor->trace) fprintf(stdout, "c = n\t\t");
+            h_processor->first = 0;
+            h_processor->last = REG_SIZE - 1;
+            v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->reg[N_REG]);
+            if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
+            break;
+         case 0x03: /* c -> n, n-> c - Exchange c and n (00 1111 0000) */
+            h_processor->first = 0;
+            h_processor->last = REG_SIZE - 1;
+            if (h_processor->trace) fprintf(stdout, "cnex\t\t");
+            v_reg_exch(h_processor, h_processor->reg[N_REG], h_processor->reg[C_REG]);
+            if (h_processor->trace)
+            {
+               v_fprint_register(stdout, h_processor->reg[C_REG]);
+               v_fprint_register(stdout, h_processor->reg[N_REG]);
+            }
+         break;
+         case 0x04: /* rom[pc++] -> c[2:0] - Load immediate (01 0011 0000) */
+            {
+               int i_next;
+               i_next = h_processor->rom[h_processor->pc]; /* Get next opcode */
+               h_processor->reg[C_REG]->nibble[2] = (i_next >> 8) & 0xf;
+               h_processor->reg[C_REG]->nibble[1] = (i_next >> 4) & 0xf;
+               h_processor->reg[C_REG]->nibble[0] = i_next & 0xf;
+               if (h_processor->trace)
+               {
+                  fprintf(stdout, "ldi\n");
+                  fprintf(stdout, h_msg_opcode, (h_processor->pc >> 12), (h_processor->pc & 0x0fff), h_processor->rom[h_processor->pc]);
+                  fprintf(stdout,"  ");
+                  fprintf(stdout, h_msg_address, i_next);
+                  fprintf(stdout, "\t\t");
+                  v_fprint_register(stdout, h_processor->reg[C_REG]);
+               }
+               v_op_inc_pc(h_processor); /* Increment program counter */
+            }
+            break;
+         case 0x05: /* stack[2] -> stack[3], stack[1] -> stack[2], stack[0] -> stack[1], c -> stack[0] - Push c[6:3] onto the stack (01 0111 0000) */
+            if (h_processor->trace) fprintf(stdout, "stk = c\t\t");
+            h_processor->stack[h_processor->sp] = (h_processor->reg[C_REG]->nibble[6] << 12) | (h_processor->reg[C_REG]->nibble[5] << 8) | (h_processor->reg[C_REG]->nibble[4] << 4) | (h_processor->reg[C_REG]->nibble[3]);
+            h_processor->sp = (h_processor->sp + 1) & (STACK_SIZE - 1); /* Update stack pointer */
+            break;
+         case 0x06: /* stack[2] -> stack[3], stack[1] -> stack[2], stack[0] -> stack[1], c -> stack[0] - Pop c[6:3] from the stack (01 0111 0000) */
+            if (h_processor->trace) fprintf(stdout, "c = stk\t\t");
+            h_processor->sp = (h_processor->sp - 1) & (STACK_SIZE - 1); /* Update stack pointer */
+            h_processor->reg[C_REG]->nibble[3] = h_processor->stack[h_processor->sp] & 0xf;
+            h_processor->reg[C_REG]->nibble[4] = (h_processor->stack[h_processor->sp] >> 4) & 0xf;
+            h_processor->reg[C_REG]->nibble[5] = (h_processor->stack[h_processor->sp] >> 8) & 0xf;
+            h_processor->reg[C_REG]->nibble[6] = (h_processor->stack[h_processor->sp] >> 12) & 0xf;
+            break;
+         case 0x09: /* {addr[11:4], nnnn} -> addr, c -> reg[addr] - Load register address from c (10 0111 1000) */
+               if (h_processor->trace) fprintf(stdout, "dadd = c\t\t");
+               h_processor->addr = ((h_processor->reg[C_REG]->nibble[2] << 8) |
+                  (h_processor->reg[C_REG]->nibble[1] << 4) |
+                  (h_processor->reg[C_REG]->nibble[0])) & 0x3ff; /* Load 12 bit address into address register from c */
+               if (h_processor->trace) fprintf(stdout, "addr = %d", h_processor->addr);
+            break;
+         case 0x0b: /* data = c - Load register from c (10 1111 0000) */
+            if (h_processor->trace) fprintf(stdout, "data = c\t\t");
+            if ((i_register = i_translate_addr(h_processor->addr)) >= 0)
+            {
+               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+               v_reg_copy(h_processor, h_processor->mem[i_register], h_processor->reg[C_REG]);
+               if (h_processor->trace) v_fprint_register(stdout, h_processor->mem[i_register]);
+            }
+            break;
+         case 0x0c: /* c[6:3] -> addr, ram[addr] -> c[2:0] - Exchange c and memory (11 0011 0000) */
+            if (h_processor->trace) fprintf(stdout, "cxisa\t\t");
+            {
+               int i_addr;
+               i_addr = (((h_processor->reg[C_REG]->nibble[6])<< 12) | (h_processor->reg[C_REG]->nibble[5] << 8) |
+                  (h_processor->reg[C_REG]->nibble[4] << 4) | (h_processor->reg[C_REG]->nibble[3]));
+               if (i_addr >= ROM_SIZE) /* Don't read past the end of the ROM */
+                  {
+                     if (h_processor->trace) fprintf(stdout, "\n");
+                     v_error(h_err_invalid_address, i_addr, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+                  }
+               else
+               {
+                  h_processor->reg[C_REG]->nibble[2] = (h_processor->rom[i_addr] >> 8) & 0xf;
+                  h_processor->reg[C_REG]->nibble[1] = (h_processor->rom[i_addr] >> 4) & 0xf;
+                  h_processor->reg[C_REG]->nibble[0] = (h_processor->rom[i_addr]) & 0xf;
+               }
+            }
+            if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
+            break;
+         case 0x0d: /* c | a -> c - Load c with c or a (11 0111 0000) */
+            if (h_processor->trace) fprintf(stdout, "c = c or a\t\t");
+            h_processor->first = 0;
+            h_processor->last = REG_SIZE - 1;
+            v_reg_or(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], h_processor->reg[A_REG]);
+            if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
+            break;
+         case 0x0e: /* c | a -> c - Load c with c and a (11 0111 0000) */
+            if (h_processor->trace) fprintf(stdout, "c = c and a");
+            h_processor->first = 0;
+            h_processor->last = REG_SIZE - 1;
+            v_reg_and(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], h_processor->reg[A_REG]);
+            if (h_processor->trace) v_fprint_register(stdout, h_processor->reg[C_REG]);
+            break;
+
+         default:
+            if (h_processor->trace) fprintf(stdout, "\n");
+            debug(fprintf(stderr,"%02x\n", (i_opcode >> 6) & 0xf));
+            v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         break;
+      case 0x0e: /* {addr[11:4], nnnn} -> addr, reg[addr] -> c - Load c from register (nn nn11 1000) */
+         if (i_opcode >> 6)
+         {
+            if (h_processor->trace) fprintf(stdout, "c = regn %-2d", i_opcode >> 6);
+            h_processor->addr = (h_processor->addr & 0xff0) | (i_opcode >> 6);
+         }
+         else
+            if (h_processor->trace) fprintf(stdout, "c = data\t\t");
+         h_processor->first = 0;
+         h_processor->last = REG_SIZE - 1;
+         if ((i_register = i_translate_addr(h_processor->addr)) >= 0)
+            v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->mem[i_register]);
+         else
+            v_reg_copy(h_processor, h_processor->reg[C_REG], NULL); /* Return zeros if memory doesnt' exist */
+         if (h_processor->trace)
+         {
+            v_fprint_register(stdout,h_processor->reg[C_REG]);
+            fprintf(stdout, "\taddr = %d", h_processor->addr);
+         }
+         break;
+      case 0x0f: /* Rotate c register right (dddd 1111 00) */
+         if (h_processor->trace) fprintf(stdout, "rcr %-3d\t\t", n_map_i[i_opcode >> 6]);
+         {
+            int i_count; ;
+            for (i_count = n_map_i[i_opcode >> 6]; i_count > 0; i_count--)
+            {
+               int c_temp, i_count;
+               c_temp = h_processor->reg[C_REG]->nibble[0];
+               for (i_count = 0; i_count < REG_SIZE; i_count++)
+                  h_processor->reg[C_REG]->nibble[i_count] = h_processor->reg[C_REG]->nibble[i_count + 1];
+               h_processor->reg[C_REG]->nibble[REG_SIZE - 1] = c_temp;
+               h_processor->flags[PREV_CARRY] = h_processor->flags[CARRY] = False;
+            }
+         }
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+
+      default:
+         if (h_processor->trace) fprintf(stdout, "\n");
+         debug(fprintf(stderr,"%02x\n", (i_opcode >> 2) & 0xf));
+         v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+      }
+      break;
+
+   case 01: /* Type 1 - Branch instruction (two words) */
+      {
+         int i_address, i_next;
+         i_address = i_opcode >> 2;
+         i_next = h_processor->rom[h_processor->pc]; /* Get next opcode */
+         i_address |= ((i_next & 0x3fc) << 6);
+         if (h_processor->trace)
+         {
+            switch (i_next & 0x3)
+            {
+            case 0x0:
+               fprintf(stdout, "? nc gsb\t\t");
+               break;
+            case 0x1:
+               fprintf(stdout, "? c gsb\t\t");
+               break;
+            case 0x2:
+               fprintf(stdout, "? nc goto\t\t");
+               break;
+            case 0x3:
+               fprintf(stdout, "? c goto\t\t");
+               break;
+            }
+            fprintf(stdout, "\n");
+            fprintf(stdout, h_msg_opcode, (h_processor->pc >> 12), (h_processor->pc & 0x0fff), h_processor->rom[h_processor->pc]);
+            fprintf(stdout,"  ");
+            fprintf(stdout, h_msg_address, i_address);
+         }
+         h_processor->flags[CARRY] = h_processor->flags[PREV_CARRY]; /* Save carry */
+         v_op_inc_pc(h_processor); /* Increment program counter */
+         switch (i_next & 0x3)
+         {
+         case 0x0: /* if no carry then stack[2] -> stack[3], stack[1] -> stack[2], stack[0] -> stack[1], pc -> stack[0], a -> pc - Branch to subroutine on no carry (aa aaaa aa00, aa aaaa aa00) */
+            if (i_address < ROM_SIZE) /* Check that the target address exists otherwise treat as a 'nop' */
+               if (!h_processor->flags[PREV_CARRY]) op_jsb(h_processor, i_address);
+            break;
+         case 0x1: /* if carry then stack[2] -> stack[3], stack[1] -> stack[2], stack[0] -> stack[1], pc -> stack[0], a -> pc - Branch to subroutine on no carry (aa aaaa aa00, aa aaaa aa01) */
+            if (i_address < ROM_SIZE) /* Check that the target address exists otherwise treat as a 'nop' */
+               if (h_processor->flags[PREV_CARRY]) op_jsb(h_processor, i_address);
+            break;
+         case 0x2:  /* if no carry then a -> pc - Branch on no carry (aa aaaa aa00, aa aaaa aa10) */
+            if (!h_processor->flags[PREV_CARRY])
+               h_processor->pc = i_address;
+            break;
+         case 0x3: /* if carry then a -> pc - Branch on carry (aa aaaa aa00, aa aaaa aa11) */
+            if (h_processor->flags[PREV_CARRY])
+               h_processor->pc = i_address;
+            break;
+         }
+      }
+      break;
+
+   case 0x02: /* Type 2 - Arithmetic operations */
+      i_field = (i_opcode >> 2) & 7;
+      switch (i_field) /* Select field
+         000   R  : determined by active pointer            [R]
+         001 S+X  : exponent and sign                       [0 .. 2]
+         010  WR  : word up to and including active pointer [0 ..  P]
+         011   W  : word                                    [0 .. 13]
+         100 P-Q  : word from P up to and including Q       [P .. Q]
+         101  XS  : exponent sign only                      [2]
+         110   M  : mantissa                                [3 .. 12]
+         111   S  : sign                                    [13] */
+      {
+      case 00: /* Active pointer */
+         s_field = "pt";
+         if (h_processor->ptr)
+            h_processor->first = h_processor->last = h_processor->q;
+         else
+            h_processor->first = h_processor->last = h_processor->p;
+         if (h_processor->p >= REG_SIZE || h_processor->q >= REG_SIZE)
+         {
+            if (h_processor->trace) fprintf(stdout, "\n");
+            v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         break;
+      case 01: /* Exponent and sign */
+         s_field = "x";
+         h_processor->first = 0; h_processor->last = EXP_SIZE - 1;
+         break;
+      case 02: /* Word up to the active pointer */
+         s_field = "wpt";
+         h_processor->first =  0;
+         if (h_processor->ptr)
+            h_processor->last = h_processor->q;
+         else
+            h_processor->last = h_processor->p;
+         if (h_processor->p >= REG_SIZE || h_processor->q >= REG_SIZE)
+         {
+            if (h_processor->trace) fprintf(stdout, "\n");
+            v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         break;
+      case 03: /* All nibbles in the word */
+         s_field = "all";
+         h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+         break;
+      case 04: /* Selects range based on pointers */
+         s_field = "pq";
+         h_processor->first = h_processor->p;
+         if (h_processor->p > h_processor->q)
+            h_processor->last = REG_SIZE - 1;
+         else
+            h_processor->last = h_processor->q;
+         if (h_processor->p >= REG_SIZE || h_processor->q >= REG_SIZE)
+         {
+            if (h_processor->trace) fprintf(stdout, "\n");
+            v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         break;
+      case 05: /* XS */
+         s_field = "xs";
+         h_processor->first = EXP_SIZE - 1; h_processor->last = EXP_SIZE - 1;
+         break;
+      case 06: /* M */
+         s_field = "m";
+         h_processor->first = EXP_SIZE; h_processor->last = REG_SIZE - 2;
+         break;
+      case 07: /* S */
+         s_field = "s";
+         h_processor->first = REG_SIZE - 1; h_processor->last = REG_SIZE - 1;
+         break;
+      }
+
+      switch (i_opcode >> 5)
+      {
+      case 0x00: /* 0 -> a[f] - Clear a (00 000f ff10) */
+         if (h_processor->trace) fprintf(stdout, "a = 0 %s\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[A_REG], NULL);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 0x01: /* 0 -> b[f] - Clear b (00 001f ff10) */
+         if (h_processor->trace)fprintf(stdout, "b = 0 %s\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[B_REG], NULL);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
+         break;
+      case 0x02: /* 0 -> c[f] - Clear c (00 010f ff10) */
+         if (h_processor->trace) fprintf(stdout, "c = 0 %s\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[C_REG], NULL);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 0x03: /* a exch b[f] - Exchange a and b (00 011f ff10) */
+         if (h_processor->trace) fprintf(stdout, "abex %s\t\t", s_field);
+         v_reg_exch(h_processor, h_processor->reg[A_REG], h_processor->reg[B_REG]);
+         if (h_processor->trace)
+         {
+            v_fprint_register(stdout,h_processor->reg[A_REG]);
+            v_fprint_register(stdout,h_processor->reg[B_REG]);
+         }
+         break;
+      case 0x04: /* a -> b[f] - Load b from a (00 100f ff10) */
+         if (h_processor->trace) fprintf(stdout, "b = a %s\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[B_REG], h_processor->reg[A_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
+         break;
+      case 0x05: /* a exch c[f] - Exchange a and c (00 101f ff10) */
+         if (h_processor->trace) fprintf(stdout, "acex %s\t\t", s_field);
+         v_reg_exch(h_processor, h_processor->reg[A_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace)
+         {
+            v_fprint_register(stdout,h_processor->reg[A_REG]);
+            v_fprint_register(stdout,h_processor->reg[C_REG]);
+         }
+         break;
+      case 0x06: /* b -> c[f] - Load c from b (00 110f ff10) */
+         if (h_processor->trace) fprintf(stdout, "c = b %s\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->reg[B_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 0x07: /* b exch c[f] - Exchange b and c (00 111f ff10) */
+         if (h_processor->trace) fprintf(stdout, "bcex %s\t\t", s_field);
+         v_reg_exch(h_processor, h_processor->reg[B_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace)
+         {
+            v_fprint_register(stdout,h_processor->reg[B_REG]);
+            v_fprint_register(stdout,h_processor->reg[C_REG]);
+         }
+         break;
+      case 0x08: /* c -> a[f] - Load a from c (01 000f ff10) */
+         if (h_processor->trace) fprintf(stdout, "a = c %-3s\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[A_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 0x09: /* a + b -> a[f] - Load a with a plus b (01 001f ff10) */
+         if (h_processor->trace) fprintf(stdout, "a = a + b %-3s", s_field);
+         v_reg_add(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[B_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 0x0a: /* a + c -> a[f] - Load a with a plus c (01 010f ff10) */
+         if (h_processor->trace) fprintf(stdout, "a = a + c %-3s", s_field);
+         v_reg_add(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 0x0b: /* a + 1 -> a[f] - Load a with a plus 1 (01 011f ff10) */
+         if (h_processor->trace) fprintf(stdout, "a = a + 1 %-3s", s_field);
+         v_reg_inc(h_processor, h_processor->reg[A_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 0x0c: /* a - b -> a[f] - Load a with a minus b (01 100f ff10) */
+         if (h_processor->trace) fprintf(stdout, "a = a - b %-3s", s_field);
+         v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[B_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 0x0d: /* a - 1 -> a[f] - Load a with a minus 1 (01 101f ff10) */
+         if (h_processor->trace) fprintf(stdout, "a = a - 1 %-3s", s_field);
+         h_processor->flags[CARRY] = True; /* Set carry */
+         v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], NULL);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 0x0e: /* a - c -> a[f] - Load a with a minus c (01 110f ff10) */
+         if (h_processor->trace) fprintf(stdout, "a = a - c %-3s", s_field);
+         v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 0x0f: /* c + c -> c[f] - Load c with c plus c (01 111f ff10) */
+         if (h_processor->trace) fprintf(stdout, "c = c + c %-3s", s_field);
+         v_reg_add(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 0x10: /* a + c -> c[f] - Load c with a plus c (10 000f ff10) */
+         if (h_processor->trace) fprintf(stdout, "c = c + a %-3s", s_field);
+         v_reg_add(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], h_processor->reg[A_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 0x11: /* c + 1 -> c[f] - Load c with c plus 1 (10 001f ff10) */
+         if (h_processor->trace) fprintf(stdout, "c = c + 1 %-3s", s_field);
+         v_reg_inc(h_processor, h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 0x12: /* c - a -> c[f] - Load c with c minus a (10 010f ff10) */
+         if (h_processor->trace) fprintf(stdout, "c = a - c %-3s", s_field);
+         v_reg_sub(h_processor, h_processor->reg[C_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 0x13: /* c - 1 -> c[f] - Load c with c minus 1 (10 011f ff10) */
+         if (h_processor->trace) fprintf(stdout, "c = c - 1 %-3s", s_field);
+         h_processor->flags[CARRY] = True; /* Set carry */
+         v_reg_sub(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], NULL);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 0x14: /* 0 - c -> c f - Load c with 0 minus c (10 100f ff10) */
+         if (h_processor->trace) fprintf(stdout, "c = 0 - c %-3s", s_field);
+         v_reg_sub(h_processor, h_processor->reg[C_REG], NULL, h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 0x15: /* 0 - c - 1 -> c[f] - Complement c (10 101f ff10) */
+         if (h_processor->trace) fprintf(stdout, "c = - c - 1 %-3s", s_field);
+         h_processor->flags[CARRY] = True; /* Set carry */
+         v_reg_sub(h_processor, h_processor->reg[C_REG], NULL, h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 0x16: /* ? b[f] != 0 - Test b not equal to zero (10 110f ff10) */
+         if (h_processor->trace) fprintf(stdout, "? b != 0 %-3s", s_field);
+         v_reg_test_ne(h_processor, h_processor->reg[B_REG], NULL);
+         break;
+      case 0x17: /* ? c != 0 - Test c not equal to zero (10 111f ff10) */
+         if (h_processor->trace) fprintf(stdout, "? c != 0 %-3s", s_field);
+         v_reg_test_ne(h_processor, h_processor->reg[C_REG], NULL);
+         break;
+      case 0x18: /* ? a < c - Test a less than c (11 000f ff10) */
+         if (h_processor->trace) fprintf(stdout, "? a < c %-3s", s_field);
+         v_reg_sub(h_processor, NULL, h_processor->reg[A_REG], h_processor->reg[C_REG]);/* Less than */
+         break;
+      case 0x19: /* ? a < b - Test a less than b (11 001f ff10) */
+         if (h_processor->trace) fprintf(stdout, "? a < b %-3s", s_field);
+         v_reg_sub(h_processor, NULL, h_processor->reg[A_REG], h_processor->reg[B_REG]); /* Less than */
+         break;
+      case 0x1a: /* ? a != 0 - Test a not equal to zero  (11 010f ff10) */
+         if (h_processor->trace) fprintf(stdout, "? a != 0 %-3s", s_field);
+         v_reg_test_ne(h_processor, h_processor->reg[A_REG], NULL);
+         break;
+      case 0x1b: /* ? a != c - Test a not equal to c (11 011f ff10) */
+         if (h_processor->trace) fprintf(stdout, "? a != c %-3s", s_field);
+         v_reg_test_ne(h_processor, h_processor->reg[A_REG], h_processor->reg[C_REG]);
+         break;
+      case 0x1c: /* a >> 1 -> a[f] - Shift right a (11 100f ff10) */
+         if (h_processor->trace) fprintf(stdout, "shr a %s\t\t", s_field);
+         v_reg_shr(h_processor, h_processor->reg[A_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 0x1d: /* b >> 1 -> b[f] - Shift right b (11 101f ff10) */
+         v_reg_shr(h_processor, h_processor->reg[B_REG]);
+         if (h_processor->trace) fprintf(stdout, "shr b %s\t\t", s_field);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
+         break;
+      case 0x1e: /* c >> 1 -> c[f] - Shift right c (11 110f ff10) */
+         if (h_processor->trace) fprintf(stdout, "shr c %s\t\t", s_field);
+         v_reg_shr(h_processor, h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 0x1f: /* a << 1 -> a[f] - Shift left a (11 111f ff10) */
+         if (h_processor->trace) fprintf(stdout, "shl a %s\t\t", s_field);
+         fflush(stdout);
+         v_reg_shl(h_processor, h_processor->reg[A_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      default:
+         if (h_processor->trace) fprintf(stdout, "\n");
+         v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+      }
+      break;
+
+   case 03:/* Type 3 - Conditional branch */
+      switch (i_opcode & 03)
+      {
+      case 00:
+         if (h_processor->trace) {fprintf(stdout, "call "); fprintf(stdout, h_msg_address, i_opcode >> 2);}
+         if (h_processor->trace) fprintf(stdout, "\n");
+         v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         break;
+      case 01:
+         if (h_processor->trace) {fprintf(stdout, "call "); fprintf(stdout, h_msg_address, i_opcode >> 2);}
+         if (h_processor->trace) fprintf(stdout, "\n");
+         v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         break;
+      case 02:
+         if (h_processor->trace) {fprintf(stdout, "jump "); fprintf(stdout, h_msg_address, i_opcode >> 2);}
+         if (h_processor->trace) fprintf(stdout, "\n");
+         v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         break;
+      case 03: /* Relative jump */
+         {
+            int i_offset;
+            i_offset = i_opcode >> 3;
+            if (i_offset >= 0x40) i_offset = i_offset - 128; /* Fixed relative jump offset */
+            if (i_opcode & 00004)
+            {
+               if (h_processor->trace) fprintf(stdout, "jc ");
+               if (h_processor->flags[PREV_CARRY])
+                  h_processor->pc = ((i_last + i_offset) & 0xffff);
+            }
+            else
+            {
+               if (h_processor->trace) fprintf(stdout, "jnc ");
+               if (!h_processor->flags[PREV_CARRY])
+                  h_processor->pc = ((i_last + i_offset) & 0xffff);
+            }
+            if (h_processor->trace)
+            {
+               if (i_offset < 0)
+                  fprintf(stdout, h_msg_negative_offset, abs(i_offset));
+               else
+                  fprintf(stdout, h_msg_positive_offset , abs(i_offset));
+            }
+         }
+         break;
+      default:
+         if (h_processor->trace) fprintf(stdout, "\n");
+         v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+      }
+      break;
+   default:
+      if (h_processor->trace) fprintf(stdout, "\n");
+      v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+   }
+   if (h_processor->trace) fprintf(stdout, "\n");
+   h_processor->opcode = i_opcode; /* Keep track of the previous opcode so you know when to increment 'P' */
+}
+#endif
@@ -0,0 +1,1106 @@
+/*
+ * x11-calc-woodstock.c - RPN (Reverse Polish) calculator simulator.
+ *
+ * Copyright(C) 2018   MT
+ *
+ * Woodstock processor simulator.
+ *
+ * Decodes  and  executes  the instructions  used  by  the  Woodstock
+ * series (HP10, HP21, HP22, HP25, HP25C, HP27, HP29C, HP67 and
+ * the Spice series).
+ *
+ * This  program is free software: you can redistribute it and/or modify it
+ * under  the terms of the GNU General Public License as published  by  the
+ * Free  Software Foundation, either version 3 of the License, or (at  your
+ * option) any later version.
+ *
+ * This  program  is distributed in the hope that it will  be  useful,  but
+ * WITHOUT   ANY   WARRANTY;   without even   the   implied   warranty   of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details.
+ *
+ * You  should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * 17 Oct 26         - Initial version (moved from x11-calc-cpu.c) - MT
+ *                   - Counts  writes to the A register that don't use the
+ *                     register operations - MT
+ *                   - Uses the ROM page table to increment the  program
+ *                     counter and select the ROM bank - MT
+ *                   - Implemented  the HP67 card reader  motor,  read  and
+ *                     write modes, and data register - MT
+ *
+ */
+
+#define NAME           "x11-calc-woodstock"
+#define VERSION        "0.1"
+#define BUILD          "0001"
+#define DATE           "17 Oct 26"
+#define AUTHOR         "MT"
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+
+#include "x11-calc-font.h"
+#include "x11-calc-label.h"
+#include "x11-calc-switch.h"
+#include "x11-calc-button.h"
+
+#include "x11-calc-cpu.h"
+#include "x11-calc-arena.h"
+
+#include "x11-calc-messages.h"
+
+#include "gcc-debug.h" /* print() */
+#include "gcc-wait.h"  /* i_wait() */
+
+#if defined(WOODSTOCK) || defined(SPICE) || defined(HP10) || defined(HP67)
+
+static void v_op_inc_p(oprocessor *h_processor) /* Increment p register */
+{
+#if defined(HP10) || defined(HP31e) || defined(HP32e) || defined(HP33e) || defined(HP33c) || defined(HP34c) || defined(HP37e) || defined(HP38e) || defined(HP38c) || defined(HP67)
+   if (h_processor->p == REG_SIZE - 1)
+      h_processor->p = 0;
+   else
+   {
+      if (h_processor->p > 0)
+         h_processor->p++;
+      else
+      {
+         if (h_processor->opcode != h_processor->rom[h_processor->pc - 1]) /* Literally the only way to work out */
+            h_processor->p++; /* if 'P' should be incremented when it is zero is to check the previous opcode !! */
+      }
+   }
+#else
+   if (h_processor->p == REG_SIZE) h_processor->p = 0; else h_processor->p++;
+#endif
+}
+
+static void v_op_dec_p(oprocessor *h_processor) /* Decrement p register */
+{
+   if (h_processor->p == 0) h_processor->p = REG_SIZE - 1; else h_processor->p--;
+}
+
+static void v_op_inc_pc(oprocessor *h_processor) /* Increment program counter */
+{
+   h_processor->pc = h_processor->next[h_processor->pc / ROM_PAGE][((h_processor->pc % ROM_PAGE) + 1) / ROM_PAGE] | ((h_processor->pc + 1) % ROM_PAGE); /* Wraps round at the end of each bank and the end of memory */
+   h_processor->flags[PREV_CARRY] = h_processor->flags[CARRY];
+   h_processor->flags[CARRY] = False;
+}
+
+static void v_delayed_rom(oprocessor *h_processor) /* Delayed ROM select */
+{
+   if (h_processor->flags[DELAYED_ROM])
+   {
+      h_processor->pc = (h_processor->rom_number << 8 | (h_processor->pc & 0xf0ff));
+      h_processor->flags[DELAYED_ROM] = False; /* Clear flag */
+   }
+   h_processor->pc = h_processor->page[h_processor->pc / ROM_PAGE] | (h_processor->pc % ROM_PAGE); /* The first ROM chip is mapped to all ROM banks, access implies a switch to bank 0 */
+}
+
+void op_jsb(oprocessor *h_processor, int i_address) /* Jump to subroutine */
+{
+   h_processor->stack[h_processor->sp] = h_processor->pc; /* Push current address on the stack */
+   h_processor->sp = (h_processor->sp + 1) & (STACK_SIZE - 1); /* Update stack pointer */
+   h_processor->pc = ((h_processor->pc & 0xff00) | i_address); /* Note - Uses an eight bit address */
+   v_delayed_rom(h_processor);
+}
+
+void v_op_goto(oprocessor *h_processor) /* Conditional go to */
+{
+   if (h_processor->trace)
+   {
+      fprintf(stdout, "\n"); fprintf(stdout,h_msg_opcode, (h_processor->pc >> 12), (h_processor->pc & 0x0fff), h_processor->rom[h_processor->pc]);
+      fprintf(stdout,"  then go to ");
+   }
+   h_processor->flags[PREV_CARRY] = h_processor->flags[CARRY];
+   h_processor->flags[CARRY] = False;
+   if (h_processor->trace) fprintf(stdout, h_msg_address, ((h_processor->pc & 0xc00) | h_processor->rom[h_processor->pc] )); /* Mask off the bank number and least significant 10 bits */
+   if (h_processor->flags[PREV_CARRY])  /* Do if True */
+      h_processor->pc = ((h_processor->pc & 0xfc00) | h_processor->rom[h_processor->pc]); /* Use a _ten_ bit address */
+   else
+      v_op_inc_pc(h_processor);
+}
+
+void v_processor_execute(oprocessor *h_processor) /* Decode and execute a single instruction */
+{
+   static const int i_set_p[16] = { 14,  4,  7,  8, 11,  2, 10, 12,  1,  3, 13,  6,  0,  9,  5, 14 };
+   static const int i_tst_p[16] = { 4 ,  8, 12,  2,  9,  1,  6,  3,  1, 13,  5,  0, 11, 10,  7,  4 };
+
+   unsigned int i_last; /* Save the current PC */
+   unsigned int i_opcode;
+   unsigned int i_field; /* Field modifier */
+   const char *s_field; /* Holds pointer to field name */
+
+#if defined(HP21) || defined(HP22) || defined(HP25) || defined(HP25c) || defined(HP27) || defined(HP29c)
+   if (h_processor->keypressed) h_processor->status[15] = True; /* Set status bit if key pressed */
+   if (h_processor->mode) h_processor->status[3] = True; /* Set status bits based on switch position */
+   h_processor->status[5] = True; /* Low Power */
+#endif
+
+#if defined(HP67) /* Seems to use a flag rather then the status word for the switch position */
+   if (h_processor->keypressed) h_processor->status[15] = True; /* Set status bit 15 if key pressed */
+   h_processor->flags[MODE] = h_processor->mode; /* Set the program mode flag based on switch position */
+#endif
+
+#if defined(HP31e) || defined(HP32e) || defined(HP33e) || defined(HP33c) || defined(HP34c) || defined(HP37e) || defined(HP38e) || defined(HP38c) /* Setting S(5) breaks the self test */
+   if (h_processor->keypressed) h_processor->status[15] = True; /* Set status bit if key pressed */
+   if (h_processor->mode) h_processor->status[3] = True; /* Set status bits based on switch position */
+   h_processor->status[5] = False; /* Self Test */
+#endif
+
+   i_opcode = h_processor->rom[h_processor->pc]; /* Get next instruction */
+   i_last = h_processor->pc;
+   if (h_processor->trace)
+      fprintf(stdout, h_msg_opcode, (i_last >> 12), (i_last & 0x0fff), h_processor->rom[i_last]);
+   v_op_inc_pc(h_processor); /* Increment program counter _before_ decoding the opcode */
+   switch (i_opcode & 03)
+   {
+
+   case 00: /* Type 0 - Special operations */
+      switch ((i_opcode >> 2) & 03)
+      {
+      case 00: /* Op-Codes matching x xxx xx0 000 */
+         switch ((i_opcode >> 4) & 03)
+         {
+         case 00: /* Op-Codes matching x xxx 000 000 */
+            switch (i_opcode)
+            {
+            case 00000: /* nop */
+               if (h_processor->trace) fprintf(stdout, "nop");
+               break;
+#if defined(HP67)
+            /*
+             * 00100   Test ready
+             * 00300   Test W/PGM switch
+             * 00400   Set key pressed
+             * 00500   Test if a key was pressed
+             * 01000   Set default function keys
+             * 01100   Test if default function keys set
+             * 01200   Set merge flag
+             * 01300   Test merge flag
+             * 01400   Set waiting for card side 2 flag
+             * 01500   Test waiting for card side 2 flag
+             * 01700   Read/Write data to/from card via RAM $99 and $9B
+             */
+            case 00100: /* test ready */
+               if (h_processor->trace) fprintf(stdout, "test ready");
+               if (h_processor->crc[MOTOR] && h_processor->crc[CARD]) /* Ready while there is room to write, or data to read */
+                  h_processor->status[3] = (h_processor->crc[WRITE] ? (h_processor->word < CARD_WORDS) : (h_processor->word < h_processor->words));
+               else
+                  h_processor->status[3] = False;
+               break;
+            case 00300: /* test mode flag */
+               if (h_processor->trace) fprintf(stdout, "test mode flag (%d)", !h_processor->flags[MODE] );
+               h_processor->status[3] = !h_processor->flags[MODE]; /* Test the PRGM/RUN switch */
+               break;
+            case 00400: /* set key pressed flag */
+               if (h_processor->trace) fprintf(stdout, "set key pressed flag");
+               h_processor->crc[ANYKEY] = True; /* Sets the any key pressed flag */
+               break;
+            case 00500: /* test key pressed flag */ /* f -x- */
+               if (h_processor->trace) fprintf(stdout, "test key pressed flag");
+               h_processor->status[3] = h_processor->crc[ANYKEY];
+               if (h_processor->crc[ANYKEY]) h_processor->crc[ANYKEY] = False;
+               break;
+            case 01000: /* set default function flag */
+               if (h_processor->trace) fprintf(stdout, "set flag 4");
+               h_processor->crc[FUNCTION] = True;
+               break;
+            case 01100: /* test default function key flag */
+               if (h_processor->trace) fprintf(stdout, "test flag 4");
+               h_processor->status[3] = h_processor->crc[FUNCTION];
+               if (h_processor->crc[FUNCTION]) h_processor->crc[FUNCTION] = False;
+               break;
+            case 01200: /* set merge flag */
+               if (h_processor->trace) fprintf(stdout, "set merge flag");
+               h_processor->crc[MERGE] = True;
+               break;
+            case 01300: /* test merge flag */
+               if (h_processor->trace) fprintf(stdout, "clear flag 0");
+               h_processor->status[3] = h_processor->crc[MERGE];
+               if (h_processor->crc[MERGE]) h_processor->crc[MERGE] = False;
+               break;
+            case 01400: /* set waiting flag */
+               if (h_processor->trace) fprintf(stdout, "clear waiting flag");
+               h_processor->crc[PAUSE] = True;
+               break;
+            case 01500: /* test pause flag ? */
+               if (h_processor->trace) fprintf(stdout, "clear flag 1");
+               h_processor->status[3] = h_processor->crc[PAUSE];
+               if (h_processor->crc[PAUSE]) h_processor->crc[PAUSE] = False;
+               break;
+            case 01700: /* read from or write to card */
+               if (h_processor->trace) fprintf(stdout, "card read write");
+               if (h_processor->crc[MOTOR] && h_processor->crc[CARD])
+                  v_card_transfer(h_processor);
+               h_processor->status[3] = False;
+               break;
+#endif
+            default:
+               if (h_processor->trace) fprintf(stdout, "\n");
+               v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+            }
+            break;
+         case 01: /* Op-Codes matching x xxx 010 000 */
+            switch (i_opcode)
+            {
+            case 00020: /* keys -> rom address (0 000 010 000) */
+               if (h_processor->trace) fprintf(stdout, "keys -> rom address");
+               h_processor->pc &= 0xff00;
+               v_delayed_rom(h_processor);
+               h_processor->pc += h_processor->code;
+               break;
+            case 00120: /* keys -> a[2:1] (0 001 010 000) */
+               if (h_processor->trace) fprintf(stdout, "keys -> a\t\t");
+               /* The HP10 and HP19C use this to get the state of the printer mode switch */
+#if defined(HP10)
+               if (h_processor->print)
+                  h_processor->reg[A_REG]->nibble[1] = 0x1; /* HP10 - All = 1, Print = 2 (print with display off), Display = 4 */
+               else
+                  h_processor->reg[A_REG]->nibble[1] = 0x4; /* HP19C/97 - Trace = 1, Normal = 2 (print with display off), Manual = 4 */
+#else
+               h_processor->reg[A_REG]->nibble[2] = (h_processor->code >> 4); /* Put keycode in A_REG */
+               h_processor->reg[A_REG]->nibble[1] = (h_processor->code & 0x0f);
+#endif
+               h_processor->display++;
+               if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+               break;
+            case 00220: /* a -> rom address */
+               {
+                  int i_addr;
+                  if (h_processor->trace) fprintf(stdout, "a -> rom address");
+                  h_processor->pc &= 0x0ff00;
+                  i_addr = h_processor->pc + (h_processor->reg[A_REG]->nibble[2] << 4) + h_processor->reg[A_REG]->nibble[1];
+                  if (i_addr < ROM_SIZE)
+                      h_processor->pc = i_addr;
+                  else
+                  {
+                     if (h_processor->trace) fprintf(stdout, "\n");
+                     v_error(h_err_invalid_address, i_addr, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+                  }
+                  v_delayed_rom(h_processor);
+               }
+               break;
+            case 00320: /* reset twf */
+               if (h_processor->trace) fprintf(stdout, "reset twf");
+               break;
+            case 00420: /* binary */
+               if (h_processor->trace) fprintf(stdout, "binary");
+               h_processor->base = 16;
+               break;
+            case 00520: /* rotate left a */
+               if (h_processor->trace) fprintf(stdout, "rotate left a");
+               {
+                  int c_temp, i_count;
+                  c_temp = h_processor->reg[A_REG]->nibble[REG_SIZE - 1];
+                  for (i_count = REG_SIZE - 1; i_count > 0; i_count--)
+                     h_processor->reg[A_REG]->nibble[i_count] = h_processor->reg[A_REG]->nibble[i_count - 1];
+                  h_processor->reg[A_REG]->nibble[0] = c_temp;
+                  h_processor->display++;
+                  h_processor->flags[PREV_CARRY] = h_processor->flags[CARRY] = False;
+               }
+               break;
+            case 00620: /* p - 1 -> p */
+               if (h_processor->trace) fprintf(stdout, "p - 1 -> p\t\t\t");
+               v_op_dec_p(h_processor);
+               if (h_processor->trace) fprintf(stdout, "p = %d", h_processor->p);
+               break;
+            case 00720: /* p + 1 -> p */
+               if (h_processor->trace) fprintf(stdout, "p + 1 -> p\t\t\t");
+               v_op_inc_p(h_processor);
+               if (h_processor->trace) fprintf(stdout, "p = %d", h_processor->p);
+               break;
+            case 01020: /* return */
+               if (h_processor->trace) fprintf(stdout, "return");
+               h_processor->sp = (h_processor->sp - 1) & (STACK_SIZE - 1); /* Update stack pointer */
+               h_processor->pc = h_processor->stack[h_processor->sp]; /* Pop program counter from the stack */
+               break;
+#if defined(HP10)
+            case 01120: /* pik1120 */
+               if (h_processor->trace) fprintf(stdout, "pik1120\t\t");
+               v_fprint_buffer (stdout, h_processor);
+               h_processor->status[3] = True; /* Set status bit 3 if printer ready (it always will be!) */
+               if (h_processor->trace) v_fprint_status(stdout, h_processor);
+               break;
+            case 01220: /* pik1220 */
+               if (h_processor->trace) fprintf(stdout, "pik1220\t\t");
+               v_fprint_buffer (stdout, h_processor);
+               h_processor->status[3] = True; /* Clear status bit 3 if printer is out of paper */
+               if (h_processor->trace) v_fprint_status(stdout, h_processor);
+               break;
+            case 01320: /* pik1320 */
+               if (h_processor->trace) fprintf(stdout, "pik1320\t\t");
+               v_fprint_buffer (stdout, h_processor);
+               if (h_processor->keypressed && h_processor->code) h_processor->status[3] = True; /* Set status bit 3 if key is pressed and a key code is pending */
+               if (h_processor->trace) v_fprint_status(stdout, h_processor);
+               break;
+            case 01720: /* pik1720 print numeric (4 bit data)*/
+               if (h_processor->trace) fprintf(stdout, "pik1720\t\t");
+               if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+               if (h_processor->buffer[h_processor->position] == 0x3f) h_processor->position++;
+               {
+                  int i_count;
+                  for (i_count = 0; (i_count < REG_SIZE)  && (h_processor->reg[C_REG]->nibble[i_count] != 0xf); i_count++)
+                  {
+                     h_processor->position--;
+                     h_processor->buffer[h_processor->position] = (h_processor->reg[C_REG]->nibble[i_count] << 2) | 0x3;
+                  }
+               }
+               break;
+#endif
+            default:
+               if (h_processor->trace) fprintf(stdout, "\n");
+               v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+            }
+            break;
+         case 02: /* Op-Codes matching x xxx 100 000 */ /* select rom */
+            if (h_processor->trace) fprintf(stdout, "select rom %02o", i_opcode >> 6);
+            h_processor->pc = ((i_opcode >> 6) << 8) + ((h_processor->pc) & 0xff);
+            break;
+         case 03: /* Op-Codes matching x xxx 110 000 */
+            switch (i_opcode)
+            {
+#if defined(HP67)
+            /*
+             * 00060   Set display digits
+             * 00160   Test display digits
+             * 00260   Motor on
+             * 00360   Motor off
+             * 00560   Test if card inserted
+             * 00660   Set card write mode
+             * 00760   Set card read mode
+             */
+            case 00060: /* set display digits */
+               if (h_processor->trace) fprintf(stdout, "set display digits");
+               h_processor->crc[DISPLAY] = True;
+               break;
+            case 00160: /* test display digits */
+               if (h_processor->trace) fprintf(stdout, "test display digits");
+               h_processor->status[3] = h_processor->crc[DISPLAY];
+               if (h_processor->crc[DISPLAY]) h_processor->crc[DISPLAY] = False;
+               break;
+            case 00260: /* card reader motor on */
+               if (h_processor->trace) fprintf(stdout, "motor on");
+               h_processor->crc[MOTOR] = True;
+               break;
+            case 00360: /* card reader motor off */
+               if (h_processor->trace) fprintf(stdout, "motor off");
+               h_processor->crc[MOTOR] = False;
+               v_card_eject(h_processor); /* The card has passed through the reader */
+               break;
+            case 00560: /* test card inserted */
+               if (h_processor->trace) fprintf(stdout, "test card inserted");
+               h_processor->status[3] = h_processor->crc[CARD]; /* Test if card is inserted */
+               break;
+            case 00660: /* card reader set write mode */
+               if (h_processor->trace) fprintf(stdout, "set write mode");
+               h_processor->crc[WRITE] = True;
+               break;
+            case 00760: /* card reader set read mode */
+               if (h_processor->trace) fprintf(stdout, "set read mode");
+               h_processor->crc[WRITE] = False;
+               break;
+#endif
+            case 01060: /* bank switch */
+               if (h_processor->trace) fprintf(stdout, "bank switch");
+               h_processor->flags[BANK_SWITCH] = (!h_processor->flags[BANK_SWITCH]); /* Toggle bank switch */
+               h_processor->pc ^=  0x01000; /* Toggle bank */
+               break;
+            case 01160: /* c -> data address */
+               {
+                  int i_addr;
+                  if (h_processor->trace) fprintf(stdout, "c -> data address\t");
+                  i_addr = (h_processor->reg[C_REG]->nibble[1] << 4) + h_processor->reg[C_REG]->nibble[0];
+#if defined(HP10)
+                  if ((i_addr < MEMORY_SIZE) || (i_addr == 0xFF)) /* Address 0xFF tells the PIK chip to put the key code on the data bus */
+                     h_processor->addr = i_addr;
+                  else
+                  {
+                     h_processor->addr = MEMORY_SIZE - 1;
+                     if (h_processor->trace) fprintf(stdout, "\n");
+                     v_error(h_err_invalid_register, i_addr, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+                  }
+#else
+#if defined(HP67)
+                  if ((i_addr < MEMORY_SIZE) || (i_addr == CARD_DATA) || (i_addr == CARD_DATA + 2)) /* Addresses $99 and $9B select the card reader */
+#else
+                  if (i_addr < MEMORY_SIZE)
+#endif
+                     h_processor->addr = i_addr;
+                  else
+                  {
+                     h_processor->addr = MEMORY_SIZE - 1;
+                  }
+#endif
+               }
+               if (h_processor->trace) fprintf(stdout, "\taddr = %d", h_processor->addr);
+               break;
+            case 01260: /* clear data registers */
+               {
+#if (defined(HP25) || defined(HP25c)) && defined(CONTINIOUS)
+                  /* Ignore the instruction */
+#else
+                  int i_count;
+                  if (h_processor->trace) fprintf(stdout, "clear data registers");
+#if (defined(HP67)) && defined(CONTINIOUS)
+                  if (h_processor->crc[READY])
+                     h_processor->crc[READY]++;
+                  else
+#endif
+                  {
+                     h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+                     for (i_count = h_processor->addr & ~0x0f; i_count < (h_processor->addr & ~0x0f) + 16; i_count++)
+                     {
+                        if (i_count < MEMORY_SIZE) /* Check memory size */
+                           v_reg_copy(h_processor, h_processor->mem[i_count], NULL); /* Copying nothing to a register clears it */
+                     }
+                  }
+#endif
+               }
+               break;
+            case 01360: /* c -> data */
+               if (h_processor->trace) fprintf(stdout, "c -> data\t\t");
+               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+#if defined(HP67)
+               if (h_processor->addr >= MEMORY_SIZE) /* Card reader */
+               {
+                  v_reg_copy(h_processor, h_processor->card, h_processor->reg[C_REG]);
+                  if (h_processor->trace) v_fprint_register(stdout, h_processor->card);
+                  break;
+               }
+#endif
+               v_reg_copy(h_processor, h_processor->mem[h_processor->addr], h_processor->reg[C_REG]);
+               if (h_processor->trace)
+                  v_fprint_register(stdout, h_processor->mem[h_processor->addr]);
+               break;
+#if defined(HP10)
+            case 01660: /* pik1660 print alpha (6 bit data)*/
+               if (h_processor->trace) fprintf(stdout, "pik1660");
+               {
+                  int i_counter = 0;
+                  int i_count;
+                  for (i_count = 0; (i_count < REG_SIZE - 1) && (h_processor->position >= 0); i_count++)
+                  {
+                     h_processor->position--;
+                     if((i_counter & 1) == 0) /* Even numbered nibble */
+                     {
+                        h_processor->buffer[h_processor->position] = (h_processor->reg[C_REG]->nibble[i_count]) | ((h_processor->reg[C_REG]->nibble[i_count + 1]) & 0x3) << 4;
+                     }
+                     else
+                     {
+                        h_processor->buffer[h_processor->position] = ((h_processor->reg[C_REG]->nibble[i_count]) >> 2) | (h_processor->reg[C_REG]->nibble[i_count + 1]) << 2;
+                        i_count++;
+                     }
+                     i_counter++;
+                     if (h_processor->buffer[h_processor->position] == 0x3f) i_count = REG_SIZE;
+                  }
+               }
+               break;
+#endif
+            case 01460: /* rom checksum */
+               if (h_processor->trace) fprintf(stdout, "rom checksum");
+               h_processor->status[5] = False;
+               h_processor->sp = (h_processor->sp - 1) & (STACK_SIZE - 1); /* Update stack pointer */
+               h_processor->pc = h_processor->stack[h_processor->sp]; /* Pop program counter on the stack */
+               break;
+            case 01760: /* hi I'm woodstock */
+               if (h_processor->trace) fprintf(stdout, "hi I'm woodstock");
+               break;
+            default:
+               if (h_processor->trace) fprintf(stdout, "\n");
+               v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+            }
+         }
+         break;
+      case 01: /* Op-Codes matching x xxx xx0 100 */
+         switch ((i_opcode >> 4) & 03)
+         {
+         case 00: /* 1 -> s(n) */
+            if (h_processor->trace) fprintf(stdout, "1 -> s(%d)\t\t", i_opcode >> 6);
+            h_processor->status[i_opcode >> 6] = True;
+            if (h_processor->trace) v_fprint_status(stdout, h_processor);
+            break;
+         case 01: /* if 1 = s(n) */
+            if (h_processor->trace) fprintf(stdout, "if 1 = s(%d)", i_opcode >> 6);
+            h_processor->flags[CARRY] = h_processor->status[i_opcode >> 6];
+            v_op_goto(h_processor);
+            break;
+         case 02: /* if p = n */
+            if (h_processor->trace) fprintf(stdout, "if p = %d", i_tst_p[i_opcode >> 6]);
+            h_processor->flags[CARRY] = (h_processor->p == i_tst_p[i_opcode >> 6]);
+            v_op_goto(h_processor);
+            break;
+         case 03: /* delayed select rom n */
+            if (h_processor->trace) fprintf(stdout, "delayed select rom %d", i_opcode >> 6);
+            h_processor->rom_number = i_opcode >> 6;
+            h_processor->flags[DELAYED_ROM] = True;
+         }
+         break;
+      case 02: /* Op-Codes matching x xxx xx1 000 */
+         switch ((i_opcode >> 4) & 03)
+         {
+         case 00: /* Op-Codes matching x xxx 001 000 */
+            switch (i_opcode)
+            {
+            case 00010: /* clear registers */
+               if (h_processor->trace) fprintf(stdout, "clear registers");
+               {
+                  int i_count;
+                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+                  for (i_count = 0; i_count < REGISTERS - 2; i_count++) /* Don't clear M or N */
+                     v_reg_copy(h_processor, h_processor->reg[i_count], NULL); /* Copying nothing to a register clears it */
+               }
+               break;
+            case 00110: /* clear status */
+               if (h_processor->trace) fprintf(stdout, "clear status\t");
+               {
+                  int i_count;
+                  for (i_count = 0; i_count < sizeof(h_processor->status) / sizeof(*h_processor->status); i_count++)
+                     switch (i_count) {
+                        case 1:  /* Scientific notation */
+                        case 2:  /* Auto Enter (if set entering digit will push 'X') */
+#if (!defined(HP10))
+                        case 5:  /* Low power (Woodstock) / Self test (Spice) */
+#endif
+                        case 15: /* Set if any key is pressed */
+                           break;
+                        default:
+                           h_processor->status[i_count] = False; /* Clear all bits except bits 1, 2, 5, 15 */
+                     }
+               }
+            if (h_processor->trace) v_fprint_status(stdout, h_processor);
+               break;
+            case 00210: /* display toggle */
+               if (h_processor->trace) fprintf(stdout, "display toggle");
+               h_processor->flags[DISPLAY_ENABLE] = (!h_processor->flags[DISPLAY_ENABLE]);
+               break;
+            case 00310: /* display off */
+               if (h_processor->trace) fprintf(stdout, "display off");
+               h_processor->flags[DISPLAY_ENABLE] = False;
+               break;
+            case 00410: /* m exch c */
+               if (h_processor->trace) fprintf(stdout, "m exch c\t\t");
+               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+               v_reg_exch(h_processor, h_processor->reg[M_REG], h_processor->reg[C_REG]);
+               if (h_processor->trace)
+               {
+                  v_fprint_register(stdout,h_processor->reg[C_REG]);
+                  v_fprint_register(stdout,h_processor->reg[M_REG]);
+               }
+               break;
+            case 00510: /* m -> c */
+               if (h_processor->trace) fprintf(stdout, "m -> c\t\t");
+               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+               v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->reg[M_REG]);
+               if (h_processor->trace)
+                  v_fprint_register(stdout,h_processor->reg[C_REG]);
+               break;
+            case 00610: /* n exch c */
+               if (h_processor->trace) fprintf(stdout, "n exch c\t\t");
+               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+               v_reg_exch(h_processor, h_processor->reg[N_REG], h_processor->reg[C_REG]);
+               if (h_processor->trace)
+               {
+                  v_fprint_register(stdout,h_processor->reg[C_REG]);
+                  v_fprint_register(stdout,h_processor->reg[N_REG]);
+               }
+               break;
+            case 00710: /* n -> c */
+               if (h_processor->trace) fprintf(stdout, "n -> c\t\t");
+               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+               v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->reg[N_REG]);
+               if (h_processor->trace)
+                  v_fprint_register(stdout,h_processor->reg[C_REG]);
+               break;
+            case 01010: /* stack -> a */
+               if (h_processor->trace) fprintf(stdout, "stack -> a");
+               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+               v_reg_copy(h_processor, h_processor->reg[A_REG], h_processor->reg[Y_REG]); /* A = Y */
+               v_reg_copy(h_processor, h_processor->reg[Y_REG], h_processor->reg[Z_REG]); /* Y = Z */
+               v_reg_copy(h_processor, h_processor->reg[Z_REG], h_processor->reg[T_REG]); /* Z = T */
+               if (h_processor->trace)
+               {
+                  v_fprint_register(stdout,h_processor->reg[A_REG]);
+                  v_fprint_register(stdout,h_processor->reg[Y_REG]);
+                  v_fprint_register(stdout,h_processor->reg[Z_REG]);
+               }
+               break;
+            case 01110: /* down rotate */
+               if (h_processor->trace) fprintf(stdout, "down rotate\t");
+                  h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+                  v_reg_exch(h_processor, h_processor->reg[T_REG], h_processor->reg[C_REG]); /* T <> C - C to T */
+                  v_reg_exch(h_processor, h_processor->reg[C_REG], h_processor->reg[Y_REG]); /* C <> Y - Y to C */
+                  v_reg_exch(h_processor, h_processor->reg[Y_REG], h_processor->reg[Z_REG]); /* Y <> Z - Z to Y and T ends up in Z */
+                  if (h_processor->trace)
+                  {
+                     v_fprint_register(stdout,h_processor->reg[C_REG]);
+                     v_fprint_register(stdout,h_processor->reg[Y_REG]);
+                     v_fprint_register(stdout,h_processor->reg[Z_REG]);
+                     v_fprint_register(stdout,h_processor->reg[T_REG]);
+                  }
+               break;
+            case 01210: /* y -> a */
+               if (h_processor->trace) fprintf(stdout, "y -> a\t\t");
+               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+               v_reg_copy(h_processor, h_processor->reg[A_REG], h_processor->reg[Y_REG]);
+               if (h_processor->trace)
+                  v_fprint_register(stdout,h_processor->reg[A_REG]);
+               break;
+            case 01310: /* c _> stack */
+               if (h_processor->trace) fprintf(stdout, "c -> stack\t\t");
+               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+               v_reg_copy(h_processor, h_processor->reg[T_REG], h_processor->reg[Z_REG]); /* T = Z */
+               v_reg_copy(h_processor, h_processor->reg[Z_REG], h_processor->reg[Y_REG]); /* T = Z */
+               v_reg_copy(h_processor, h_processor->reg[Y_REG], h_processor->reg[C_REG]); /* T = Z */
+               if (h_processor->trace)
+               {
+                  v_fprint_register(stdout,h_processor->reg[C_REG]);
+                  v_fprint_register(stdout,h_processor->reg[Y_REG]);
+                  v_fprint_register(stdout,h_processor->reg[Z_REG]);
+                  v_fprint_register(stdout,h_processor->reg[T_REG]);
+               }
+               break;
+            case 01410: /* decimal */
+               if (h_processor->trace) fprintf(stdout, "decimal");
+               h_processor->base = 10;
+               break;
+            case 01610: /* f -> a */
+               h_processor->reg[A_REG]->nibble[0] = h_processor->f;
+               h_processor->display++;
+               if (h_processor->trace) fprintf(stdout, "f -> a\t\t");
+               if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+               break;
+            case 01710: /* f exch a */
+               if (h_processor->trace) fprintf(stdout, "f exch a\t\t");
+               {
+                  int i_temp;
+                  i_temp = h_processor->reg[A_REG]->nibble[0];
+                  h_processor->reg[A_REG]->nibble[0] = h_processor->f;
+                  h_processor->f = i_temp;
+                  h_processor->display++;
+               }
+               if (h_processor->trace)
+               {
+                  v_fprint_register(stdout,h_processor->reg[A_REG]);
+                  fprintf(stdout, "\tf = %02x", h_processor->f);
+               }
+               break;
+            default:
+               if (h_processor->trace) fprintf(stdout, "\n");
+               v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+            }
+            break;
+         case 01: /* load constant n */
+            if (h_processor->trace) fprintf(stdout, "load constant %d\t", i_opcode >> 6);
+            h_processor->reg[C_REG]->nibble[h_processor->p] = i_opcode >> 6;
+            v_op_dec_p(h_processor);
+            if (h_processor->trace)
+            {
+               v_fprint_register(stdout,h_processor->reg[C_REG]);
+               fprintf(stdout, "\tp = %d", h_processor->p);
+            }
+            break;
+         case 02: /* c -> data register(n) */
+            h_processor->addr &= 0xfff0;
+            h_processor->addr += (i_opcode >> 6);
+            if (h_processor->trace) fprintf(stdout, "c -> data register(%d)", h_processor->addr);
+            if ((h_processor->addr) < MEMORY_SIZE)
+            {
+               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+               v_reg_copy(h_processor, h_processor->mem[h_processor->addr], h_processor->reg[C_REG]); /* C -> reg(n) */
+            }
+#if defined(HP67)
+            else if ((h_processor->addr == CARD_DATA) || (h_processor->addr == CARD_DATA + 2))
+            {
+               h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+               v_reg_copy(h_processor, h_processor->card, h_processor->reg[C_REG]); /* C -> card reader */
+            }
+#endif
+            else
+            {
+               if (h_processor->trace) fprintf(stdout, "\n");
+               v_error(h_err_invalid_address, i_opcode >> 6, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+            }
+            break;
+         case 03: /* data -> c or data register(n)-> c */
+            h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+            if ((i_opcode >> 6) == 0)
+            {
+               if (h_processor->trace) fprintf(stdout, "data -> c\t\t");
+#if defined(HP67)
+               if (h_processor->addr >= MEMORY_SIZE) /* Card reader */
+                  v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->card);
+               else
+#endif
+               v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->mem[h_processor->addr]);
+            }
+#if defined(HP10)
+            else if (((i_opcode >> 6) == 0xf) && (h_processor->addr == 0xff))
+            {
+               if (h_processor->trace) fprintf(stdout, "data -> c\t\t");
+               h_processor->reg[C_REG]->nibble[2] = (h_processor->code >> 4);
+               h_processor->reg[C_REG]->nibble[1] = (h_processor->code & 0x0f);
+               h_processor->reg[C_REG]->nibble[0] = 0;
+               h_processor->code = 0; /* Clear the key code (so it isn't read twice if the key is held down) */
+            }
+#endif
+            else
+            {
+               h_processor->addr &= 0xfff0;
+               h_processor->addr += (i_opcode >> 6);
+               if (h_processor->trace) fprintf(stdout, "data register(%d) -> c", h_processor->addr);
+               if ((h_processor->addr) < MEMORY_SIZE)
+                  v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->mem[h_processor->addr]);
+#if defined(HP67)
+               else if ((h_processor->addr == CARD_DATA) || (h_processor->addr == CARD_DATA + 2))
+                  v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->card); /* Card reader -> C */
+#endif
+               else
+               {
+                  if (h_processor->trace) fprintf(stdout, "\n");
+                  v_error(h_err_invalid_address, h_processor->addr, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+               }
+            }
+            if (h_processor->trace)
+               v_fprint_register(stdout,h_processor->reg[C_REG]);
+            break;
+         default:
+            if (h_processor->trace) fprintf(stdout, "\n");
+            v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         break;
+
+      case 03: /* Op-Codes matching x xxx xx1 100 */
+         switch ((i_opcode >> 4) & 03)
+         {
+         case 00: /* 0 -> s(n) */
+            if (h_processor->trace) fprintf(stdout, "0 -> s(%d)\t\t", i_opcode >> 6);
+            h_processor->status[i_opcode >> 6] = False;
+            if (h_processor->trace) v_fprint_status(stdout, h_processor);
+            break;
+         case 01: /* if 0 = s(n) */
+            if (h_processor->trace) fprintf(stdout, "if 0 = s(%d) ", i_opcode >> 6);
+            h_processor->flags[CARRY] = !h_processor->status[i_opcode >> 6];
+            v_op_goto(h_processor);
+            break;
+         case 02: /* if p != n */
+            /* 01354 if p !=  0  00554 if p !=  1  00354 if p !=  2
+             * 00754 if p !=  3  00054 if p !=  4  01254 if p !=  5
+             * 00654 if p !=  6  01654 if p !=  7  00154 if p !=  8
+             * 00454 if p !=  9  01554 if p != 10  01454 if p != 11
+             * 00254 if p != 12  01154 if p != 13  N/A   if p != 14
+             * N/A   if p != 15
+            */
+            if (h_processor->trace) fprintf(stdout, "if p != %d", i_tst_p[i_opcode >> 6]);
+            h_processor->flags[CARRY] = (h_processor->p != i_tst_p[i_opcode >> 6]);
+            v_op_goto(h_processor);
+            break;
+         case 03: /* n -> p*/
+            /* 01474  0 -> p  01074  1 -> p  00574  2 -> p
+             * 01174  3 -> p  00174  4 -> p  01674  5 -> p
+             * 01374  6 -> p  00274  7 -> p  00374  8 -> p
+             * 01574  9 -> p  00674 10 -> p  00474 11 -> p
+             * 00774 12 -> p  01274 13 -> p  N/A   14 -> p
+             * N/A   15 -> p
+             * */
+            if (h_processor->trace) fprintf(stdout, "%d -> p\t\t\t", i_set_p[i_opcode >> 6]);
+            h_processor->p = i_set_p[i_opcode >> 6];
+            if (h_processor->trace) fprintf(stdout, "p = %d", h_processor->p);
+            break;
+         }
+         break;
+      }
+      break;
+
+   case 01: /* Type 1 - Jump subroutine */
+      if (h_processor->trace) {fprintf(stdout, "jsb "); fprintf(stdout, h_msg_address, ((h_processor->pc & 0x0f00) | i_opcode >> 2));}
+      op_jsb(h_processor, (i_opcode >> 2)); /* Note - uses and eight bit address */
+      break;
+
+   case 02: /* Type 2 - Arithmetic operations */
+      i_field = (i_opcode >> 2) & 7;
+      switch (i_field) /* Select field
+         000   P  : determined by P                   [P]
+         001  WP  : word up to and including P        [0 ..  P]
+         010  XS  : exponent sign                     [2]
+         011   X  : exponent                          [0 ..  1]
+         100   S  : sign                              [13]
+         101   M  : mantissa                          [3 .. 12]
+         110   W  : word                              [0 .. 13]
+         111  MS  : mantissa and sign                 [3 .. 13] */
+      {
+      case 00: /* P */
+         s_field = "p";
+         h_processor->first = h_processor->p; h_processor->last = h_processor->p;
+         if (h_processor->p >= REG_SIZE)
+         {
+            if (h_processor->trace) fprintf(stdout, "\n");
+            v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         break;
+      case 01: /* WP */
+         s_field = "wp";
+         h_processor->first =  0; h_processor->last =  h_processor->p; /* break; bug in orig??? */
+         if (h_processor->p >= REG_SIZE)
+         {
+            if (h_processor->trace) fprintf(stdout, "\n");
+            v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         }
+         break;
+      case 02: /* XS */
+         s_field = "xs";
+         h_processor->first = EXP_SIZE - 1; h_processor->last = EXP_SIZE - 1;
+         break;
+      case 03: /* X */
+         s_field = "x";
+         h_processor->first = 0; h_processor->last = EXP_SIZE - 1;
+         break;
+      case 04: /* S */
+         s_field = "s";
+         h_processor->first = REG_SIZE - 1; h_processor->last = REG_SIZE - 1;
+         break;
+      case 05: /* M */
+         s_field = "m";
+         h_processor->first = EXP_SIZE; h_processor->last = REG_SIZE - 2;
+         break;
+      case 06: /* W */
+         s_field = "w";
+         h_processor->first = 0; h_processor->last = REG_SIZE - 1;
+         break;
+      case 07: /* MS */
+         s_field = "ms";
+         h_processor->first = EXP_SIZE; h_processor->last = REG_SIZE - 1;
+         break;
+      }
+
+      switch (i_opcode >> 5)
+      {
+      case 000: /* 0 -> a[f] */
+         if (h_processor->trace) fprintf(stdout, "0 -> a[%s]\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[A_REG], NULL);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 001: /* 0 -> b[f] */
+         if (h_processor->trace)fprintf(stdout, "0 -> b[%s]\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[B_REG], NULL);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
+         break;
+      case 002: /* a exch b[f] */
+         if (h_processor->trace) fprintf(stdout, "a exch b[%s]\t", s_field);
+         v_reg_exch(h_processor, h_processor->reg[A_REG], h_processor->reg[B_REG]);
+         if (h_processor->trace)
+         {
+            v_fprint_register(stdout,h_processor->reg[A_REG]);
+            v_fprint_register(stdout,h_processor->reg[B_REG]);
+         }
+         break;
+      case 003: /* a -> b[f] */
+         if (h_processor->trace) fprintf(stdout, "a -> b[%s]\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[B_REG], h_processor->reg[A_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
+         break;
+      case 004: /* a exch c[f] */
+         if (h_processor->trace) fprintf(stdout, "a exch c[%s]\t", s_field);
+         v_reg_exch(h_processor, h_processor->reg[A_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace)
+         {
+            v_fprint_register(stdout,h_processor->reg[A_REG]);
+            v_fprint_register(stdout,h_processor->reg[C_REG]);
+         }
+         break;
+      case 005: /* c -> a[f] */
+         if (h_processor->trace) fprintf(stdout, "c -> a[%s]\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[A_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 006: /* b -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "b -> c[%s]\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[C_REG], h_processor->reg[B_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 007: /* b exchange c[f] */
+         if (h_processor->trace) fprintf(stdout, "b exch c[%s]\t", s_field);
+         v_reg_exch(h_processor, h_processor->reg[B_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace)
+         {
+            v_fprint_register(stdout,h_processor->reg[B_REG]);
+            v_fprint_register(stdout,h_processor->reg[C_REG]);
+         }
+         break;
+      case 010: /* 0 -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "0 -> c[%s]\t\t", s_field);
+         v_reg_copy(h_processor, h_processor->reg[C_REG], NULL);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 011: /* a + b -> a[f] */
+         if (h_processor->trace) fprintf(stdout, "a + b -> a[%s]\t", s_field);
+         v_reg_add(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[B_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 012: /* a + c -> a[f] */
+         if (h_processor->trace) fprintf(stdout, "a + c -> a[%s]\t", s_field);
+         v_reg_add(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 013: /* c + c -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "c + c -> c[%s]\t", s_field);
+         v_reg_add(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 014: /* a + c -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "a + c -> c[%s]\t", s_field);
+         v_reg_add(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], h_processor->reg[A_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 015: /* a + 1 -> a[f] */
+         if (h_processor->trace) fprintf(stdout, "a + 1 -> a[%s]\t", s_field);
+         v_reg_inc(h_processor, h_processor->reg[A_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 016: /* shift left a[f] */
+         if (h_processor->trace) fprintf(stdout, "shift left a[%s]\t", s_field);
+         fflush(stdout);
+         v_reg_shl(h_processor, h_processor->reg[A_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 017: /* c + 1 -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "c + 1 -> c[%s]\t", s_field);
+         v_reg_inc(h_processor, h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 020: /* a - b -> a[f] */
+         if (h_processor->trace) fprintf(stdout, "a - b -> a[%s]\t", s_field);
+         v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[B_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 021: /* a - c -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "a - c -> c[%s]\t", s_field);
+         v_reg_sub(h_processor, h_processor->reg[C_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 022: /* a - 1 -> a[f] */
+         if (h_processor->trace) fprintf(stdout, "a - 1 -> a[%s]\t", s_field);
+         h_processor->flags[CARRY] = True; /* Set carry */
+         v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], NULL);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 023: /* c - 1 -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "c - 1 -> c[%s]\t", s_field);
+         h_processor->flags[CARRY] = True; /* Set carry */
+         v_reg_sub(h_processor, h_processor->reg[C_REG], h_processor->reg[C_REG], NULL);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 024: /* 0 - c -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "0 - c -> c[%s]\t", s_field);
+         v_reg_sub(h_processor, h_processor->reg[C_REG], NULL, h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 025: /* 0 - c - 1 -> c[f] */
+         if (h_processor->trace) fprintf(stdout, "0 - c - 1 -> c[%s]\t", s_field);
+         h_processor->flags[CARRY] = True; /* Set carry */
+         v_reg_sub(h_processor, h_processor->reg[C_REG], NULL, h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      case 026: /* if b[f] = 0 */
+         if (h_processor->trace) fprintf(stdout, "if b[%s] = 0", s_field);
+         v_reg_test_eq(h_processor, h_processor->reg[B_REG], NULL);
+         v_op_goto(h_processor);
+         break;
+      case 027: /* if c[f] = 0 */
+         if (h_processor->trace) fprintf(stdout, "if c[%s] = 0", s_field);
+         v_reg_test_eq(h_processor, h_processor->reg[C_REG], NULL);
+         v_op_goto(h_processor);
+         break;
+      case 030: /* if a >= c[f] */
+         if (h_processor->trace) fprintf(stdout, "if a >= c[%s]", s_field);
+         v_reg_sub(h_processor, NULL, h_processor->reg[A_REG], h_processor->reg[C_REG]); /* Less than */
+         h_processor->flags[CARRY] = !h_processor->flags[CARRY];
+         v_op_goto(h_processor);
+         break;
+      case 031: /* if a >= b[f] */
+         if (h_processor->trace) fprintf(stdout, "if a >= b[%s]", s_field);
+         v_reg_sub(h_processor, NULL, h_processor->reg[A_REG], h_processor->reg[B_REG]); /* Less than */
+         h_processor->flags[CARRY] = !h_processor->flags[CARRY];
+         v_op_goto(h_processor);
+         break;
+      case 032: /* if a[f] != 0 */
+         if (h_processor->trace) fprintf(stdout, "if a[%s] != 0", s_field);
+         v_reg_test_ne(h_processor, h_processor->reg[A_REG], NULL);
+         v_op_goto(h_processor);
+         break;
+      case 033: /* if c[f] != 0 */
+         if (h_processor->trace) fprintf(stdout, "if c[%s] != 0", s_field);
+         v_reg_test_ne(h_processor, h_processor->reg[C_REG], NULL);
+         v_op_goto(h_processor);
+         break;
+      case 034: /* a - c -> a[f] */
+         if (h_processor->trace) fprintf(stdout, "a - c -> a[%s]\t", s_field);
+         v_reg_sub(h_processor, h_processor->reg[A_REG], h_processor->reg[A_REG], h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 035: /* shift right a[f] */
+         if (h_processor->trace) fprintf(stdout, "shift right a[%s]\t", s_field);
+         v_reg_shr(h_processor, h_processor->reg[A_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[A_REG]);
+         break;
+      case 036: /* shift right b[f] */
+         v_reg_shr(h_processor, h_processor->reg[B_REG]);
+         if (h_processor->trace) fprintf(stdout, "shift right b[%s]\t", s_field);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[B_REG]);
+         break;
+      case 037: /* shift right c[f] */
+         if (h_processor->trace) fprintf(stdout, "shift right c[%s]\t", s_field);
+         v_reg_shr(h_processor, h_processor->reg[C_REG]);
+         if (h_processor->trace) v_fprint_register(stdout,h_processor->reg[C_REG]);
+         break;
+      default:
+         if (h_processor->trace) fprintf(stdout, "\n");
+         v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+      }
+      break;
+
+   case 03:/* Type 3 - Conditional branch */
+      switch (i_opcode & 03)
+      {
+      case 00:
+         if (h_processor->trace) {fprintf(stdout, "call "); fprintf(stdout, h_msg_address, i_opcode >> 2);}
+         if (h_processor->trace) fprintf(stdout, "\n");
+         v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         break;
+      case 01:
+         if (h_processor->trace) {fprintf(stdout, "call "); fprintf(stdout, h_msg_address, i_opcode >> 2);}
+         if (h_processor->trace) fprintf(stdout, "\n");
+         v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         break;
+      case 02:
+         if (h_processor->trace) {fprintf(stdout, "jump "); fprintf(stdout, h_msg_address, i_opcode >> 2);}
+         if (h_processor->trace) fprintf(stdout, "\n");
+         v_error(h_err_unexpected_opcode, i_opcode, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+         break;
+      case 03: /* if nc go to */
+         if (h_processor->trace) {fprintf(stdout, "if nc go to "); fprintf(stdout, h_msg_address, ((h_processor->pc & 0x0f00) | i_opcode >> 2));} /* Note - uses and eight bit address */
+         if (!h_processor->flags[PREV_CARRY])
+         {
+            h_processor->pc = (h_processor->pc & 0xff00) | i_opcode >> 2;
+            v_delayed_rom(h_processor);
+         }
+         break;
+      default:
+         if (h_processor->trace) fprintf(stdout, "\n");
+         v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+      }
+      break;
+   default:
+      if (h_processor->trace) fprintf(stdout, "\n");
+      v_error(h_err_unexpected_error, (i_last >> 12), (i_last & 0xfff), __FILE__, __LINE__);
+   }
+   if (h_processor->trace) fprintf(stdout, "\n");
+   h_processor->opcode = i_opcode; /* Keep track of the previous opcode so you know when to increment 'P' */
+}
+#endif
@@ -220,9 +220,67 @@
  * 02 Feb 23         - Changed 'linux' to '__linux__' to fix a problem with
  *                     conditional compilation that stopped keypress events
  *                     from being processed - MT
+ * 17 Oct 26         - Only redraws the parts of the display that have been
+ *                     changed - MT
+ *                   - Labels, switches and buttons are drawn into an  off-
+ *                     screen  copy of the faceplate at startup and  expose
+ *                     events  just copy the exposed area back  (waits  for
+ *                     the last of a series of expose events) - MT
+ *                   - Uses  a copy of each button to show when it has been
+ *                     pressed or released - MT
+ *                   - Added '--shm' option to draw the window using a frame
+ *                     buffer in shared memory (if available) - MT
+ *                   - Added '-o' option to save a picture of the calculator
+ *                     without connecting to an X server - MT
+ *                   - The display is refreshed at a fixed rate (which can
+ *                     be  changed using '--refresh') instead of after  a
+ *                     fixed number of instructions - MT
+ *                   - The  user interface can be scaled using  '--scale'
+ *                     or by resizing the window, which rebuilds the layout
+ *                     and the cached copies of the faceplate, buttons and
+ *                     digits (uses larger fixed fonts if available) - MT
+ *                   - Doesn't update the display while the window is  not
+ *                     mapped or completely hidden - MT
+ *                   - Finds  the button for a key or the button or switch
+ *                     at a position using a lookup table or map instead of
+ *                     checking each one in turn - MT
+ *                   - Flushes the keyboard cache if the mapping changes - MT
+ *                   - Key  presses  and releases are added  to  a  queue
+ *                     instead of being passed straight to the processor -
+ *                     MT
+ *                   - Ignores  key  events generated by auto repeat  while
+ *                     a key is held down - MT
+ *                   - Allocates everything from an arena, and rewinds  it
+ *                     to rebuild the user interface - MT
+ *                   - Added '--verbose' to show how long each stage of the
+ *                     start up takes - MT
+ *                   - Instead of waiting for 200 ms at start up, any keys
+ *                     already  held down when the window gets  the  focus
+ *                     are ignored until they are released - MT
+ *                   - Uses  the default depth instead of asking  for  the
+ *                     geometry of the new window - MT
+ *                   - Saves any changes to continuous memory every  few
+ *                     seconds in the background - MT
+ *                   - Added '-m' option to keep the memory registers in a
+ *                     mapped file - MT
+ *                   - Added '-c' option and Ctrl-L and Ctrl-W to read and
+ *                     write HP67 cards - MT
+ *                   - Fixed the size of the window, which was set  before
+ *                     the scale was known - MT
+ *                   - Only saves continuous memory every few seconds if
+ *                     the memory registers have changed - MT
+ *                   - Added '--turbo' to copy HP67 cards straight into
+ *                     memory - MT
+ *                   - Checks for '--version' before '--verbose' so that
+ *                     '--v' still shows the version - MT
+ *                   - Discards the glyphs copied from the old fonts when
+ *                     the user interface is rescaled - MT
+ *                   - Reports any error writing the data file in the
+ *                     background and stops - MT
+ *                   - Beeps instead of showing a key as pressed if the
+ *                     key queue is full - MT
  *
  * To Do             - Parse command line in a separate routine.
- *                   - Add verbose option.
  *                   - Allow VMS users to set breakpoints?
  *                   - Free up allocated memory on exit.
  *                   - Sort out colour mapping.
@@ -236,7 +294,10 @@
 #define AUTHOR         "MT"
 
 #define INTERVAL 25    /* Number of ticks to execute before updating the display */
+#define AUTOSAVE 5000  /* Time between saving any changes to continuous memory (ms) */
 #define DELAY 50       /* Number of intervals to wait before exiting */
+#define SETTLE 100000  /* Number of ticks to execute before saving a picture */
+#define REFRESH 60     /* Default display refresh rate (Hz) */
 
 #include <stdarg.h>    /* strlen(), etc */
 #include <string.h>    /* strlen(), etc */
@@ -248,12 +309,18 @@
 #include <X11/Xlib.h>  /* XOpenDisplay(), etc */
 #include <X11/Xutil.h> /* XSizeHints etc */
 #include <X11/cursorfont.h>
+#if defined(__linux__) || defined(__NetBSD__)
+#include <X11/XKBlib.h> /* XkbSetDetectableAutoRepeat() */
+#endif
 
 #include "x11-calc-font.h"
 #include "x11-calc-button.h"
 #include "x11-calc-switch.h"
 #include "x11-calc-label.h"
 #include "x11-calc-colour.h"
+#include "x11-calc-faceplate.h"
+#include "x11-calc-render.h"
+#include "x11-calc-arena.h"
 
 #include "x11-calc.h"
 
@@ -296,6 +363,46 @@ void v_error(const char *s_format, ...) /* Print formatted error message and exi
    exit(-1);
 }
 
+XFontStruct *h_load_font(Display *x_display, char *s_font) /* Load a font, or a larger one if the user interface is scaled */
+{
+   static char *s_fixed[] = {"5x8", "6x10", "6x12", "6x13", "7x14", "8x16", "9x18", "10x20", "12x24"}; /* Fixed fonts in order of size */
+   XFontStruct *h_font = NULL;
+   int i_count, i_width, i_height, i_size;
+   char c_extra;
+
+   if ((f_scale != 1) && (sscanf(s_font, "%dx%d%c", &i_width, &i_height, &c_extra) == 2)) /* Only scale fixed fonts */
+      for (i_count = sizeof(s_fixed) / sizeof(*s_fixed) - 1; (i_count >= 0) && (h_font == NULL); i_count--)
+      {
+         sscanf(s_fixed[i_count], "%dx%d", &i_width, &i_size);
+         if (i_size <= i_height * f_scale) h_font = XLoadQueryFont(x_display, s_fixed[i_count]); /* Largest font that fits */
+      }
+   if ((h_font == NULL) && !(h_font = XLoadQueryFont(x_display, s_font))) v_error(h_err_font, s_font);
+   return(h_font);
+}
+
+void v_phase(char b_verbose, char *s_phase, long *l_phase) /* Show how long a stage of the start up took */
+{
+   long l_now = l_time();
+
+   if (b_verbose) fprintf(stdout, h_msg_startup, s_phase, l_now - *l_phase);
+   *l_phase = l_now;
+}
+
+void v_map_buttons(obutton *h_button[], obutton *h_key[], ofaceplate *h_faceplate) /* Map the keys and positions of the buttons */
+{
+   int i_count;
+
+   for (i_count = 0; i_count < 256; i_count++)
+      h_key[i_count] = NULL;
+   for (i_count = BUTTONS - 1; i_count >= 0; i_count--) /* The first matching button takes precedence */
+      if (h_button[i_count] != NULL)
+      {
+         v_faceplate_map(h_faceplate, h_button[i_count]->left, h_button[i_count]->top,
+            h_button[i_count]->width, h_button[i_count]->height, i_count + 1);
+         if (h_button[i_count]->key != '\000') h_key[(unsigned char) h_button[i_count]->key] = h_button[i_count];
+      }
+}
+
 void v_set_blank_cursor(Display *x_display, Window x_application_window, Cursor *x_cursor)
 {
    Pixmap x_blank;
@@ -306,6 +413,77 @@ void v_set_blank_cursor(Display *x_display, Window x_application_window, Cursor
    XFreePixmap (x_display, x_blank); /* Free up pixmap */
 }
 
+/*
+ * save_picture (processor, pathname, filename)
+ *
+ * Draws  the calculator in a client side image without using an X server,
+ * runs  the  processor  for long enough to update the display,  and  then
+ * saves the image as a PPM file.
+ *
+ */
+
+void v_save_picture(oprocessor *h_processor, char *s_pathname, char *s_filename)
+{
+#if defined(SWITCHES)
+   oswitch *h_switch[SWITCHES];
+#endif
+#if defined(LABELS)
+   olabel *h_label[LABELS];
+#endif
+   obutton *h_button[BUTTONS];
+   odisplay *h_display;
+   Drawable x_picture;
+   int i_count;
+
+   h_normal_font = h_render_font(NORMAL_TEXT); /* Use the built in fonts */
+   h_small_font = h_render_font(SMALL_TEXT);
+   h_alternate_font = h_render_font(ALTERNATE_TEXT);
+   h_large_font = h_render_font(LARGE_TEXT);
+
+   v_init_buttons(h_button);
+#if defined(SWITCHES)
+   v_init_switches(h_switch);
+#endif
+#if defined(LABELS)
+   v_init_labels(h_label);
+#endif
+   h_display = h_display_create(0, BEZEL_LEFT, BEZEL_TOP, BEZEL_WIDTH, BEZEL_HEIGHT,
+      DISPLAY_LEFT, DISPLAY_TOP, DISPLAY_WIDTH, DISPLAY_HEIGHT, DIGIT_COLOUR, DIGIT_BACKGROUND,
+      DISPLAY_BACKGROUND, BEZEL_COLOUR);
+
+   x_picture = x_render_create(NULL, None, WIDTH, HEIGHT);
+   v_render_fill(NULL, x_picture, BACKGROUND, 0, 0, WIDTH, HEIGHT);
+#if defined(LABELS)
+   for (i_count = 0; i_count < LABELS; i_count++)
+      i_label_draw(NULL, x_picture, 0, h_label[i_count]);
+#endif
+#if defined(SWITCHES)
+   for (i_count = 0; i_count < SWITCHES; i_count++)
+      i_switch_draw(NULL, x_picture, 0, h_switch[i_count]);
+#endif
+   for (i_count = 0; i_count < BUTTONS; i_count++)
+      i_button_draw(NULL, x_picture, 0, h_button[i_count]);
+
+   if (s_pathname == NULL)
+      v_restore_state(h_processor);
+   else
+      v_read_state(h_processor, s_pathname);
+#if defined(SWITCHES)
+   if (h_switch[0] != NULL) h_processor->enabled = h_switch[0]->state;
+#if defined(HP10)
+   if (h_switch[1] != NULL) h_processor->print = h_switch[1]->state;
+#else
+   if (h_switch[1] != NULL) h_processor->mode = h_switch[1]->state;
+#endif
+#endif
+   for (i_count = 0; i_count < SETTLE; i_count++) /* Let the processor update the display */
+      v_processor_tick(h_processor);
+
+   i_display_update(NULL, x_picture, 0, h_display, h_processor);
+   i_display_draw(NULL, x_picture, 0, h_display);
+   if (!i_render_save(x_picture, s_filename)) v_error(h_err_opening_file, s_filename);
+}
+
 int main(int argc, char *argv[])
 {
    Display *x_display; /* Pointer to X display structure */
@@ -323,31 +501,46 @@ int main(int argc, char *argv[])
 #endif
    obutton *h_button[BUTTONS]; /* Array to hold pointers to buttons */
    obutton *h_pressed = NULL;
+   obutton *h_key[256]; /* Button for each key */
    odisplay *h_display; /* Pointer to display structure */
+   ofaceplate *h_faceplate; /* Pointer to off-screen copy of the faceplate */
 #if defined(__linux__) || defined(__NetBSD__)
    okeyboard *h_keyboard;
+   unsigned int i_keycode = 0; /* Key code of the key being held down */
+   char c_held[32] = {0}; /* Keys already held down when the window got the focus */
 #endif
    oprocessor *h_processor;
+   oarena *h_arena; /* Holds all the objects */
+   void *h_layout; /* Start of the user interface objects in the arena */
 
    char *s_display_name = ""; /* Just use the default display */
-   char *s_font; /* Font description */
 
    char *s_title = TITLE; /* Windows title */
    char *s_pathname = NULL;
+   char *s_picture = NULL; /* Save a picture of the calculator to this file */
+   char *s_memory = NULL; /* Keep the memory registers in this file */
+#if defined(HP67)
+   char *s_cards = "."; /* Folder holding the magnetic cards */
+   char b_turbo = False; /* Copy cards straight into memory */
+#endif
 
    unsigned int i_screen_width; /* Screen width */
    unsigned int i_screen_height; /* Screen height */
-   unsigned int i_window_width = WIDTH; /* Window width in pixels */
-   unsigned int i_window_height = HEIGHT; /* Window height in pixels */
+   unsigned int i_window_width; /* Window width in pixels */
+   unsigned int i_window_height; /* Window height in pixels */
    unsigned int i_window_border = 4; /* Window's border width */
    unsigned int i_colour_depth; /* Window's colour depth */
    unsigned int i_background_colour; /* Window's background colour */
-   int i_window_left, i_window_top; /* Window's top-left corner */
    int i_screen; /* Default screen number */
 
    char b_trace = False; /* Trace flag */
    char b_step = False; /* Single step flag flag */
    char b_cursor = True; /* Draw a cursor */
+   char b_shm = False; /* Draw window using a frame buffer in shared memory */
+   char b_verbose = False; /* Show start up timing */
+   char b_started = False; /* Window has been drawn */
+   char b_mapped = False; /* Window is mapped */
+   char b_obscured = False; /* Window is completely hidden */
    char b_run = True; /* Run flag controls CPU instruction execution in main loop */
    char b_abort = False; /*Abort flag controls execution of main loop */
 
@@ -355,7 +548,17 @@ int main(int argc, char *argv[])
    int i_breakpoint = -1; /* Break-point */
    int i_trap = -1; /* Trap instruction */
    int i_ticks = -1;
+   int i_refresh = REFRESH; /* Display refresh rate */
+   unsigned int i_resize_width, i_resize_height; /* New size of window */
+   double f_resize; /* New scale */
+   long l_frame; /* Time the display is next due to be refreshed */
+   long l_autosave; /* Time any changes to continuous memory are next due to be saved */
+   long l_start, l_phase; /* Time start up began, and the current stage of start up began */
 
+   l_start = l_phase = l_time();
+   f_scale = 1; /* Default scale */
+   h_arena = h_arena_create(ARENA_SIZE);
+   v_arena_select(h_arena);
    h_processor = h_processor_create(i_rom);
 #if defined(unix) || defined(__unix__) || defined(__APPLE__) /* Parse UNIX style command line options */
    b_abort = False; /* Stop processing command line */
@@ -399,6 +602,24 @@ int main(int argc, char *argv[])
                      v_error(h_err_missing_argument, argv[i_count]);
                i_index = strlen(argv[i_count]) - 1;
                break;
+#if defined(HP67)
+            case 'c': /* Folder holding the magnetic cards */
+               if (argv[i_count][i_index + 1] != 0)
+                  v_error(h_err_invalid_argument, argv[i_count][i_index + 1]);
+               else
+                  if (i_count + 1 < argc)
+                  {
+                     s_cards = argv[i_count + 1];
+                     if (i_count + 2 < argc) /* Remove the parameter from the arguments */
+                        for (i_offset = i_count + 1; i_offset < argc - 1; i_offset++)
+                           argv[i_offset] = argv[i_offset + 1];
+                     argc--;
+                  }
+                  else
+                     v_error(h_err_missing_argument, argv[i_count]);
+               i_index = strlen(argv[i_count]) - 1;
+               break;
+#endif
             case 'i': /* Trap Instruction */
                if (argv[i_count][i_index + 1] != 0)
                   v_error(h_err_invalid_argument, argv[i_count][i_index + 1]);
@@ -443,6 +664,40 @@ int main(int argc, char *argv[])
                      v_error(h_err_missing_argument, argv[i_count]);
                i_index = strlen(argv[i_count]) - 1;
                break;
+#if defined(CONTINIOUS)
+            case 'm': /* Keep memory registers in a mapped file */
+               if (argv[i_count][i_index + 1] != 0)
+                  v_error(h_err_invalid_argument, argv[i_count][i_index + 1]);
+               else
+                  if (i_count + 1 < argc)
+                  {
+                     s_memory = argv[i_count + 1];
+                     if (i_count + 2 < argc) /* Remove the parameter from the arguments */
+                        for (i_offset = i_count + 1; i_offset < argc - 1; i_offset++)
+                           argv[i_offset] = argv[i_offset + 1];
+                     argc--;
+                  }
+                  else
+                     v_error(h_err_missing_argument, argv[i_count]);
+               i_index = strlen(argv[i_count]) - 1;
+               break;
+#endif
+            case 'o': /* Save a picture */
+               if (argv[i_count][i_index + 1] != 0)
+                  v_error(h_err_invalid_argument, argv[i_count][i_index + 1]);
+               else
+                  if (i_count + 1 < argc)
+                  {
+                     s_picture = argv[i_count + 1];
+                     if (i_count + 2 < argc) /* Remove the parameter from the arguments */
+                        for (i_offset = i_count + 1; i_offset < argc - 1; i_offset++)
+                           argv[i_offset] = argv[i_offset + 1];
+                     argc--;
+                  }
+                  else
+                     v_error(h_err_missing_argument, argv[i_count]);
+               i_index = strlen(argv[i_count]) - 1;
+               break;
             case 's': /* Start in single step mode */
                b_trace = b_step = True;
                break;
@@ -458,15 +713,37 @@ int main(int argc, char *argv[])
                      b_cursor = False; /* Don't draw a cursor - unless drawn by the window manager */
                   else if (!strncmp(argv[i_count], "--cursor", i_index))
                      b_cursor = True; /* Draw cursor */
+                  else if (!strncmp(argv[i_count], "--shm", i_index))
+                     b_shm = True; /* Use a shared memory frame buffer if possible */
+#if defined(HP67)
+                  else if (!strncmp(argv[i_count], "--turbo", i_index))
+                     b_turbo = True; /* Copy cards straight into memory */
+#endif
+                  else if (!strncmp(argv[i_count], "--scale=", 8))
+                  {
+                     f_scale = atof(&argv[i_count][8]); /* Set the scale */
+                     if ((f_scale < 0.5) || (f_scale > 8)) v_error(h_err_option_range, argv[i_count]);
+                  }
+                  else if (!strncmp(argv[i_count], "--refresh=", 10))
+                  {
+                     i_refresh = atoi(&argv[i_count][10]); /* Set display refresh rate */
+                     if ((i_refresh < 1) || (i_refresh > 1000)) v_error(h_err_option_range, argv[i_count]);
+                  }
                   else if (!strncmp(argv[i_count], "--version", i_index))
                   {
                      v_version(); /* Display version information */
                      fprintf(stdout, h_msg_licence, &__DATE__[7], AUTHOR);
                      exit(0);
                   }
+                  else if (!strncmp(argv[i_count], "--verbose", i_index))
+                     b_verbose = True; /* Show start up timing (checked after '--version' so '--v' still means version) */
                   else if (!strncmp(argv[i_count], "--help", i_index))
                   {
                      fprintf(stdout, c_msg_usage, FILENAME);
+#if defined(HP67)
+                     fprintf(stdout, "%s", h_msg_card_options);
+#endif
+                     fprintf(stdout, "%s", h_msg_options);
                      exit(0);
                   }
                   else  /* If we get here then the we have an invalid long option */
@@ -524,6 +801,8 @@ int main(int argc, char *argv[])
       }
    }
 #endif
+   i_window_width = WIDTH; /* The size of the window depends on the scale so can only be set once the options are known */
+   i_window_height = HEIGHT;
 
 #if defined(CONTINIOUS)
    if (argc > 2) v_error(h_err_invalid_operand); /* There should never be more than one command lime parameter */
@@ -531,9 +810,15 @@ int main(int argc, char *argv[])
 #else
    if (argc > 1) v_error(h_err_invalid_operand); /* There shouldn't any command line parameters */
 #endif
-   i_wait(200); /* Sleep for 200 milliseconds to 'debounce' keyboard! */
+   if (s_picture != NULL) /* Doesn't need an X server */
+   {
+      v_save_picture(h_processor, s_pathname, s_picture);
+      exit(0);
+   }
    v_version();
+   v_phase(b_verbose, "options", &l_phase);
    if (!(x_display = XOpenDisplay(s_display_name))) v_error (h_err_display, s_display_name); /* Open the display and create a new window */
+   v_phase(b_verbose, "display", &l_phase);
 
    i_screen = DefaultScreen(x_display); /* Get the default screen for our X server */
    i_screen_width = DisplayWidth(x_display, i_screen);
@@ -550,44 +835,35 @@ int main(int argc, char *argv[])
       i_background_colour); /* Background colour */
 
    h_size_hint = XAllocSizeHints(); /* Set application window size */
-   h_size_hint->flags = PMinSize | PMaxSize;
-   h_size_hint->min_height = i_window_height;
-   h_size_hint->min_width = i_window_width;
-   h_size_hint->max_height = i_window_height;
-   h_size_hint->max_width = i_window_width;
+   h_size_hint->flags = PMinSize | PAspect; /* Window can be resized but must keep the same shape */
+   h_size_hint->min_height = i_window_height / (2 * f_scale);
+   h_size_hint->min_width = i_window_width / (2 * f_scale);
+   h_size_hint->min_aspect.x = h_size_hint->max_aspect.x = i_window_width;
+   h_size_hint->min_aspect.y = h_size_hint->max_aspect.y = i_window_height;
    XSetWMNormalHints(x_display, x_application_window, h_size_hint);
    XStoreName(x_display, x_application_window, s_title); /* Set the window title */
 
-   if (XGetGeometry(x_display, x_application_window,    /* Get window geometry */
-         &RootWindow(x_display, i_screen),
-         &i_window_left, &i_window_top,
-         &i_window_width,
-         &i_window_height,
-         &i_window_border,
-         &i_colour_depth) == False)
-      v_error(h_err_display_properties);
-
+   i_colour_depth = DefaultDepth(x_display, i_screen); /* The window has the same depth as its parent */
    if (i_colour_depth != COLOUR_DEPTH) v_error(h_err_display_colour, COLOUR_DEPTH); /* Check colour depth */
 
+   if (b_shm) /* Falls back to drawing the window as usual if a frame buffer can't be created */
+      i_render_framebuffer(x_display, x_application_window, i_screen, i_window_width, i_window_height);
+
    if (b_cursor)
       x_cursor = XCreateFontCursor(x_display, XC_arrow); /* Create a 'default' cursor */
    else
       v_set_blank_cursor(x_display, x_application_window, &x_cursor); /* Get a blank cursor */
 
    XDefineCursor(x_display, x_application_window, x_cursor); /* Define the desired X cursor */
+   v_phase(b_verbose, "window", &l_phase);
 
-   s_font = NORMAL_TEXT; /* Normal text font */
-   if (!(h_normal_font = XLoadQueryFont(x_display, s_font))) v_error(h_err_font, s_font);
-
-   s_font = SMALL_TEXT; /* Small text font */
-   if (!(h_small_font = XLoadQueryFont(x_display, s_font))) v_error(h_err_font, s_font);
-
-   s_font = ALTERNATE_TEXT; /* Alternate text font */
-   if (!(h_alternate_font = XLoadQueryFont(x_display, s_font))) v_error(h_err_font, s_font);
-
-   s_font = LARGE_TEXT; /* Large text font */
-   if (!(h_large_font = XLoadQueryFont(x_display, s_font))) v_error(h_err_font, s_font);
+   h_normal_font = h_load_font(x_display, NORMAL_TEXT); /* Normal text font */
+   h_small_font = h_load_font(x_display, SMALL_TEXT); /* Small text font */
+   h_alternate_font = h_load_font(x_display, ALTERNATE_TEXT); /* Alternate text font */
+   h_large_font = h_load_font(x_display, LARGE_TEXT); /* Large text font */
+   v_phase(b_verbose, "fonts", &l_phase);
 
+   h_layout = h_arena_mark(); /* Everything after this depends on the scale */
    v_init_buttons(h_button); /* Create buttons */
 
 #if defined(SWITCHES)
@@ -602,13 +878,34 @@ int main(int argc, char *argv[])
       DISPLAY_LEFT, DISPLAY_TOP, DISPLAY_WIDTH, DISPLAY_HEIGHT, DIGIT_COLOUR, DIGIT_BACKGROUND,
       DISPLAY_BACKGROUND, BEZEL_COLOUR); /* Create display */
 
+   h_faceplate = h_faceplate_create(x_display, x_application_window, i_screen,
+      i_window_width, i_window_height, i_background_colour); /* Draw the faceplate off-screen */
+#if defined(LABELS)
+   for (i_count = 0; i_count < LABELS; i_count++) /* Draw labels */
+      i_label_draw(x_display, h_faceplate->pixmap, i_screen, h_label[i_count]);
+#endif
+#if defined(SWITCHES)
+   for (i_count = 0; i_count < SWITCHES; i_count++) /* Draw switches */
+   {
+      i_switch_draw(x_display, h_faceplate->pixmap, i_screen, h_switch[i_count]);
+      if (h_switch[i_count] != NULL) v_faceplate_map(h_faceplate, h_switch[i_count]->left, h_switch[i_count]->top,
+         h_switch[i_count]->width, h_switch[i_count]->height, FACEPLATE_SWITCH + i_count);
+   }
+#endif
+   for (i_count = 0; i_count < BUTTONS; i_count++) /* Draw buttons */
+      i_button_draw(x_display, h_faceplate->pixmap, i_screen, h_button[i_count]);
+   v_map_buttons(h_button, h_key, h_faceplate);
+   v_phase(b_verbose, "layout", &l_phase);
+
 #if defined(__linux__) || defined(__NetBSD__)
    h_keyboard = h_keyboard_create(x_display); /* Only works with Linux */
+   XkbSetDetectableAutoRepeat(x_display, True, NULL); /* Don't send a release event before each repeated key press */
 #endif
 
    XSelectInput(x_display, x_application_window, FocusChangeMask | ExposureMask | /* Select kind of events we are interested in */
       KeyPressMask | KeyReleaseMask | ButtonPressMask |
-      ButtonReleaseMask | StructureNotifyMask | SubstructureNotifyMask);
+      ButtonReleaseMask | StructureNotifyMask | SubstructureNotifyMask |
+      VisibilityChangeMask);
 
    wm_delete = XInternAtom(x_display, "WM_DELETE_WINDOW", False); /* Create a windows delete message 'atom'. */
    XSetWMProtocols(x_display, x_application_window, &wm_delete, 1); /* Tell the display to pass wm_delete messages to the application window */
@@ -619,14 +916,24 @@ int main(int argc, char *argv[])
    fprintf(stdout, "ROM Size : %4u words \n", (unsigned)(sizeof(i_rom) / sizeof i_rom[0]));
    h_processor->trace = b_trace;
    h_processor->step = b_step;
+#if defined(HP67)
+   h_processor->turbo = b_turbo;
+#endif
 
    if (s_pathname == NULL)
       v_restore_state(h_processor);
    else
       v_read_state(h_processor, s_pathname); /* Load user specified settings */
+   if (s_memory != NULL) v_map_memory(h_processor, s_memory); /* Replaces the memory registers unless the file is new */
+   v_autosave_start();
+   v_phase(b_verbose, "state", &l_phase);
 
    b_abort = False;
    i_count = 0;
+   l_frame = l_time();
+   l_autosave = l_frame + AUTOSAVE;
+   i_resize_width = i_window_width;
+   i_resize_height = i_window_height;
 
 #if defined(SWITCHES)
    if (h_switch[0] != NULL) h_processor->enabled = h_switch[0]->state; /* Allow switches to be undefined if not used */
@@ -642,8 +949,13 @@ int main(int argc, char *argv[])
       i_count--;
       if (i_count < 0)
       {
-         i_display_update(x_display, x_application_window, i_screen, h_display, h_processor);
-         i_display_draw(x_display, x_application_window, i_screen, h_display); /* Redraw display */
+         if (b_mapped && !b_obscured && (l_time() - l_frame >= 0)) /* Sample the display when the next frame is due (if it can be seen) */
+         {
+            i_display_update(x_display, x_application_window, i_screen, h_display, h_processor);
+            i_display_refresh(x_display, x_application_window, i_screen, h_display); /* Redraw any digits that have changed */
+            l_frame += 1000 / i_refresh;
+            if (l_time() - l_frame >= 0) l_frame = l_time() + 1000 / i_refresh; /* Don't try to catch up if we have fallen behind */
+         }
          i_count = INTERVAL;
 #if defined(HP67)
          i_wait(INTERVAL / 4); /* Sleep for ~6.25 ms per tick */
@@ -656,6 +968,16 @@ int main(int argc, char *argv[])
 #endif
          if (i_ticks > 0) i_ticks -= 1;
          if (i_ticks == 0) b_abort = True;
+         if (l_time() - l_autosave >= 0) /* Only saves continuous memory if it has changed */
+         {
+            v_autosave(h_processor);
+            l_autosave = l_time() + AUTOSAVE;
+            if (i_autosave_failed()) /* The background thread can't exit itself */
+            {
+               v_warning(h_err_register_alloc, __FILE__, __LINE__);
+               b_abort = True;
+            }
+         }
       }
       if (((h_processor->pc & 0xfff) == i_breakpoint) || (h_processor->rom[h_processor->pc] == i_trap)) /* Check for Breakpoint or Instruction Trap */
       {
@@ -674,12 +996,21 @@ int main(int argc, char *argv[])
             if (!(h_pressed == NULL))
             {
                h_pressed->state = False;
-               i_button_draw(x_display, x_application_window, i_screen, h_pressed);
-               h_processor->keypressed = False; /* Don't clear the status bit here!! */
+               i_button_redraw(x_display, x_application_window, i_screen, h_pressed);
+               i_processor_key(h_processor, h_pressed->index, False);
             }
+#if defined(__linux__) || defined(__NetBSD__)
+            i_keycode = 0;
+#endif
             break;
 #if defined(__linux__) || defined(__NetBSD__)
+         case FocusIn: /* Ignore any keys that are already held down (e.g. the key used to start the program) */
+            XQueryKeymap(x_display, c_held);
+            break;
          case KeyPress :
+            if (c_held[x_event.xkey.keycode / 8] & (1 << (x_event.xkey.keycode % 8))) break; /* Key was already down */
+            if (x_event.xkey.keycode == i_keycode) break; /* Ignore auto repeat while the key is held down */
+            i_keycode = x_event.xkey.keycode;
             h_key_pressed(h_keyboard, x_display, x_event.xkey.keycode, x_event.xkey.state); /* Attempts to translate a key code into a character */
             if (h_keyboard->key == (XK_BackSpace & 0x1f)) h_keyboard->key = XK_Escape & 0x1f; /* Map backspace to escape */
             if (h_keyboard->key == (XK_Z & 0x1f)) /* Ctrl-z to exit */
@@ -692,6 +1023,12 @@ int main(int argc, char *argv[])
                h_processor->trace = !h_processor->trace;
             else if (h_keyboard->key == (XK_R & 0x1f)) /* Ctrl-R to display internal CPU registers */
                v_fprint_registers(stdout, h_processor);
+#if defined(HP67)
+            else if (h_keyboard->key == (XK_L & 0x1f)) /* Ctrl-L to read the next card */
+               v_read_card(h_processor, s_cards);
+            else if (h_keyboard->key == (XK_W & 0x1f)) /* Ctrl-W to write a new card */
+               v_write_card(h_processor, s_cards);
+#endif
             else if (h_keyboard->key == (XK_C & 0x1f)) /* Ctrl-C to reset */
             {
                v_processor_reset(h_processor);
@@ -702,26 +1039,44 @@ int main(int argc, char *argv[])
                b_run = True;
             }
             else { /* Check for matching button */
-               int i_count;
-               for (i_count = 0; i_count < BUTTONS; i_count++)
+               h_pressed = h_key[(unsigned char) h_keyboard->key];
+               if (h_pressed != NULL)
                {
-                  h_pressed = h_button_key_pressed(h_button[i_count], h_keyboard->key);
-                  if (h_pressed != NULL)
+                  if (i_processor_key(h_processor, h_pressed->index, True))
                   {
                      h_pressed->state = True;
-                     i_button_draw(x_display, x_application_window, i_screen, h_pressed);
-                     h_processor->code = h_pressed->index;
-                     h_processor->keypressed = True;
-#if !defined(SWITCHES)
-                     h_processor->enabled = True; /* Any key press wil wake up the processor */
-                     h_processor->sleep = False;
-#endif
-                     break;
+                     i_button_redraw(x_display, x_application_window, i_screen, h_pressed);
+                  }
+                  else
+                  {
+                     XBell(x_display, 0); /* Too many keys waiting to be processed */
+                     h_pressed = NULL;
                   }
                }
             }
             break;
+         case MappingNotify : /* Keyboard mapping has changed */
+            XRefreshKeyboardMapping(&x_event.xmapping);
+            if (x_event.xmapping.request == MappingKeyboard || x_event.xmapping.request == MappingModifier)
+               v_keyboard_flush(h_keyboard);
+            break;
          case KeyRelease :
+            if (XEventsQueued(x_display, QueuedAfterReading)) /* Check for a key press at the same time as the release */
+            {
+               XEvent x_next;
+               XPeekEvent(x_display, &x_next);
+               if ((x_next.type == KeyPress) && (x_next.xkey.keycode == x_event.xkey.keycode) && (x_next.xkey.time == x_event.xkey.time))
+               {
+                  XNextEvent(x_display, &x_next); /* Discard both events as the key is being repeated */
+                  break;
+               }
+            }
+            if (c_held[x_event.xkey.keycode / 8] & (1 << (x_event.xkey.keycode % 8))) /* Key was already down */
+            {
+               c_held[x_event.xkey.keycode / 8] &= ~(1 << (x_event.xkey.keycode % 8));
+               break;
+            }
+            if (x_event.xkey.keycode == i_keycode) i_keycode = 0;
             h_key_released(h_keyboard, x_display, x_event.xkey.keycode, x_event.xkey.state);
             if (h_keyboard->key == (XK_BackSpace & 0x1f)) h_keyboard->key = XK_Escape & 0x1f; /* Map backspace to escape */
             if (h_pressed != NULL)
@@ -729,8 +1084,8 @@ int main(int argc, char *argv[])
                if (h_keyboard->key == h_pressed->key)
                {
                   h_pressed->state = False;
-                  i_button_draw(x_display, x_application_window, i_screen, h_pressed);
-                  h_processor->keypressed = False; /* Don't clear the status bit here!! */
+                  i_button_redraw(x_display, x_application_window, i_screen, h_pressed);
+                  i_processor_key(h_processor, h_pressed->index, False);
                }
             }
             break;
@@ -738,29 +1093,30 @@ int main(int argc, char *argv[])
          case ButtonPress :
             if (x_event.xbutton.button == 1)
             {
-               int i_count;
-               for (i_count = 0; i_count < sizeof(h_button) / sizeof(*h_button); i_count++)
+               i_index = i_faceplate_find(h_faceplate, x_event.xbutton.x, x_event.xbutton.y); /* Find what is at this position */
+               h_pressed = NULL;
+               if ((i_index > 0) && (i_index <= BUTTONS))
                {
-                  h_pressed = h_button_pressed(h_button[i_count], x_event.xbutton.x, x_event.xbutton.y);
-                  if (!(h_pressed == NULL))
+                  h_pressed = h_button[i_index - 1];
+                  if (i_processor_key(h_processor, h_pressed->index, True))
                   {
                      h_pressed->state = True;
-                     i_button_draw(x_display, x_application_window, i_screen, h_pressed);
-                     h_processor->code = h_pressed->index;
-                     h_processor->keypressed = True;
-#if !defined(SWITCHES)
-                     h_processor->enabled = True; /* Any key press wil wake up the processor */
-                     h_processor->sleep = False;
-#endif
-                     break;
+                     i_button_redraw(x_display, x_application_window, i_screen, h_pressed);
+                  }
+                  else
+                  {
+                     XBell(x_display, 0); /* Too many keys waiting to be processed */
+                     h_pressed = NULL;
                   }
                }
 #if defined(SWITCHES)
                if (h_pressed == NULL) { /* It wasn't a button that was pressed check the switches */
-                  if (!(h_switch_pressed(h_switch[0], x_event.xbutton.x, x_event.xbutton.y) == NULL))
+                  if (i_index == FACEPLATE_SWITCH + 0)
                   {
                      h_switch[0]->state = !(h_switch[0]->state); /* Toggle switch */
-                     i_switch_draw(x_display, x_application_window, i_screen, h_switch[0]);
+                     i_switch_draw(x_display, h_faceplate->pixmap, i_screen, h_switch[0]); /* Update the faceplate */
+                     v_faceplate_expose(h_faceplate, h_switch[0]->left, h_switch[0]->top, h_switch[0]->width + 1, h_switch[0]->height + 1);
+                     i_faceplate_draw(x_display, x_application_window, i_screen, h_faceplate);
                      if (h_switch[0]->state)
                      {
                         v_processor_reset(h_processor); /* Reset the processor */
@@ -769,6 +1125,7 @@ int main(int argc, char *argv[])
                      else
                      {
                         v_save_state(h_processor); /* Save current settings */
+                        v_sync_memory(h_processor);
                         h_processor->enabled = False; /* Disable the processor */
 #if defined(HP67)
                         i_ticks = DELAY * 4; /* Set count down */
@@ -781,10 +1138,12 @@ int main(int argc, char *argv[])
 #endif
                      }
                   }
-                  if (!(h_switch_pressed(h_switch[1], x_event.xbutton.x, x_event.xbutton.y) == NULL))
+                  if (i_index == FACEPLATE_SWITCH + 1)
                   {
                      h_switch[1]->state = !(h_switch[1]->state); /* Toggle switch */
-                     i_switch_draw(x_display, x_application_window, i_screen, h_switch[1]);
+                     i_switch_draw(x_display, h_faceplate->pixmap, i_screen, h_switch[1]); /* Update the faceplate */
+                     v_faceplate_expose(h_faceplate, h_switch[1]->left, h_switch[1]->top, h_switch[1]->width + 1, h_switch[1]->height + 1);
+                     i_faceplate_draw(x_display, x_application_window, i_screen, h_faceplate);
 #if defined(HP10)
                      h_processor->print = h_switch[1]->state;
 #else
@@ -801,30 +1160,55 @@ int main(int argc, char *argv[])
                if (!(h_pressed == NULL))
                {
                   h_pressed->state = False;
-                  i_button_draw(x_display, x_application_window, i_screen, h_pressed);
-                  h_processor->keypressed = False; /* Don't clear the status bit here!! */
+                  i_button_redraw(x_display, x_application_window, i_screen, h_pressed);
+                  i_processor_key(h_processor, h_pressed->index, False);
                }
 #if defined(SWITCHES)
                if (h_pressed == NULL) /* It wasn't a button that was released so check the switches */
-                  if (!(h_switch_pressed(h_switch[0], x_event.xbutton.x, x_event.xbutton.y) == NULL))
+                  if (i_faceplate_find(h_faceplate, x_event.xbutton.x, x_event.xbutton.y) == FACEPLATE_SWITCH + 0)
                      i_ticks = -1;
 #endif
             }
             break;
          case Expose : /* Draw or redraw the window */
+            v_faceplate_expose(h_faceplate, x_event.xexpose.x, x_event.xexpose.y,
+               x_event.xexpose.width, x_event.xexpose.height); /* Add to the area to be redrawn */
+            if (x_event.xexpose.count == 0) /* Wait for the last in a series of expose events */
             {
-               int i_count;
+               i_faceplate_draw(x_display, x_application_window, i_screen, h_faceplate); /* Copy exposed area from the faceplate */
                i_display_draw(x_display, x_application_window, i_screen, h_display);/* Draw display */
-#if defined(LABELS)
-               for (i_count = 0; i_count < LABELS; i_count++) /* Draw labels */
-                  i_label_draw(x_display, x_application_window, i_screen, h_label[i_count]);
-#endif
-#if defined(SWITCHES)
-               for (i_count = 0; i_count < SWITCHES; i_count++) /* Draw switches */
-                  i_switch_draw(x_display, x_application_window, i_screen, h_switch[i_count]);
-#endif
-               for (i_count = 0; i_count < BUTTONS; i_count++) /* Draw buttons */
-                  i_button_draw(x_display, x_application_window, i_screen, h_button[i_count]);
+               if ((h_pressed != NULL) && (h_pressed->state))
+                  i_button_redraw(x_display, x_application_window, i_screen, h_pressed); /* Draw the button that is being held down */
+               if (!b_started) /* First time the window has been drawn */
+               {
+                  b_started = True;
+                  if (b_verbose)
+                  {
+                     v_render_sync(x_display);
+                     v_phase(b_verbose, "frame", &l_phase);
+                     l_phase = l_start;
+                     v_phase(b_verbose, "total", &l_phase);
+                  }
+               }
+            }
+            break;
+         case MapNotify :
+         case UnmapNotify :
+         case VisibilityNotify :
+            if (x_event.xany.window == x_application_window)
+            {
+               if (x_event.type == VisibilityNotify)
+                  b_obscured = (x_event.xvisibility.state == VisibilityFullyObscured);
+               else
+                  b_mapped = (x_event.type == MapNotify);
+               if (b_mapped && !b_obscured) l_frame = l_time(); /* Bring the display up to date straight away when it can be seen again */
+            }
+            break;
+         case ConfigureNotify : /* Window may have been resized */
+            if (x_event.xconfigure.window == x_application_window)
+            {
+               i_resize_width = x_event.xconfigure.width;
+               i_resize_height = x_event.xconfigure.height;
             }
             break;
          case ClientMessage : /* Message from window manager */
@@ -832,13 +1216,95 @@ int main(int argc, char *argv[])
             break;
          }
       }
+      if ((i_resize_width != i_window_width) || (i_resize_height != i_window_height)) /* Only handle the last of a series of resize events */
+      {
+         i_window_width = i_resize_width;
+         i_window_height = i_resize_height;
+         f_resize = f_scale * (double) i_window_width / (unsigned) (WIDTH);
+         if (f_resize > f_scale * (double) i_window_height / (unsigned) (HEIGHT)) f_resize = f_scale * (double) i_window_height / (unsigned) (HEIGHT); /* Fit the height */
+         if ((f_resize - f_scale > 0.01) || (f_scale - f_resize > 0.01)) /* Rebuild the layout if the scale has changed */
+         {
+            int i_count;
+#if defined(SWITCHES)
+            int i_switches = 0;
+#endif
+            f_scale = f_resize;
+            if (h_pressed != NULL) i_processor_key(h_processor, h_pressed->index, False); /* Release any button being held down */
+            h_pressed = NULL;
+            for (i_count = 0; i_count < BUTTONS; i_count++)
+               v_button_free(x_display, h_button[i_count]);
+#if defined(SWITCHES)
+            for (i_count = 0; i_count < SWITCHES; i_count++)
+               if ((h_switch[i_count] != NULL) && (h_switch[i_count]->state)) i_switches |= 1 << i_count; /* Remember the switch positions */
+#endif
+            v_faceplate_free(x_display, h_faceplate);
+            v_arena_rewind(h_layout); /* Release the buttons, switches, labels and display */
+            v_segment_flush(x_display);
+            XFreeFont(x_display, h_normal_font);
+            XFreeFont(x_display, h_small_font);
+            XFreeFont(x_display, h_alternate_font);
+            XFreeFont(x_display, h_large_font);
+            v_render_flush_fonts(x_display); /* Font ids may be reused */
+
+            if (b_shm) /* Frame buffer must be the same size as the window */
+            {
+               v_render_close(x_display);
+               i_render_framebuffer(x_display, x_application_window, i_screen, i_window_width, i_window_height);
+            }
+
+            h_normal_font = h_load_font(x_display, NORMAL_TEXT);
+            h_small_font = h_load_font(x_display, SMALL_TEXT);
+            h_alternate_font = h_load_font(x_display, ALTERNATE_TEXT);
+            h_large_font = h_load_font(x_display, LARGE_TEXT);
+            v_init_buttons(h_button);
+#if defined(SWITCHES)
+            v_init_switches(h_switch);
+            for (i_count = 0; i_count < SWITCHES; i_count++)
+               if (h_switch[i_count] != NULL) h_switch[i_count]->state = (i_switches >> i_count) & 1;
+#endif
+#if defined(LABELS)
+            v_init_labels(h_label);
+#endif
+            h_display = h_display_create(0, BEZEL_LEFT, BEZEL_TOP, BEZEL_WIDTH, BEZEL_HEIGHT,
+               DISPLAY_LEFT, DISPLAY_TOP, DISPLAY_WIDTH, DISPLAY_HEIGHT, DIGIT_COLOUR, DIGIT_BACKGROUND,
+               DISPLAY_BACKGROUND, BEZEL_COLOUR);
+
+            h_faceplate = h_faceplate_create(x_display, x_application_window, i_screen,
+               i_window_width, i_window_height, i_background_colour);
+#if defined(LABELS)
+            for (i_count = 0; i_count < LABELS; i_count++)
+               i_label_draw(x_display, h_faceplate->pixmap, i_screen, h_label[i_count]);
+#endif
+#if defined(SWITCHES)
+            for (i_count = 0; i_count < SWITCHES; i_count++)
+            {
+               i_switch_draw(x_display, h_faceplate->pixmap, i_screen, h_switch[i_count]);
+               if (h_switch[i_count] != NULL) v_faceplate_map(h_faceplate, h_switch[i_count]->left, h_switch[i_count]->top,
+                  h_switch[i_count]->width, h_switch[i_count]->height, FACEPLATE_SWITCH + i_count);
+            }
+#endif
+            for (i_count = 0; i_count < BUTTONS; i_count++)
+               i_button_draw(x_display, h_faceplate->pixmap, i_screen, h_button[i_count]);
+            v_map_buttons(h_button, h_key, h_faceplate);
+
+            v_faceplate_expose(h_faceplate, 0, 0, i_window_width, i_window_height); /* Redraw everything */
+            i_faceplate_draw(x_display, x_application_window, i_screen, h_faceplate);
+            i_display_update(x_display, x_application_window, i_screen, h_display, h_processor);
+            i_display_draw(x_display, x_application_window, i_screen, h_display);
+         }
+      }
+      v_render_sync(x_display); /* Send any changes to the X server */
    }
 
    v_save_state(h_processor); /* Save state */
+   v_sync_memory(h_processor);
+   v_autosave_stop(); /* Wait for the data file to be written */
 
    /** XFreeCursor (x_display, x_cursor); /* Free cursor */
+   v_render_close(x_display); /* Release the frame buffer */
    XDestroyWindow(x_display, x_application_window); /* Close connection to server */
    XCloseDisplay(x_display);
+   v_arena_free(h_arena);
 
    exit(0);
 }
@@ -55,19 +55,27 @@
  * 11 Dec 22         - Renamed models with continious memory and added HP25
  *                     HP33e, and HP38e - MT
  * 24 Dec 22         - Modified scale width for HP10 - MT
+ * 17 Oct 26         - The  scale  is  now  set  at run time, the  model
+ *                     specific  values just define the aspect ratio  of
+ *                     the user interface - MT
  *
  * TO DO :           -
  */
 #define COMMIT_ID "[Commit ID: 8d939c0]"
 
 #if defined(HP35) || defined(HP80) || defined(HP45) || defined(HP70) || defined(HP55) || defined(HP10) || defined(HP67)
-#define SCALE_WIDTH     1.15
-#define SCALE_HEIGHT    1
+#define ASPECT_WIDTH    1.15
+#define ASPECT_HEIGHT   1
 #else
-#define SCALE_WIDTH     1
-#define SCALE_HEIGHT    1
+#define ASPECT_WIDTH    1
+#define ASPECT_HEIGHT   1
 #endif
 
+#define SCALE_WIDTH     (f_scale * ASPECT_WIDTH)
+#define SCALE_HEIGHT    (f_scale * ASPECT_HEIGHT)
+
+double f_scale; /* User interface scale (set at run time) */
+
 /** #define __TIME__     "00:00:00" /* Release only */
 
 #if defined(vms)
@@ -22,6 +22,10 @@
  * 19 Sep 21         - Initial version (Cheese House)- MT
  * 03 Jan 21         - Changed debug() macro so that debug code is executed
  *                     when DEBUG is defined (doesn't need to be true) - MT
+ * 17 Oct 26         - Caches  the  translation of each key code  for  each
+ *                     combination of modifier keys that affect it, so each
+ *                     key code only needs to be translated once (until the
+ *                     keyboard mapping is changed) - MT
  *
  */
 
@@ -43,7 +47,7 @@
 #include "gcc-debug.h"
 
 /* Attempts to translate a key code into a character. */
-static void v_key_decode(okeyboard *h_keyboard, Display *x_display, int i_keycode, int i_keystate) {
+static void v_key_translate(okeyboard *h_keyboard, Display *x_display, int i_keycode, int i_keystate) {
    h_keyboard->keysym = XKeycodeToKeysym(x_display, i_keycode, 0);
    h_keyboard->key = '\000';
    switch (h_keyboard->keysym) {
@@ -146,6 +150,32 @@ static void v_key_decode(okeyboard *h_keyboard, Display *x_display, int i_keycod
    }
 }
 
+/*
+ * key_decode (keyboard, display, keycode, keystate)
+ *
+ * Looks  up the character for a key code in the cache, only translating it
+ * if this combination of key code and modifier keys hasn't been seen.
+ *
+ */
+static void v_key_decode(okeyboard *h_keyboard, Display *x_display, int i_keycode, int i_keystate) {
+   int i_state;
+
+   if ((i_keycode < 0) || (i_keycode >= KEY_CODES)) { /* Can't be cached */
+      v_key_translate(h_keyboard, x_display, i_keycode, i_keystate);
+      return;
+   }
+   i_state = ((i_keystate & ShiftMask) ? 1 : 0) | ((i_keystate & LockMask) ? 2 : 0) | /* Only these modifiers are used */
+      ((i_keystate & ControlMask) ? 4 : 0) | ((i_keystate & Mod2Mask) ? 8 : 0);
+   if (!h_keyboard->cached[i_keycode][i_state]) {
+      v_key_translate(h_keyboard, x_display, i_keycode, i_keystate);
+      h_keyboard->cache_key[i_keycode][i_state] = h_keyboard->key;
+      h_keyboard->cache_keysym[i_keycode][i_state] = h_keyboard->keysym;
+      h_keyboard->cached[i_keycode][i_state] = True;
+   }
+   h_keyboard->key = h_keyboard->cache_key[i_keycode][i_state];
+   h_keyboard->keysym = h_keyboard->cache_keysym[i_keycode][i_state];
+}
+
 /* Update the keyboard state */
 
 okeyboard *h_key_pressed(okeyboard *h_keyboard, Display *x_display, int i_keycode, int i_keystate) {
@@ -180,8 +210,20 @@ okeyboard *h_keyboard_create(Display* x_display) {
       h_keyboard->display = x_display;
       h_keyboard->key = '\000';
       h_keyboard->keysym = 0x0000;
+      v_keyboard_flush(h_keyboard);
    }
    else
       h_keyboard = NULL;
    return(h_keyboard);
 }
+
+/*
+ * keyboard_flush (keyboard)
+ *
+ * Empties the cache (needs to be called if the keyboard mapping changes).
+ *
+ */
+
+void v_keyboard_flush(okeyboard *h_keyboard) {
+   memset(h_keyboard->cached, False, sizeof(h_keyboard->cached));
+}
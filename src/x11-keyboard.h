@@ -20,13 +20,20 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  *
  * 19 Sep 13         - Initial version - MT
+ * 17 Oct 26         - Added a cache of translated key codes - MT
  *
  */
 
+#define KEY_CODES      256
+#define KEY_STATES     16              /* Combinations of shift, lock, control and num lock */
+
 typedef struct { /* Calculator button structure. */
    Display* display;
    char key;
    int keysym;
+   char cached[KEY_CODES][KEY_STATES]; /* Set once a key code has been translated */
+   char cache_key[KEY_CODES][KEY_STATES]; /* Translated key */
+   int cache_keysym[KEY_CODES][KEY_STATES];
 } okeyboard;
 
 okeyboard *h_key_pressed(okeyboard *h_keyboard, Display *x_display, int i_keycode, int i_keystate);
@@ -34,3 +41,5 @@ okeyboard *h_key_pressed(okeyboard *h_keyboard, Display *x_display, int i_keycod
 okeyboard *h_key_released(okeyboard *h_keyboard, Display *x_display, int i_keycode, int i_keystate);
 
 okeyboard *h_keyboard_create(Display* x_display);
+
+void v_keyboard_flush(okeyboard *h_keyboard);